@@ -8,80 +8,152 @@ A logging console.
 
 #include "console.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include "filesystem.h"
 #include "ost_common.h"
+#include "trace.h"
+
+namespace {
+
+std::atomic<uint32_t> g_NextProducer(1);
+
+/////////////////////////////////////////////////
+// A small id unique to the calling thread, for stitching split messages back together
+uint32_t ProducerID() {
+    thread_local uint32_t producer = g_NextProducer.fetch_add(1, std::memory_order_relaxed);
+    return producer;
+}
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::Console::Console() noexcept :
+    m_DroppedCount(0), m_ReportedDrops(0), m_FlushPolicy{ false, 250, true }, m_PerFrame(false), m_OnError(true),
+    m_WakeRequested(false), m_Stop(false), m_isDraining(false), m_Passes(0) {
+    this->setLogLevel(ostrich::log::g_LogDefaultLevel);
+}
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 void ostrich::Console::Initialize() {
-    if (!m_DebugMessageLog.Open(u8"debug.log", ostrich::FileMode::OPEN_WRITETRUNCATE)) {
-        m_MessageLog.push_back(u8"Unable to open debug.log");
+    this->Destroy();
+
+    m_DroppedCount.store(0, std::memory_order_relaxed);
+    m_ReportedDrops = 0;
+    m_WakeRequested = false;
+    m_Stop = false;
+    m_isDraining = false;
+    m_Passes = 0;
+
+    // anything written before Initialize() is still in the ring and goes into the new logs
+    m_Partial.clear();
+
+    bool consoleopen = m_MessageLog.Open(u8"console.log", ostrich::FileMode::OPEN_WRITETRUNCATE);
+    bool debugopen = m_DebugMessageLog.Open(u8"debug.log", ostrich::FileMode::OPEN_WRITETRUNCATE);
+
+    m_Writer = std::thread(&Console::WriterThread, this);
+
+    if (!consoleopen) {
+        this->WriteMessage(u8"Unable to open console.log");
+    }
+    if (!debugopen) {
+        this->WriteMessage(u8"Unable to open debug.log");
     }
 }
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 void ostrich::Console::Destroy() {
-    this->WriteLogToFile();
-    m_MessageLog.clear();
+    if (!m_Writer.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_Signal.notify_all();
+    m_Writer.join();
+
+    // pick up anything written while the writer was on its way out
+    this->Drain();
+    m_Partial.clear();
+    m_MessageLog.Close();
     m_DebugMessageLog.Close();
 }
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-void ostrich::Console::WriteMessage(const std::string &msg) {
-    if (!msg.empty()) {
-        m_MessageLog.push_back(msg);
-        this->TrimLog();
+void ostrich::Console::setFlushPolicy(const FlushPolicy &policy) {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_FlushPolicy = policy;
+        m_PerFrame.store(policy.m_PerFrame, std::memory_order_relaxed);
+        m_OnError.store(policy.m_OnError, std::memory_order_relaxed);
+    }
+    m_Signal.notify_all(); // so a new interval takes effect now rather than after the old one runs out
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::Console::LogMessage(ostrich::LogLevel level, std::string_view msg) {
+    switch (level) {
+        case ostrich::LogLevel::LOG_TRACE:
+        case ostrich::LogLevel::LOG_DEBUG:
+            this->DebugMessage(msg);
+            break;
+        case ostrich::LogLevel::LOG_INFO:
+        case ostrich::LogLevel::LOG_WARNING:
+            this->WriteMessage(msg);
+            break;
+        case ostrich::LogLevel::LOG_ERROR:
+            this->ErrorMessage(msg);
+            break;
+        case ostrich::LogLevel::LOG_NONE:
+        default:
+            break;
     }
 }
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-void ostrich::Console::WriteMessage(std::string_view msg) {
-    if (!msg.empty()) {
-        m_MessageLog.emplace_back(msg);
-        this->TrimLog();
+void ostrich::Console::setLogLevel(ostrich::LogCategory category, ostrich::LogLevel level) noexcept {
+    std::size_t index = static_cast<std::size_t>(category);
+    if (index < ostrich::log::g_NumCategories) {
+        m_LogLevels[index].store(static_cast<int32_t>(level), std::memory_order_relaxed);
     }
 }
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-void ostrich::Console::DebugMessage(const std::string &msg) {
-    if (!msg.empty() && m_DebugMessageLog.isOpen()) {
-        std::fstream &handle = m_DebugMessageLog.getFStream();
-        handle.write(msg.c_str(), msg.length());
-        handle.put(ost_char::g_NewLine);
-        handle.flush();
+void ostrich::Console::setLogLevel(ostrich::LogLevel level) noexcept {
+    for (auto &categorylevel : m_LogLevels) {
+        categorylevel.store(static_cast<int32_t>(level), std::memory_order_relaxed);
     }
 }
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-void ostrich::Console::DebugMessage(std::string_view msg) {
-    if (!msg.empty() && m_DebugMessageLog.isOpen()) {
-        std::fstream &handle = m_DebugMessageLog.getFStream();
-        handle.write(msg.data(), msg.length());
-        handle.put(ost_char::g_NewLine);
-        handle.flush();
+void ostrich::Console::Flush() {
+    if (m_PerFrame.load(std::memory_order_relaxed)) {
+        this->Wake();
     }
 }
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 void ostrich::Console::WriteLogToFile() {
-    if (m_MessageLog.size() > 0) {
-        ostrich::File logfile;
-        if (!logfile.Open(u8"console.log", ostrich::FileMode::OPEN_WRITETRUNCATE)) {
-            return;
-        }
+    if (!m_Writer.joinable())
+        return;
 
-        std::fstream &handle = logfile.getFStream();
-        for (auto itr = m_MessageLog.begin(); itr != m_MessageLog.end(); std::advance(itr, 1)) {
-            handle.write((*itr).c_str(), (*itr).length());
-            handle.put(ost_char::g_NewLine);
-        }
-    }
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    // a drain already in progress may have missed messages written just before this call
+    uint64_t target = m_Passes + (m_isDraining ? 2 : 1);
+    m_WakeRequested = true;
+    m_Signal.notify_all();
+    m_Signal.wait(lock, [this, target]() { return ((m_Passes >= target) || m_Stop); });
 }
 
 /////////////////////////////////////////////////
@@ -92,58 +164,137 @@ ostrich::ConsolePrinter ostrich::Console::CreatePrinter() noexcept {
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-void ostrich::Console::TrimLog() {
-    const uint32_t maxlogsize = INT32_MAX;
-    if (m_MessageLog.size() >= maxlogsize)
-        m_MessageLog.pop_front();
+void ostrich::Console::Push(uint8_t channel, std::string_view msg, bool error) {
+    if (msg.empty())
+        return;
+
+    Slot slot;
+    slot.m_Producer = ProducerID();
+    slot.m_Channel = channel;
+    slot.m_Flags = FLAG_FIRST;
+
+    while (!msg.empty()) {
+        std::size_t length = std::min(msg.length(), Slot::TEXT_LENGTH);
+        std::memcpy(slot.m_Text, msg.data(), length);
+        slot.m_Length = static_cast<uint16_t>(length);
+        msg.remove_prefix(length);
+        if (!msg.empty()) {
+            slot.m_Flags |= FLAG_CONTINUED;
+        }
+        else {
+            slot.m_Flags &= ~FLAG_CONTINUED;
+        }
+
+        if (!m_Ring.TryPush(slot)) {
+            // the writer flushes whatever pieces made it in when this thread's next message starts
+            m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        slot.m_Flags &= ~FLAG_FIRST;
+    }
+
+    if (error && m_OnError.load(std::memory_order_relaxed)) {
+        this->Wake();
+    }
 }
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-void ostrich::ConsolePrinter::WriteMessage(std::string_view msg, std::initializer_list<std::string> args) {
-    if (m_Parent) {
-        std::string buffer;
-        this->CompileBuffer(buffer, msg, args);
-        this->WriteMessage(buffer);
+void ostrich::Console::Wake() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_WakeRequested = true;
     }
+    m_Signal.notify_all();
 }
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-void ostrich::ConsolePrinter::DebugMessage(std::string_view msg, std::initializer_list<std::string> args) {
-    if (m_Parent) {
-        std::string buffer;
-        this->CompileBuffer(buffer, msg, args);
-        this->DebugMessage(buffer);
+void ostrich::Console::WriterThread() {
+    OST_TRACE_THREAD("Console writer");
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for (;;) {
+        auto woken = [this]() { return (m_WakeRequested || m_Stop); };
+        if (m_FlushPolicy.m_IntervalMS > 0) {
+            m_Signal.wait_for(lock, std::chrono::milliseconds(m_FlushPolicy.m_IntervalMS), woken);
+        }
+        else {
+            m_Signal.wait(lock, woken);
+        }
+
+        bool stop = m_Stop;
+        m_WakeRequested = false;
+        m_isDraining = true;
+        lock.unlock();
+
+        this->Drain();
+
+        lock.lock();
+        m_isDraining = false;
+        m_Passes++;
+        m_Signal.notify_all();
+
+        if (stop) {
+            break;
+        }
     }
 }
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-void ostrich::ConsolePrinter::CompileBuffer(std::string &target, std::string_view msg, std::initializer_list<std::string> args) {
-    std::string buffer;
-    auto listitr = args.begin();
-    auto msgitr = msg.begin();
-    while (msgitr != msg.end()) {
-        if ((*msgitr) == '%') {
-            if (std::next(msgitr) != msg.end() && ((*std::next(msgitr)) == '%')) {
-                buffer.push_back('%');
-                std::advance(msgitr, 1);
+void ostrich::Console::Drain() {
+    OST_TRACE_SCOPE("Console::Drain");
+
+    auto write = [this](uint8_t channel, std::string_view text) {
+        ostrich::File &file = (channel == CHANNEL_DEBUG) ? m_DebugMessageLog : m_MessageLog;
+        if (file.isOpen()) {
+            std::fstream &handle = file.getFStream();
+            handle.write(text.data(), text.length());
+            handle.put(ost_char::g_NewLine);
+        }
+    };
+
+    bool wrote = false;
+    for (auto slot = m_Ring.TryPop(); slot.has_value(); slot = m_Ring.TryPop()) {
+        std::string_view text(slot->m_Text, slot->m_Length);
+        auto partial = m_Partial.find(slot->m_Producer);
+
+        if (slot->m_Flags & FLAG_FIRST) {
+            if (partial != m_Partial.end()) {
+                // the rest of the last message from this thread was dropped; keep what made it
+                write(slot->m_Channel, partial->second);
+                m_Partial.erase(partial);
+                partial = m_Partial.end();
             }
-            else if (listitr == args.end()) { // if more % than args, append %
-                buffer.push_back('%');
+            if (slot->m_Flags & FLAG_CONTINUED) {
+                m_Partial.emplace(slot->m_Producer, text);
             }
             else {
-                buffer += *listitr;
-                std::advance(listitr, 1);
+                write(slot->m_Channel, text);
             }
         }
-        else {
-            buffer.push_back((*msgitr));
+        else if (partial != m_Partial.end()) {
+            partial->second.append(text);
+            if (!(slot->m_Flags & FLAG_CONTINUED)) {
+                write(slot->m_Channel, partial->second);
+                m_Partial.erase(partial);
+            }
         }
-        if (msgitr != msg.end())
-            std::advance(msgitr, 1);
+        wrote = true;
     }
 
-    target.assign(buffer);
+    uint64_t dropped = m_DroppedCount.load(std::memory_order_relaxed);
+    if (dropped != m_ReportedDrops) {
+        write(CHANNEL_CONSOLE, u8"Console ring full; dropped " + std::to_string(dropped - m_ReportedDrops) + u8" messages");
+        m_ReportedDrops = dropped;
+        wrote = true;
+    }
+
+    if (wrote) {
+        if (m_MessageLog.isOpen())
+            m_MessageLog.getFStream().flush();
+        if (m_DebugMessageLog.isOpen())
+            m_DebugMessageLog.getFStream().flush();
+    }
 }
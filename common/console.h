@@ -5,6 +5,7 @@ Copyright (c) 2020 Ostrich Labs
 A logging console
 
 Strings are expected to be UTF-8 encoded
+Writing a message only copies it into a fixed-size ring; a background thread does the file I/O
 
 Future versions for different projects may also allow simple scripting
 ==========================================
@@ -13,10 +14,18 @@ Future versions for different projects may also allow simple scripting
 #ifndef OSTRICH_CONSOLE_H_
 #define OSTRICH_CONSOLE_H_
 
-#include <list>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
 #include "filesystem.h"
+#include "format.h"
+#include "log.h"
+#include "ringbuffer.h"
 #include "utility.h"
 
 namespace ostrich {
@@ -26,17 +35,33 @@ namespace ostrich {
 class ConsolePrinter;
 
 /////////////////////////////////////////////////
-// For now, a simple logger type
-// Currently uses console.log and debug.log hardcoded file names
+// A logger writing console.log and debug.log from a background thread
+// Messages are copied into a fixed ring of preallocated slots, so writing one never allocates, waits on file I/O,
+// or grows memory; if the ring is full the message is dropped and counted.
+// Long messages are split across slots and stitched back together by the writer.
+// Any thread may write messages
 class Console {
 public:
 
     /////////////////////////////////////////////////
-    // Constructor is effectively default; all data has default constructors
-    // Destructor can do nothing because all data is self-destructible (no allocation within class itself)
-    // Copy/move constructors/operators are deleted for performance reasons
-    Console() noexcept {}
-    virtual ~Console() {}
+    // Number of slots in the ring, and the size of each
+    static constexpr std::size_t SLOT_COUNT = 2048;
+    static constexpr std::size_t SLOT_SIZE = 256;
+
+    /////////////////////////////////////////////////
+    // When the writer thread wakes up to write what's in the ring
+    struct FlushPolicy {
+        bool m_PerFrame;        // Flush() wakes the writer; Main calls it once per frame
+        int32_t m_IntervalMS;   // the writer wakes on its own this often; 0 to only wake when asked
+        bool m_OnError;         // ErrorMessage() wakes the writer right away
+    };
+
+    /////////////////////////////////////////////////
+    // Constructor sets the default flush policy (every 250 ms and on error); use Initialize() to start logging
+    // Destructor stops the writer, writing anything still in the ring
+    // Copy/move constructors/operators are deleted; the writer thread holds a pointer to this
+    Console() noexcept;
+    virtual ~Console() { this->Destroy(); }
     Console(Console &&) = delete;
     Console(const Console &) = delete;
     Console &operator=(Console &&) = delete;
@@ -52,12 +77,22 @@ public:
 
     /////////////////////////////////////////////////
     // Clean up the object
-    // The message log is written to a file and the debug log is closed
+    // Everything still in the ring is written, then the writer stops and the logs are closed
     //
     // returns:
     //      void
     void Destroy();
 
+    /////////////////////////////////////////////////
+    // Change when the writer thread wakes up
+    // Takes effect the next time the writer wakes
+    //
+    // in:
+    //      policy - the new policy
+    // returns:
+    //      void
+    void setFlushPolicy(const FlushPolicy &policy);
+
     /////////////////////////////////////////////////
     // Write (copy) a message to the main message log
     // This version takes a const reference to a C++ string
@@ -68,7 +103,7 @@ public:
     //      msg - The UTF-8 formatted string to write to the message log
     // returns:
     //      void
-    void WriteMessage(const std::string &msg);
+    void WriteMessage(const std::string &msg) { this->WriteMessage(std::string_view(msg)); }
 
     /////////////////////////////////////////////////
     // Write (copy) a message to the main message log
@@ -80,7 +115,7 @@ public:
     //      msg - The UTF-8 formatted string to write to the message log
     // returns:
     //      void
-    void WriteMessage(std::string_view msg);
+    void WriteMessage(std::string_view msg) { this->Push(CHANNEL_CONSOLE, msg, false); }
 
     /////////////////////////////////////////////////
     // Write (copy) a message to the main message log
@@ -94,40 +129,43 @@ public:
     //      void
     void WriteMessage(const char *msg) { this->WriteMessage(std::string_view(msg)); }
 
+    /////////////////////////////////////////////////
+    // Write (copy) a message to the main message log and, depending on the flush policy, get it to disk right away
+    //
+    // in:
+    //      msg - The UTF-8 formatted string to write to the message log
+    // returns:
+    //      void
+    void ErrorMessage(std::string_view msg) { this->Push(CHANNEL_CONSOLE, msg, true); }
+
     /////////////////////////////////////////////////
     // Write a message to the debug log file
     // This version takes a const reference to a C++ string
     //
-    // The debug log is an open file, so messages are written as they come in rather than all at once at the end
-    //
     // Simple strings get passed straight to the internal Console
     //
     // in:
     //      msg - The UTF-8 formatted string to write to the debug log
     // returns:
     //      void
-    void DebugMessage(const std::string &msg);
+    void DebugMessage(const std::string &msg) { this->DebugMessage(std::string_view(msg)); }
 
     /////////////////////////////////////////////////
     // Write a message to the debug log file
     // This version takes a string_view
     //
-    // The debug log is an open file, so messages are written as they come in rather than all at once at the end
-    //
     // Simple strings get passed straight to the internal Console
     //
     // in:
     //      msg - The UTF-8 formatted string to write to the debug log
     // returns:
     //      void
-    void DebugMessage(std::string_view msg);
+    void DebugMessage(std::string_view msg) { this->Push(CHANNEL_DEBUG, msg, false); }
 
     /////////////////////////////////////////////////
     // Write a message to the debug log file
     // This version takes a string literal or C-style string
     //
-    // The debug log is an open file, so messages are written as they come in rather than all at once at the end
-    //
     // Simple strings get passed straight to the internal Console
     //
     // in:
@@ -136,14 +174,75 @@ public:
     //      void
     void DebugMessage(const char *msg) { this->DebugMessage(std::string_view(msg)); }
 
+    /////////////////////////////////////////////////
+    // Write a message at a log level; see log.h
+    // TRACE/DEBUG go to the debug log, INFO/WARNING to the message log, ERROR goes through ErrorMessage()
+    // Doesn't check the level filters; callers use the OST_LOG_* macros, which do
+    //
+    // in:
+    //      level - the message's severity
+    //      msg - The UTF-8 formatted string to write
+    // returns:
+    //      void
+    void LogMessage(LogLevel level, std::string_view msg);
+
+    /////////////////////////////////////////////////
+    // Set the lowest level written for a category
+    // Safe to call from any thread
+    //
+    // in:
+    //      category - the category to change
+    //      level - the lowest level to write; LOG_NONE silences the category
+    // returns:
+    //      void
+    void setLogLevel(LogCategory category, LogLevel level) noexcept;
+
+    /////////////////////////////////////////////////
+    // Set the lowest level written for every category
+    //
+    // in:
+    //      level - the lowest level to write; LOG_NONE silences everything
+    // returns:
+    //      void
+    void setLogLevel(LogLevel level) noexcept;
+
+    /////////////////////////////////////////////////
+    // Check whether a message would get past the run-time filter
+    //
+    // in:
+    //      level - the message's severity
+    //      category - the message's category
+    // returns:
+    //      true if the message should be written
+    bool isLogEnabled(LogLevel level, LogCategory category) const noexcept {
+        std::size_t index = static_cast<std::size_t>(category);
+        return ((index < log::g_NumCategories) &&
+                (static_cast<int32_t>(level) >= m_LogLevels[index].load(std::memory_order_relaxed)));
+    }
+
+    /////////////////////////////////////////////////
+    // Frame boundary: wake the writer if the flush policy asks for per-frame writes
+    // Never waits on file I/O
+    //
+    // returns:
+    //      void
+    void Flush();
+
     /////////////////////////////////////////////////
     // Force the console to write its contents to a file
-    // Does not clear the message log afterwards
+    // Waits until everything written before the call is on disk
     //
     // returns:
     //      void
     void WriteLogToFile();
 
+    /////////////////////////////////////////////////
+    // Get the number of messages dropped because the ring was full
+    //
+    // returns:
+    //      The number of dropped messages since Initialize()
+    uint64_t getDroppedCount() const noexcept { return m_DroppedCount.load(std::memory_order_relaxed); }
+
     /////////////////////////////////////////////////
     // Create a ConsolePrinter object using this
     //
@@ -154,20 +253,83 @@ public:
 private:
 
     /////////////////////////////////////////////////
-    // Trims entries off the end of the message log to enforce log size limits
-    // Currently uses a hardcoded limit of INT32_MAX; future versions might allow smaller limits
+    // slot channels and flags
+    static constexpr uint8_t CHANNEL_CONSOLE = 0;   // console.log
+    static constexpr uint8_t CHANNEL_DEBUG = 1;     // debug.log
+    static constexpr uint8_t FLAG_FIRST = 0x01;     // first piece of a message
+    static constexpr uint8_t FLAG_CONTINUED = 0x02; // more pieces of this message follow
+
+    /////////////////////////////////////////////////
+    // One preallocated piece of a message
+    // m_Producer identifies the writing thread, so pieces from different threads can't get mixed up
+    struct Slot {
+        static constexpr std::size_t TEXT_LENGTH = SLOT_SIZE - 8;
+
+        uint32_t m_Producer;
+        uint16_t m_Length;
+        uint8_t m_Channel;
+        uint8_t m_Flags;
+        char m_Text[TEXT_LENGTH];
+    };
+    static_assert(sizeof(Slot) == SLOT_SIZE, "Console slot layout changed");
+
+    /////////////////////////////////////////////////
+    // Copy a message into the ring, splitting it across slots if needed
+    //
+    // in:
+    //      channel - CHANNEL_CONSOLE or CHANNEL_DEBUG
+    //      msg - the message
+    //      error - true to wake the writer if the flush policy says so
+    // returns:
+    //      void
+    void Push(uint8_t channel, std::string_view msg, bool error);
+
+    /////////////////////////////////////////////////
+    // Ask the writer thread to wake up
     //
     // returns:
     //      void
-    void TrimLog();
+    void Wake();
 
-    std::list<std::string> m_MessageLog;
+    /////////////////////////////////////////////////
+    // Writer thread body: drain the ring whenever woken (or the interval passes) until told to stop
+    //
+    // returns:
+    //      void
+    void WriterThread();
+
+    /////////////////////////////////////////////////
+    // Write everything currently in the ring to the log files
+    // Only the writer thread may call this
+    //
+    // returns:
+    //      void
+    void Drain();
+
+    MPSCRingBuffer<Slot, SLOT_COUNT> m_Ring;
+    std::atomic<uint64_t> m_DroppedCount;
+    uint64_t m_ReportedDrops;   // writer thread only
+    std::atomic<int32_t> m_LogLevels[log::g_NumCategories];   // lowest LogLevel written, per category
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Signal;
+    FlushPolicy m_FlushPolicy;  // guarded by m_Mutex (copied into m_PerFrame/m_OnError for the lock-free paths)
+    std::atomic<bool> m_PerFrame;
+    std::atomic<bool> m_OnError;
+    bool m_WakeRequested;       // guarded by m_Mutex
+    bool m_Stop;                // guarded by m_Mutex
+    bool m_isDraining;          // guarded by m_Mutex
+    uint64_t m_Passes;          // completed drains; guarded by m_Mutex
+
+    std::thread m_Writer;
+    std::unordered_map<uint32_t, std::string> m_Partial;   // writer thread only; messages still missing pieces
+    ostrich::File m_MessageLog;         // only the writer thread touches these while it's running
     ostrich::File m_DebugMessageLog;
 };
 
 /////////////////////////////////////////////////
 // A proxy class only exposing WriteMessage() methods of a Console
-// Has some extra methods to allow printf-like insertion of variables into strings
+// Has some extra methods to allow printf-like insertion of variables into strings (see format.h)
 // C++20 has <format> that makes all of those methods unnecessary, but no compiler supports it as of Dec 2020, sooooooooooo
 class ConsolePrinter {
 public:
@@ -240,11 +402,21 @@ public:
     //      void
     void WriteMessage(const char *msg) { if (m_Parent) m_Parent->WriteMessage(msg); }
 
+    /////////////////////////////////////////////////
+    // Write (copy) an error to the main message log
+    // Depending on the Console's flush policy, it's written to disk right away
+    //
+    // in:
+    //      msg - The UTF-8 formatted string to write to the message log
+    // returns:
+    //      void
+    void ErrorMessage(std::string_view msg) { if (m_Parent) m_Parent->ErrorMessage(msg); }
+
     /////////////////////////////////////////////////
     // Write a message to the debug log file
     // This version takes a const reference to a C++ string
     //
-    // The debug log is an open file, so messages are written as they come in rather than all at once at the end
+    // The Console's writer thread gets it to disk according to its flush policy
     //
     // Simple strings get passed straight to the internal Console
     //
@@ -258,7 +430,7 @@ public:
     // Write a message to the debug log file
     // This version takes a string_view
     //
-    // The debug log is an open file, so messages are written as they come in rather than all at once at the end
+    // The Console's writer thread gets it to disk according to its flush policy
     //
     // Simple strings get passed straight to the internal Console
     //
@@ -272,7 +444,7 @@ public:
     // Write a message to the debug log file
     // This version takes a string literal or C-style string
     //
-    // The debug log is an open file, so messages are written as they come in rather than all at once at the end
+    // The Console's writer thread gets it to disk according to its flush policy
     //
     // Simple strings get passed straight to the internal Console
     //
@@ -283,113 +455,93 @@ public:
     void DebugMessage(const char *msg) { if (m_Parent) m_Parent->DebugMessage(msg); }
 
     /////////////////////////////////////////////////
-    // Write (copy) a message to the main message log
-    // This version takes a const reference to a C++ string
-    //
-    // Allows passing extra data in a {} enclosed list; all data must be strings or converted to strings at the time of the call
-    // Each % is replaced with a string from the argument list, in order (to insert a %, put %%)
-    // If the list is empty when a % is found, leave it as-is
+    // Check whether a log message would get past the Console's run-time filter
     //
     // in:
-    //      msg - The UTF-8 formatted string to write to the message log
-    //      args - A list of strings to use as arguments in the message
+    //      level - the message's severity
+    //      category - the message's category
     // returns:
-    //      void
-    void WriteMessage(std::string_view msg, std::initializer_list<std::string> args);
+    //      true if the message should be written
+    bool isLogEnabled(LogLevel level, LogCategory category) const noexcept
+    { return ((m_Parent != nullptr) && m_Parent->isLogEnabled(level, category)); }
 
     /////////////////////////////////////////////////
-    // Write (copy) a message to the main message log
-    // This version takes a string_view
-    //
-    // Allows passing extra data in a {} enclosed list; all data must be strings or converted to strings at the time of the call
-    // Each % is replaced with a string from the argument list, in order (to insert a %, put %%)
-    // If the list is empty when a % is found, leave it as-is
+    // Write a log message, if it gets past the Console's run-time filter
+    // Use the OST_LOG_* macros in log.h instead, so messages below the build's threshold compile away
     //
     // in:
-    //      msg - The UTF-8 formatted string to write to the message log
-    //      args - A list of strings to use as arguments in the message
+    //      level - the message's severity
+    //      category - the message's category
+    //      msg - The UTF-8 formatted string to write
     // returns:
     //      void
-    void WriteMessage(const std::string &msg, std::initializer_list<std::string> args) { this->WriteMessage(std::string_view(msg), args); }
+    void LogMessage(LogLevel level, LogCategory category, std::string_view msg)
+    { if (this->isLogEnabled(level, category)) m_Parent->LogMessage(level, msg); }
 
     /////////////////////////////////////////////////
-    // Write (copy) a message to the main message log
-    // This version takes a string literal or C-style string
+    // Write (copy) a formatted message to the main message log
     //
-    // Allows passing extra data in a {} enclosed list; all data must be strings or converted to strings at the time of the call
-    // Each % is replaced with a string from the argument list, in order (to insert a %, put %%)
-    // If the list is empty when a % is found, leave it as-is
+    // Each % is replaced with the next argument, in order (to insert a %, put %%); see format.h
+    // Arguments are passed as-is (numbers, chars, strings); nothing needs converting to a string first
+    // The number of %s is checked against the number of arguments at compile time
     //
     // in:
-    //      msg - The UTF-8 formatted string to write to the message log
-    //      args - A list of strings to use as arguments in the message
+    //      fmt - an OST_FORMAT() wrapped UTF-8 format string
+    //      args - one argument per %
     // returns:
     //      void
-    void WriteMessage(const char *msg, std::initializer_list<std::string> args) { this->WriteMessage(std::string_view(msg), args); }
+    template <typename Fmt, typename... Args, typename = std::enable_if_t<format::is_format_string_v<Fmt>>>
+    void WriteMessage(Fmt fmt, const Args &...args) { if (m_Parent) m_Parent->WriteMessage(format::Format(fmt, args...)); }
 
     /////////////////////////////////////////////////
-    // Write a message to the debug log file
-    // This version takes a const reference to a C++ string
-    //
-    // The debug log is an open file, so messages are written as they come in rather than all at once at the end
+    // Write a formatted message to the debug log file
+    // The Console's writer thread gets it to disk according to its flush policy
     //
-    // Allows passing extra data in a {} enclosed list; all data must be strings or converted to strings at the time of the call
-    // Each % is replaced with a string from the argument list, in order (to insert a %, put %%)
-    // If the list is empty when a % is found, leave it as-is
+    // Each % is replaced with the next argument, in order (to insert a %, put %%); see format.h
+    // Arguments are passed as-is (numbers, chars, strings); nothing needs converting to a string first
+    // The number of %s is checked against the number of arguments at compile time
     //
     // in:
-    //      msg - The UTF-8 formatted string to write to the message log
-    //      args - A list of strings to use as arguments in the message
+    //      fmt - an OST_FORMAT() wrapped UTF-8 format string
+    //      args - one argument per %
     // returns:
     //      void
-    void DebugMessage(std::string_view msg, std::initializer_list<std::string> args);
+    template <typename Fmt, typename... Args, typename = std::enable_if_t<format::is_format_string_v<Fmt>>>
+    void DebugMessage(Fmt fmt, const Args &...args) { if (m_Parent) m_Parent->DebugMessage(format::Format(fmt, args...)); }
 
     /////////////////////////////////////////////////
-    // Write a message to the debug log file
-    // This version takes a string_view
+    // Write (copy) a formatted error to the main message log
+    // Depending on the Console's flush policy, it's written to disk right away
     //
-    // The debug log is an open file, so messages are written as they come in rather than all at once at the end
-    //
-    // Allows passing extra data in a {} enclosed list; all data must be strings or converted to strings at the time of the call
-    // Each % is replaced with a string from the argument list, in order (to insert a %, put %%)
-    // If the list is empty when a % is found, leave it as-is
+    // Each % is replaced with the next argument, in order (to insert a %, put %%); see format.h
+    // Arguments are passed as-is (numbers, chars, strings); nothing needs converting to a string first
+    // The number of %s is checked against the number of arguments at compile time
     //
     // in:
-    //      msg - The UTF-8 formatted string to write to the message log
-    //      args - A list of strings to use as arguments in the message
+    //      fmt - an OST_FORMAT() wrapped UTF-8 format string
+    //      args - one argument per %
     // returns:
     //      void
-    void DebugMessage(const std::string &msg, std::initializer_list<std::string> args) { this->DebugMessage(std::string_view(msg), args); }
+    template <typename Fmt, typename... Args, typename = std::enable_if_t<format::is_format_string_v<Fmt>>>
+    void ErrorMessage(Fmt fmt, const Args &...args) { if (m_Parent) m_Parent->ErrorMessage(format::Format(fmt, args...)); }
 
     /////////////////////////////////////////////////
-    // Write a message to the debug log file
-    // This version takes a string literal or C-style string
-    //
-    // The debug log is an open file, so messages are written as they come in rather than all at once at the end
-    //
-    // Allows passing extra data in a {} enclosed list; all data must be strings or converted to strings at the time of the call
-    // Each % is replaced with a string from the argument list, in order (to insert a %, put %%)
-    // If the list is empty when a % is found, leave it as-is
+    // Write a formatted log message, if it gets past the Console's run-time filter
+    // Use the OST_LOG_* macros in log.h instead, so messages below the build's threshold compile away
     //
     // in:
-    //      msg - The UTF-8 formatted string to write to the message log
-    //      args - A list of strings to use as arguments in the message
+    //      level - the message's severity
+    //      category - the message's category
+    //      fmt - an OST_FORMAT() wrapped UTF-8 format string
+    //      args - one argument per %
     // returns:
     //      void
-    void DebugMessage(const char *msg, std::initializer_list<std::string> args) { this->DebugMessage(std::string_view(msg), args); }
+    template <typename Fmt, typename... Args, typename = std::enable_if_t<format::is_format_string_v<Fmt>>>
+    void LogMessage(LogLevel level, LogCategory category, Fmt fmt, const Args &...args)
+    { if (this->isLogEnabled(level, category)) m_Parent->LogMessage(level, format::Format(fmt, args...)); }
 
 private:
 
-    /////////////////////////////////////////////////
-    // Replace % in message with provided arguments
-    //
-    // in:
-    //      msg - original unparsed message
-    //      args - A list of strings to use as arguments in the message
-    // out:
-    //      target - a newly-constructed C++ string containing the fully parsed message
-    void CompileBuffer(std::string &target, std::string_view msg, std::initializer_list<std::string> args);
-
     Console *m_Parent;
 };
 
@@ -16,6 +16,12 @@ ostrich::timer::time_point ostrich::timer::now() {
     return ostrich::timer::clock::now();
 }
 
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int64_t ostrich::timer::ticks() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(ostrich::timer::clock::now().time_since_epoch()).count();
+}
+
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 int32_t ostrich::timer::interval(const ostrich::timer::time_point &start, const ostrich::timer::time_point &end) {
@@ -58,4 +64,35 @@ std::string ostrich::datetime::tmtostring(::tm &timedata, int milli) {
     }
 
     return buffer;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+std::string ostrich::datetime::timestamp_ms(int64_t tick) {
+    // steady and system clocks don't share an epoch, so pair one reading of each and offset from there
+    static const int64_t anchortick = ostrich::timer::ticks();
+    static const auto anchortime = std::chrono::system_clock::now();
+
+    return ostrich::datetime::timestamp_ms(anchortime + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::nanoseconds(tick - anchortick)));
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+std::string ostrich::datetime::timestamp_ms(const std::chrono::system_clock::time_point &walltime) {
+    auto sincesecond = walltime.time_since_epoch() % std::chrono::seconds(1);
+    if (sincesecond.count() < 0) {
+        sincesecond += std::chrono::seconds(1);
+    }
+
+    ::time_t seconds = std::chrono::system_clock::to_time_t(walltime - sincesecond);
+    ::tm timedata = { };
+    ostrich::datetime::localtime(&seconds, &timedata);
+
+    // adjust for display
+    timedata.tm_year += 1900;
+    timedata.tm_mon += 1;
+
+    return ostrich::datetime::tmtostring(timedata,
+        static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(sincesecond).count()));
 }
\ No newline at end of file
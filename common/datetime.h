@@ -10,6 +10,8 @@ Functions and classes for retrieving the date and time
 #define OSTRICH_DATETIME_H_
 
 #include <chrono>
+#include <cstdint>
+#include <ctime>
 #include <string>
 
 namespace ostrich {
@@ -30,6 +32,14 @@ typedef std::chrono::steady_clock::time_point   time_point;
 //      a time_point corresponding to the time of the call
 time_point now();
 
+/////////////////////////////////////////////////
+// Get the current clock reading as a raw tick count
+// Cheap enough to stamp every Message; turn it into something readable with datetime::timestamp_ms(tick)
+//
+// returns:
+//      nanoseconds since the clock's epoch (which is arbitrary for steady_clock)
+int64_t ticks();
+
 /////////////////////////////////////////////////
 // Calculates the interval between two time_points in milliseconds
 //
@@ -72,6 +82,26 @@ std::string timestamp();
 //      A C++ string with a timestamp of now(), in MM-DD-YYYY HH:MM:SS.mmm format (without .mmm if excluded)
 std::string tmtostring(::tm &timedata, int milli = -1);
 
+/////////////////////////////////////////////////
+// Format a raw tick from timer::ticks() as a wall-clock timestamp with millisecond precision
+// The tick is mapped onto the system clock through a reference point taken the first time this is called,
+// so only the formatting (not the tick) pays for the conversion
+//
+// in:
+//      tick - a value returned by timer::ticks()
+// returns:
+//      A C++ string with the tick's timestamp, in MM-DD-YYYY HH:MM:SS.mmm format.
+std::string timestamp_ms(int64_t tick);
+
+/////////////////////////////////////////////////
+// Format a system clock time point as a timestamp with millisecond precision
+//
+// in:
+//      walltime - a time point from the system clock
+// returns:
+//      A C++ string with the time point's timestamp, in MM-DD-YYYY HH:MM:SS.mmm format.
+std::string timestamp_ms(const std::chrono::system_clock::time_point &walltime);
+
 /////////////////////////////////////////////////
 // Platform-Specific Functions
 /////////////////////////////////////////////////
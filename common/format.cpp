@@ -0,0 +1,73 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "format.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::format::FormatBuffer::Append(std::string_view text) noexcept {
+    std::size_t length = text.length();
+    if (length > (CAPACITY - m_Length)) {
+        length = CAPACITY - m_Length;
+    }
+    std::memcpy(m_Data + m_Length, text.data(), length);
+    m_Length += length;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::format::AppendSigned(ostrich::format::FormatBuffer &buffer, long long value) noexcept {
+    auto result = std::to_chars(buffer.getWritePointer(), buffer.getEndPointer(), value);
+    if (result.ec == std::errc()) {
+        buffer.Commit(static_cast<std::size_t>(result.ptr - buffer.getWritePointer()));
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::format::AppendUnsigned(ostrich::format::FormatBuffer &buffer, unsigned long long value) noexcept {
+    auto result = std::to_chars(buffer.getWritePointer(), buffer.getEndPointer(), value);
+    if (result.ec == std::errc()) {
+        buffer.Commit(static_cast<std::size_t>(result.ptr - buffer.getWritePointer()));
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::format::AppendFloat(ostrich::format::FormatBuffer &buffer, double value) noexcept {
+    // %f keeps the output identical to std::to_string(); floating point to_chars isn't everywhere we build yet
+    // the buffer keeps a spare byte past the end for snprintf's null
+    std::size_t space = static_cast<std::size_t>(buffer.getEndPointer() - buffer.getWritePointer());
+    int written = std::snprintf(buffer.getWritePointer(), space + 1, u8"%f", value);
+    if (written > 0) {
+        buffer.Commit(std::min(static_cast<std::size_t>(written), space));
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::format::AppendTail(ostrich::format::FormatBuffer &buffer, std::string_view fmt) noexcept {
+    std::size_t pos = fmt.find('%');
+    while (pos != std::string_view::npos) {
+        buffer.Append(fmt.substr(0, pos + 1));
+        // a checked format string has no single % left, so this is always the second half of a %%
+        fmt.remove_prefix(((pos + 1) < fmt.length()) ? (pos + 2) : (pos + 1));
+        pos = fmt.find('%');
+    }
+    buffer.Append(fmt);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::format::FormatBuffer &ostrich::format::ThreadBuffer() noexcept {
+    thread_local FormatBuffer buffer;
+    return buffer;
+}
@@ -0,0 +1,278 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Allocation-free string formatting for the console
+
+Each % in a format string is replaced by the next argument, in order (%% is a literal %).
+Arguments are taken as-is: integers, floating point numbers, chars, and anything that converts to a string_view.
+Integers are written with std::to_chars and floating point numbers the same way std::to_string would.
+
+Format strings are wrapped in OST_FORMAT() so the number of %s can be checked against the number of
+arguments at compile time:
+    printer.WriteMessage(OST_FORMAT(u8"Loaded % textures in % ms"), count, duration);
+
+Output goes to a caller-supplied FormatBuffer or to a thread-local one; neither ever allocates.
+Output that doesn't fit is truncated.
+==========================================
+*/
+
+#ifndef OSTRICH_FORMAT_H_
+#define OSTRICH_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "ost_common.h"
+
+/////////////////////////////////////////////////
+// Wrap a string literal for use as a compile-time checked format string
+// Produces an object of a unique type whose static get() returns the literal
+#define OST_FORMAT(str) \
+    ([]() { \
+        struct OstFormatString : ostrich::format::FormatStringBase { \
+            static constexpr std::string_view get() noexcept { return std::string_view(str); } \
+        }; \
+        return OstFormatString{}; \
+    }())
+
+namespace ostrich {
+
+namespace format {
+
+/////////////////////////////////////////////////
+// Base for the types created by OST_FORMAT(); only used to recognize them
+struct FormatStringBase {};
+
+template <typename T>
+constexpr bool is_format_string_v = std::is_base_of_v<FormatStringBase, T>;
+
+/////////////////////////////////////////////////
+// Count the placeholders in a format string
+//
+// in:
+//      fmt - the format string
+// returns:
+//      the number of single %s (%% doesn't count)
+constexpr std::size_t CountPlaceholders(std::string_view fmt) noexcept {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < fmt.length(); i++) {
+        if (fmt[i] == '%') {
+            if (((i + 1) < fmt.length()) && (fmt[i + 1] == '%'))
+                i++;
+            else
+                count++;
+        }
+    }
+    return count;
+}
+
+/////////////////////////////////////////////////
+// A fixed-size output buffer
+class FormatBuffer {
+public:
+
+    /////////////////////////////////////////////////
+    // Longest output a buffer holds; anything past this is cut off
+    static constexpr std::size_t CAPACITY = 4096;
+
+    /////////////////////////////////////////////////
+    // Constructor creates an empty buffer
+    // Destructor does nothing; nothing is allocated
+    // Copy/move constructors/operators are default; it's just an array
+    FormatBuffer() noexcept : m_Length(0) { m_Data[0] = '\0'; }
+    ~FormatBuffer() { }
+    FormatBuffer(FormatBuffer &&) = default;
+    FormatBuffer(const FormatBuffer &) = default;
+    FormatBuffer &operator=(FormatBuffer &&) = default;
+    FormatBuffer &operator=(const FormatBuffer &) = default;
+
+    /////////////////////////////////////////////////
+    // Empty the buffer
+    //
+    // returns:
+    //      void
+    void Clear() noexcept { m_Length = 0; }
+
+    /////////////////////////////////////////////////
+    // Append text, truncating if it doesn't fit
+    //
+    // in:
+    //      text - the text to append
+    // returns:
+    //      void
+    void Append(std::string_view text) noexcept;
+
+    /////////////////////////////////////////////////
+    // Append one character, dropping it if the buffer is full
+    //
+    // in:
+    //      c - the character to append
+    // returns:
+    //      void
+    void Append(char c) noexcept { if (m_Length < CAPACITY) m_Data[m_Length++] = c; }
+
+    /////////////////////////////////////////////////
+    // Get the text written so far
+    //
+    // returns:
+    //      A view of the buffer's contents; valid until the buffer changes
+    std::string_view getView() const noexcept { return std::string_view(m_Data, m_Length); }
+
+    /////////////////////////////////////////////////
+    // Space for number conversions to write directly into
+    // Call Commit() afterwards with the number of characters written
+    /////////////////////////////////////////////////
+
+    char *getWritePointer() noexcept { return (m_Data + m_Length); }
+    char *getEndPointer() noexcept { return (m_Data + CAPACITY); }
+    void Commit(std::size_t count) noexcept { m_Length += count; }
+
+private:
+
+    char m_Data[CAPACITY + 1]; // + 1 so a C-style conversion always has room for its null
+    std::size_t m_Length;
+};
+
+/////////////////////////////////////////////////
+// Argument writers
+// Anything that isn't a number or char has to convert to a string_view
+/////////////////////////////////////////////////
+
+void AppendSigned(FormatBuffer &buffer, long long value) noexcept;
+void AppendUnsigned(FormatBuffer &buffer, unsigned long long value) noexcept;
+void AppendFloat(FormatBuffer &buffer, double value) noexcept;
+
+/////////////////////////////////////////////////
+// Write a single argument
+//
+// in:
+//      value - the argument
+// out:
+//      buffer - the argument's text is appended
+// returns:
+//      void
+template <typename T>
+void AppendArgument(FormatBuffer &buffer, const T &value) noexcept {
+    using Type = std::decay_t<T>;
+    if constexpr (std::is_same_v<Type, char>) {
+        buffer.Append(value);
+    }
+    else if constexpr (std::is_same_v<Type, bool>) {
+        buffer.Append(value ? '1' : '0'); // same as std::to_string()
+    }
+    else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) {
+        AppendSigned(buffer, value);
+    }
+    else if constexpr (std::is_integral_v<Type>) {
+        AppendUnsigned(buffer, value);
+    }
+    else if constexpr (std::is_floating_point_v<Type>) {
+        AppendFloat(buffer, static_cast<double>(value));
+    }
+    else if constexpr (std::is_enum_v<Type>) {
+        AppendSigned(buffer, static_cast<long long>(value));
+    }
+    else if constexpr (std::is_array_v<T>) {
+        buffer.Append(std::string_view(value)); // string literal
+    }
+    else if constexpr (std::is_same_v<Type, const char *> || std::is_same_v<Type, char *>) {
+        buffer.Append((value != nullptr) ? std::string_view(value) : std::string_view(u8"(null)"));
+    }
+    else {
+        static_assert(std::is_convertible_v<const T &, std::string_view>, "format arguments must be numbers, chars or strings");
+        buffer.Append(std::string_view(value));
+    }
+}
+
+/////////////////////////////////////////////////
+// Copy the format string up to the next placeholder, then write an argument in its place
+//
+// in:
+//      value - the argument
+// out:
+//      buffer - literal text and the argument are appended
+//      fmt - advanced past the placeholder
+// returns:
+//      void
+template <typename T>
+void AppendNext(FormatBuffer &buffer, std::string_view &fmt, const T &value) noexcept {
+    while (!fmt.empty()) {
+        std::size_t pos = fmt.find('%');
+        if (pos == std::string_view::npos) {
+            break; // can't happen with a checked format string
+        }
+        buffer.Append(fmt.substr(0, pos));
+        if (((pos + 1) < fmt.length()) && (fmt[pos + 1] == '%')) {
+            buffer.Append('%');
+            fmt.remove_prefix(pos + 2);
+            continue;
+        }
+        fmt.remove_prefix(pos + 1);
+        AppendArgument(buffer, value);
+        return;
+    }
+}
+
+/////////////////////////////////////////////////
+// Copy what's left of a format string after the last placeholder
+//
+// in:
+//      fmt - the rest of the format string
+// out:
+//      buffer - the text is appended, with %% turned into %
+// returns:
+//      void
+void AppendTail(FormatBuffer &buffer, std::string_view fmt) noexcept;
+
+/////////////////////////////////////////////////
+// Format into a caller-supplied buffer
+//
+// in:
+//      fmt - an OST_FORMAT() string
+//      args - one argument per placeholder
+// out:
+//      target - cleared, then filled with the formatted text
+// returns:
+//      A view of target's contents
+template <typename Fmt, typename... Args>
+std::string_view Format(FormatBuffer &target, Fmt fmt, const Args &...args) noexcept {
+    static_assert(is_format_string_v<Fmt>, "format strings must be wrapped in OST_FORMAT()");
+    static_assert(CountPlaceholders(Fmt::get()) == sizeof...(Args), "number of % placeholders doesn't match the number of arguments");
+    OST_UNUSED_PARAMETER(fmt);
+
+    target.Clear();
+    std::string_view rest = Fmt::get();
+    (AppendNext(target, rest, args), ...);
+    AppendTail(target, rest);
+    return target.getView();
+}
+
+/////////////////////////////////////////////////
+// Get this thread's scratch buffer
+//
+// returns:
+//      A reference to a buffer owned by the calling thread
+FormatBuffer &ThreadBuffer() noexcept;
+
+/////////////////////////////////////////////////
+// Format into this thread's scratch buffer
+// The result is only valid until the thread formats something else
+//
+// in:
+//      fmt - an OST_FORMAT() string
+//      args - one argument per placeholder
+// returns:
+//      A view of the formatted text
+template <typename Fmt, typename... Args>
+std::string_view Format(Fmt fmt, const Args &...args) noexcept {
+    return Format(ThreadBuffer(), fmt, args...);
+}
+
+} // namespace format
+
+} // namespace ostrich
+
+#endif /* OSTRICH_FORMAT_H_ */
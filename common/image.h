@@ -14,8 +14,10 @@ That might get tricksy with PNG since libpng uses a weird array-of-pointers setu
 #define OSTRICH_IMAGE_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string_view>
+#include <vector>
 
 namespace ostrich {
 
@@ -26,6 +28,7 @@ enum class ImageType : int32_t {
     IMGTYPE_PNG,
     IMGTYPE_TGA,
     IMGTYPE_DDS,
+    IMGTYPE_RAW,    // built in memory with FromPixels()
     IMGTYPE_MAX
 };
 
@@ -33,15 +36,15 @@ enum class ImageType : int32_t {
 // Expected pixel formats
 enum class PixelFormat : int32_t {
     FORMAT_NONE = 0,
-    FORMAT_RGB,     // TGA
-    FORMAT_RGBA,    // TGA
-    FORMAT_BGR,     // DDS
-    FORMAT_BGRA,    // DDS
+    FORMAT_RGB,     // DDS
+    FORMAT_RGBA,    // DDS
+    FORMAT_BGR,     // TGA, DDS
+    FORMAT_BGRA,    // TGA, DDS
 
     FORMAT_COMPRESSED_START = 100,
-    FORMAT_DXT1,
-    FORMAT_DXT3,
-    FORMAT_DXT5,
+    FORMAT_DXT1,    // DDS; 4x4 blocks of 8 bytes, 1-bit alpha
+    FORMAT_DXT3,    // DDS; 4x4 blocks of 16 bytes, explicit 4-bit alpha
+    FORMAT_DXT5,    // DDS; 4x4 blocks of 16 bytes, interpolated alpha
     FORMAT_COMPRESSED_END = 199,
 
     FORMAT_MAX
@@ -50,11 +53,22 @@ enum class PixelFormat : int32_t {
 /////////////////////////////////////////////////
 // Raw image data, including statistics
 // Data should be immutable once constructed
+// Rows are always stored top row first, whatever order the file kept them in
 // 
 // If an image load failed, the type is IMGTYPE_NONE
 class Image {
 public:
 
+    /////////////////////////////////////////////////
+    // Where one mip level sits in the image data
+    // Level 0 is the full-size image; each level after it halves both sides, down to 1x1
+    struct MipLevel {
+        int32_t m_Width;
+        int32_t m_Height;
+        int32_t m_Offset;   // bytes from the start of the data
+        int32_t m_Size;     // bytes
+    };
+
     /////////////////////////////////////////////////
     // Constructors are all private; use the static factory methods to load Images
     // Destructor can do nothing because all data is either simple or a smart pointer
@@ -67,7 +81,7 @@ public:
 
     /////////////////////////////////////////////////
     // Load DDS file into memory
-    // Currently single texture, will add texture compression and mipmaps in the future (if canary evolves that far)
+    // Uncompressed or DXT1/DXT3/DXT5, with or without a mip chain; no cubemaps or volumes
     //
     // in:
     //      filename - A name or path+name to a DDS image file
@@ -78,6 +92,7 @@ public:
     /////////////////////////////////////////////////
     // Load TGA file into memory
     // Currently single text, uncompressed, will add RLE compression in the future (if I care enough)
+    // Bottom-origin files (descriptor bit 5 clear, the TGA default) are flipped so the top row comes first
     //
     // in:
     //      filename - A name or path+name to a TGA image file
@@ -97,6 +112,66 @@ public:
     //      A constructed Image object with ImgType IMGTYPE_NONE (because unimplemented)
     static Image LoadPNG(const char *filename);
 
+    /////////////////////////////////////////////////
+    // Load an image file of any supported type, picking the loader by the file's extension (case doesn't matter)
+    //
+    // in:
+    //      filename - A name or path+name ending in .tga, .dds or .png
+    // returns:
+    //      A constructed Image object; IMGTYPE_NONE if the extension isn't one of those
+    static Image LoadFile(const char *filename);
+
+    /////////////////////////////////////////////////
+    // Wrap pixels built in memory (like an atlas page) in an Image
+    // Only uncompressed formats; rows are tightly packed, top row first
+    //
+    // in:
+    //      format - FORMAT_RGB, FORMAT_RGBA, FORMAT_BGR or FORMAT_BGRA
+    //      width, height - size in pixels
+    //      data - width * height pixels; the Image takes ownership
+    // returns:
+    //      A constructed Image object, with an empty filename; IMGTYPE_NONE if the format or size is unusable
+    static Image FromPixels(PixelFormat format, int32_t width, int32_t height, std::unique_ptr<uint8_t[]> data);
+
+    /////////////////////////////////////////////////
+    // Expand a DXT1/DXT3/DXT5 image into plain pixels, for when the GPU can't sample S3TC formats
+    // Every mip level is decoded, so the result has the same chain
+    //
+    // in:
+    //      image - A compressed image
+    // returns:
+    //      A constructed FORMAT_RGBA Image object with an empty filename; IMGTYPE_NONE if the image isn't a valid compressed one
+    static Image Decompress(const Image &image);
+
+    /////////////////////////////////////////////////
+    // Build a full mip chain by box filtering, for baking into a DDS ahead of time
+    // Each level averages 2x2 pixels of the one above; odd edges reuse their last row or column
+    //
+    // in:
+    //      image - An uncompressed image; only its first level is read
+    // returns:
+    //      A constructed Image object of the same format with every level down to 1x1 and an empty filename;
+    //      IMGTYPE_NONE if the image is compressed or invalid
+    static Image GenerateMipmaps(const Image &image);
+
+    /////////////////////////////////////////////////
+    // Write an uncompressed image to a TGA file, top row first
+    //
+    // in:
+    //      filename - A name or path+name for the TGA file
+    // returns:
+    //      true if the file was written; false if it couldn't be, or the image is compressed or invalid
+    bool SaveTGA(const char *filename) const;
+
+    /////////////////////////////////////////////////
+    // Write an image to a DDS file, every mip level included
+    //
+    // in:
+    //      filename - A name or path+name for the DDS file
+    // returns:
+    //      true if the file was written; false if it couldn't be, or the image is invalid
+    bool SaveDDS(const char *filename) const;
+
     /////////////////////////////////////////////////
     // Check if the object is valid
     // Uses image type as shorthand for a valid image, assuming the image type is immutable and properly set in every factory method
@@ -126,8 +201,68 @@ public:
     int32_t getBitsPerPixel() const noexcept { return m_Depth; }
     int32_t getDataSize() const noexcept { return m_DataSize; }
     std::weak_ptr<uint8_t[]> getData() const noexcept { return m_Data; }
+    int32_t getMipCount() const noexcept { return (m_MipLevels.empty() ? 1 : static_cast<int32_t>(m_MipLevels.size())); }
+
+    /////////////////////////////////////////////////
+    // Get the size and place of one mip level
+    // An image loaded without a chain has one level: the whole image
+    //
+    // in:
+    //      level - 0 to getMipCount() - 1
+    // returns:
+    //      the level; all zero if there's no such level
+    MipLevel getMipLevel(int32_t level) const noexcept;
+
+    /////////////////////////////////////////////////
+    // Bytes per pixel of an uncompressed format
+    //
+    // in:
+    //      format - a pixel format
+    // returns:
+    //      3 or 4; 0 for compressed or unknown formats
+    static int32_t BytesPerPixel(PixelFormat format) noexcept;
+
+    /////////////////////////////////////////////////
+    // Size of an image in a block compressed format; partial blocks at the edges count as whole ones
+    //
+    // in:
+    //      format - a pixel format
+    //      width, height - size in pixels
+    // returns:
+    //      size in bytes; 0 for uncompressed or unknown formats
+    static int32_t CompressedSize(PixelFormat format, int32_t width, int32_t height) noexcept;
+
+    /////////////////////////////////////////////////
+    // Size of one level of an image, compressed or not
+    //
+    // in:
+    //      format - a pixel format
+    //      width, height - size of the level in pixels
+    // returns:
+    //      size in bytes; 0 for unknown formats
+    static int32_t LevelSize(PixelFormat format, int32_t width, int32_t height) noexcept;
+
+    /////////////////////////////////////////////////
+    // Number of levels in a full mip chain
+    //
+    // in:
+    //      width, height - size of the first level in pixels
+    // returns:
+    //      levels down to and including 1x1
+    static int32_t FullMipCount(int32_t width, int32_t height) noexcept;
 
 private:
+
+    /////////////////////////////////////////////////
+    // Lay out a mip chain, level after level with no gaps
+    //
+    // in:
+    //      format - a pixel format
+    //      width, height - size of the first level in pixels
+    //      count - how many levels; at most FullMipCount()
+    // returns:
+    //      the levels; empty if the format is unknown
+    static std::vector<MipLevel> LayoutMipLevels(PixelFormat format, int32_t width, int32_t height, int32_t count);
     
     /////////////////////////////////////////////////
     // Default constructor, when no valid image data is available
@@ -137,7 +272,7 @@ private:
 
     /////////////////////////////////////////////////
     // Regular constructor, when image data is available.
-    // Should set all data fields.
+    // Should set all data fields; factories with a mip chain fill in m_MipLevels afterwards.
     // All data is immutable once set here.
     Image(const char *filename, ImageType type, PixelFormat format, int32_t width, int32_t height, int32_t depth, int32_t datasize, uint8_t data[]) noexcept :
         m_Filename(filename), m_Type(type), m_Format(format), m_Width(width), m_Height(height), m_Depth(depth), m_DataSize(datasize), m_Data(data) {}
@@ -153,6 +288,8 @@ private:
 
     int32_t m_DataSize;
     std::shared_ptr<uint8_t[]> m_Data;
+
+    std::vector<MipLevel> m_MipLevels;  // empty unless there's more than one level
 };
 
 } // namespace ostrich
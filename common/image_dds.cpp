@@ -4,11 +4,11 @@ Copyright (c) 2020-2021 Ostrich Labs
 
 DDS functions
 
-Supports uncompressed DDS textures with no mipmaps.
+Supports uncompressed (24 and 32 bit) and DXT1/DXT3/DXT5 (S3TC) DDS textures, with or without mipmaps.
 
-Future support for DXTx/S3TC and mipmaps planned.
+Mip levels follow each other in the file, largest first, with no padding between them.
 
-No plans to support cubemaps (yet)
+No plans to support cubemaps or volumes (yet)
 ==========================================
 */
 
@@ -16,8 +16,37 @@ No plans to support cubemaps (yet)
 
 #include "filesystem.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace {
 
+const uint32_t DDS_FILECODE = 0x20534444;   // "DDS "
+
+// m_Flags
+const uint32_t DDSD_REQUIRED = 0x0000'1007; // caps, height, width, pixel format
+const uint32_t DDSD_PITCH = 0x0000'0008;
+const uint32_t DDSD_MIPMAPCOUNT = 0x0002'0000;
+const uint32_t DDSD_LINEARSIZE = 0x0008'0000;
+
+// m_PixelFormatFlags
+const uint32_t DDPF_ALPHAPIXELS = 0x1;
+const uint32_t DDPF_FOURCC = 0x4;
+const uint32_t DDPF_RGB = 0x40;
+
+// m_Caps and m_Caps2
+const uint32_t DDSCAPS_COMPLEX = 0x0000'0008;
+const uint32_t DDSCAPS_TEXTURE = 0x0000'1000;
+const uint32_t DDSCAPS_MIPMAP = 0x0040'0000;
+const uint32_t DDSCAPS2_CUBEMAP = 0x0000'0200;
+const uint32_t DDSCAPS2_VOLUME = 0x0020'0000;
+
+// the four characters as they're read from the file, so the first one is the low byte
+const uint32_t DXT1 = 0x31545844; // "DXT1"
+const uint32_t DXT3 = 0x33545844; // "DXT3"
+const uint32_t DXT5 = 0x35545844; // "DXT5"
+
 /////////////////////////////////////////////////
 // Exactly 128 bytes defined in 4-byte increments, so probably won't have padding
 struct DDSHeader {
@@ -57,15 +86,12 @@ struct DDSHeader {
 //      PixelFormat - one of the valid formats, or FORMAT_NONE if it could not be determined 
 /////////////////////////////////////////////////
 ostrich::PixelFormat DeterminePixelFormat(const DDSHeader &header) {
-    const uint32_t FIRSTMASK = 0xFF00'0000;
-    //const uint32_t DXT1 = 0x44585431; // "DXT1"
-    //const uint32_t DXT3 = 0x44585433; // "DXT3"
-    //const uint32_t DXT5 = 0x44585435; // "DXT5"
+    // masks are of a little-endian pixel, so the channel in the lowest byte comes first in memory
+    const uint32_t LOWMASK = 0x0000'00FF;
+    const uint32_t THIRDMASK = 0x00FF'0000;
 
-    // compressed - unsupported
-    if (header.m_PixelFormatFlags & 0x4) { // DDPF_FOURCC
-        return ostrich::PixelFormat::FORMAT_NONE;
-        /*
+    // compressed
+    if (header.m_PixelFormatFlags & DDPF_FOURCC) {
         switch (header.m_FourCC) {
             case DXT1:
             {
@@ -83,12 +109,16 @@ ostrich::PixelFormat DeterminePixelFormat(const DDSHeader &header) {
             {
                 return ostrich::PixelFormat::FORMAT_NONE;
             }
-        }*/
+        }
+    }
+
+    // uncompressed; a 32 bit pixel without alpha (X8R8G8B8) has no matching format
+    bool hasAlpha = (header.m_PixelFormatFlags & DDPF_ALPHAPIXELS) ? true : false;
+    if (header.m_BitsPerPixel != (hasAlpha ? 32u : 24u)) {
+        return ostrich::PixelFormat::FORMAT_NONE;
     }
 
-    // uncompressed
-    bool hasAlpha = (header.m_PixelFormatFlags & 0x1) ? true : false; // DDPF_ALPHAPIXELS
-    if (header.m_BlueBitMask == FIRSTMASK) {
+    if ((header.m_BlueBitMask == LOWMASK) && (header.m_RedBitMask == THIRDMASK)) {
         if (hasAlpha) {
             return ostrich::PixelFormat::FORMAT_BGRA;
         }
@@ -96,7 +126,7 @@ ostrich::PixelFormat DeterminePixelFormat(const DDSHeader &header) {
     }
 
     // this might not be necessary, but I'm doing it anyway
-    if (header.m_RedBitMask == FIRSTMASK) {
+    if ((header.m_RedBitMask == LOWMASK) && (header.m_BlueBitMask == THIRDMASK)) {
         if (hasAlpha) {
             return ostrich::PixelFormat::FORMAT_RGBA;
         }
@@ -119,30 +149,55 @@ ostrich::Image ostrich::Image::LoadDDS(const char *filename) {
     std::fstream &handle = file.getFStream();
     DDSHeader header = {};
     handle.read((char *)&header, sizeof(header));
-    if (handle.bad()) {
+    if (handle.fail()) {
         return ostrich::Image();
     }
 
-    // verify file integrity
-    if ((header.m_FileCode != 0x20534444) ||
+    // verify file integrity; the size limit keeps a whole 32 bit mip chain's byte count in an int32_t
+    if ((header.m_FileCode != DDS_FILECODE) ||
         (header.m_Size != 124) ||
-        (header.m_PixelFormatSize != 32)) {
+        (header.m_PixelFormatSize != 32) ||
+        (header.m_Width == 0) || (header.m_Width > 0x4000) ||
+        (header.m_Height == 0) || (header.m_Height > 0x4000)) {
         return ostrich::Image();
     }
 
     // verify supported features
-    if ((header.m_VolumeDepth > 1) ||       // no cubemaps
-        (header.m_MipMapCount > 1) ||       // no mipmaps
-        (header.m_Caps != 0x0000'1000)) {   // also no mipmaps/cubemaps
+    if ((header.m_VolumeDepth > 1) ||                                           // no volumes
+        (header.m_Caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) ||              // no cubemaps or volumes
+        !(header.m_Caps & DDSCAPS_TEXTURE)) {
         return ostrich::Image();
     }
 
     // determine pixel format
     ostrich::PixelFormat pixformat = ::DeterminePixelFormat(header);
+    if (pixformat == ostrich::PixelFormat::FORMAT_NONE) {
+        return ostrich::Image();
+    }
+
+    // the count only means something with its flag set; a chain longer than it could be is cut at 1x1
+    int32_t width = static_cast<int32_t>(header.m_Width), height = static_cast<int32_t>(header.m_Height);
+    int32_t mipcount = 1;
+    if ((header.m_Flags & DDSD_MIPMAPCOUNT) && (header.m_MipMapCount > 1)) {
+        mipcount = static_cast<int32_t>(std::min(header.m_MipMapCount, static_cast<uint32_t>(ostrich::Image::FullMipCount(width, height))));
+    }
+    std::vector<ostrich::Image::MipLevel> levels = ostrich::Image::LayoutMipLevels(pixformat, width, height, mipcount);
+    if (levels.empty()) {
+        return ostrich::Image();
+    }
 
-    // determine data size
+    // anything past the last level isn't part of the image
     auto &path = file.getPath();
-    auto datasize = std::filesystem::file_size(path) - sizeof(header);
+    auto available = std::filesystem::file_size(path) - sizeof(header);
+    auto datasize = static_cast<std::uintmax_t>(levels.back().m_Offset) + static_cast<std::uintmax_t>(levels.back().m_Size);
+    if (available < datasize) {
+        return ostrich::Image();
+    }
+
+    // compressed files don't carry a bit depth
+    if ((pixformat > ostrich::PixelFormat::FORMAT_COMPRESSED_START) && (pixformat < ostrich::PixelFormat::FORMAT_COMPRESSED_END)) {
+        header.m_BitsPerPixel = (pixformat == ostrich::PixelFormat::FORMAT_DXT1) ? 4 : 8;
+    }
 
     // everything after the header is pixel data regardless of compression
     uint8_t *imgdata = new uint8_t[datasize];
@@ -152,6 +207,79 @@ ostrich::Image ostrich::Image::LoadDDS(const char *filename) {
         return ostrich::Image();
     }
 
-    return ostrich::Image(filename, ostrich::ImageType::IMGTYPE_DDS, pixformat, header.m_Width,
-        header.m_Height, header.m_BitsPerPixel, static_cast<int32_t>(datasize), imgdata);
-}
\ No newline at end of file
+    ostrich::Image image(filename, ostrich::ImageType::IMGTYPE_DDS, pixformat, width, height,
+        static_cast<int32_t>(header.m_BitsPerPixel), static_cast<int32_t>(datasize), imgdata);
+    if (levels.size() > 1) {
+        image.m_MipLevels = std::move(levels);
+    }
+    return image;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::Image::SaveDDS(const char *filename) const {
+    ostrich::Image::MipLevel last = this->getMipLevel(this->getMipCount() - 1);
+    int32_t bytesperpixel = ostrich::Image::BytesPerPixel(m_Format);
+    auto data = m_Data;
+    if (!this->isValid() || (data == nullptr) || (m_DataSize < (last.m_Offset + last.m_Size)))
+        return false;
+
+    DDSHeader header = {};
+    header.m_FileCode = DDS_FILECODE;
+    header.m_Size = 124;
+    header.m_Flags = DDSD_REQUIRED;
+    header.m_Width = static_cast<uint32_t>(m_Width);
+    header.m_Height = static_cast<uint32_t>(m_Height);
+    header.m_PixelFormatSize = 32;
+    header.m_Caps = DDSCAPS_TEXTURE;
+    if (this->getMipCount() > 1) {
+        header.m_Flags |= DDSD_MIPMAPCOUNT;
+        header.m_MipMapCount = static_cast<uint32_t>(this->getMipCount());
+        header.m_Caps |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+    }
+
+    switch (m_Format) {
+        case ostrich::PixelFormat::FORMAT_DXT1:
+        case ostrich::PixelFormat::FORMAT_DXT3:
+        case ostrich::PixelFormat::FORMAT_DXT5:
+        {
+            header.m_Flags |= DDSD_LINEARSIZE;
+            header.m_PitchorLinearSize = static_cast<uint32_t>(this->getMipLevel(0).m_Size);
+            header.m_PixelFormatFlags = DDPF_FOURCC;
+            header.m_FourCC = (m_Format == ostrich::PixelFormat::FORMAT_DXT1) ? DXT1 : ((m_Format == ostrich::PixelFormat::FORMAT_DXT3) ? DXT3 : DXT5);
+            break;
+        }
+        case ostrich::PixelFormat::FORMAT_BGR:
+        case ostrich::PixelFormat::FORMAT_BGRA:
+        case ostrich::PixelFormat::FORMAT_RGB:
+        case ostrich::PixelFormat::FORMAT_RGBA:
+        {
+            bool bluefirst = ((m_Format == ostrich::PixelFormat::FORMAT_BGR) || (m_Format == ostrich::PixelFormat::FORMAT_BGRA));
+            header.m_Flags |= DDSD_PITCH;
+            header.m_PitchorLinearSize = static_cast<uint32_t>(m_Width * bytesperpixel);
+            header.m_PixelFormatFlags = DDPF_RGB;
+            header.m_BitsPerPixel = static_cast<uint32_t>(bytesperpixel * 8);
+            header.m_RedBitMask = bluefirst ? 0x00FF'0000 : 0x0000'00FF;
+            header.m_GreenBitMask = 0x0000'FF00;
+            header.m_BlueBitMask = bluefirst ? 0x0000'00FF : 0x00FF'0000;
+            if (bytesperpixel == 4) {
+                header.m_PixelFormatFlags |= DDPF_ALPHAPIXELS;
+                header.m_AlphaBitMask = 0xFF00'0000;
+            }
+            break;
+        }
+        default:
+        {
+            return false;
+        }
+    }
+
+    ostrich::File file;
+    if (!file.Open(filename, ostrich::FileMode::OPEN_WRITETRUNCATE))
+        return false;
+    std::fstream &handle = file.getFStream();
+
+    handle.write((const char *)&header, sizeof(header));
+    handle.write((const char *)data.get(), static_cast<std::streamsize>(last.m_Offset + last.m_Size));
+    return !handle.fail();
+}
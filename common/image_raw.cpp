@@ -0,0 +1,174 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Image functions that aren't tied to one file format
+==========================================
+*/
+
+#include "image.h"
+
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+/////////////////////////////////////////////////
+// Check a filename's extension, ignoring case
+//
+// in:
+//      filename - the path
+//      extension - the extension with its dot, in lower case
+// returns:
+//      true if the filename ends with the extension
+bool HasExtension(std::string_view filename, std::string_view extension) {
+    if (filename.size() < extension.size())
+        return false;
+
+    std::string_view ending = filename.substr(filename.size() - extension.size());
+    for (std::size_t i = 0; i < extension.size(); i++) {
+        if (std::tolower(static_cast<unsigned char>(ending[i])) != extension[i])
+            return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::Image ostrich::Image::LoadFile(const char *filename) {
+    if (HasExtension(filename, u8".tga"))
+        return ostrich::Image::LoadTGA(filename);
+    if (HasExtension(filename, u8".dds"))
+        return ostrich::Image::LoadDDS(filename);
+    if (HasExtension(filename, u8".png"))
+        return ostrich::Image::LoadPNG(filename);
+    return ostrich::Image();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::Image ostrich::Image::FromPixels(ostrich::PixelFormat format, int32_t width, int32_t height, std::unique_ptr<uint8_t[]> data) {
+    int32_t bytesperpixel = ostrich::Image::BytesPerPixel(format);
+    if ((bytesperpixel == 0) || (width <= 0) || (height <= 0) || (data == nullptr))
+        return ostrich::Image();
+
+    return ostrich::Image(u8"", ostrich::ImageType::IMGTYPE_RAW, format, width, height, bytesperpixel * 8,
+        width * height * bytesperpixel, data.release());
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int32_t ostrich::Image::BytesPerPixel(ostrich::PixelFormat format) noexcept {
+    switch (format) {
+        case ostrich::PixelFormat::FORMAT_RGB:
+        case ostrich::PixelFormat::FORMAT_BGR:
+        {
+            return 3;
+        }
+        case ostrich::PixelFormat::FORMAT_RGBA:
+        case ostrich::PixelFormat::FORMAT_BGRA:
+        {
+            return 4;
+        }
+        default:
+        {
+            return 0;
+        }
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int32_t ostrich::Image::LevelSize(ostrich::PixelFormat format, int32_t width, int32_t height) noexcept {
+    if ((format > ostrich::PixelFormat::FORMAT_COMPRESSED_START) && (format < ostrich::PixelFormat::FORMAT_COMPRESSED_END))
+        return ostrich::Image::CompressedSize(format, width, height);
+    return width * height * ostrich::Image::BytesPerPixel(format);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int32_t ostrich::Image::FullMipCount(int32_t width, int32_t height) noexcept {
+    int32_t count = 1;
+    for (int32_t size = std::max(width, height); size > 1; size /= 2) {
+        count++;
+    }
+    return count;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+std::vector<ostrich::Image::MipLevel> ostrich::Image::LayoutMipLevels(ostrich::PixelFormat format, int32_t width, int32_t height, int32_t count) {
+    std::vector<ostrich::Image::MipLevel> levels;
+    if (ostrich::Image::LevelSize(format, 1, 1) == 0)
+        return levels;
+
+    count = std::min(count, ostrich::Image::FullMipCount(width, height));
+    levels.reserve(static_cast<std::size_t>(std::max(count, 0)));
+    int32_t offset = 0;
+    for (int32_t i = 0; i < count; i++) {
+        ostrich::Image::MipLevel level = { width, height, offset, ostrich::Image::LevelSize(format, width, height) };
+        levels.push_back(level);
+        offset += level.m_Size;
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+    return levels;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::Image::MipLevel ostrich::Image::getMipLevel(int32_t level) const noexcept {
+    if (m_MipLevels.empty()) {
+        if (level == 0)
+            return { m_Width, m_Height, 0, m_DataSize };
+        return { 0, 0, 0, 0 };
+    }
+    if ((level < 0) || (level >= static_cast<int32_t>(m_MipLevels.size())))
+        return { 0, 0, 0, 0 };
+    return m_MipLevels[static_cast<std::size_t>(level)];
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::Image ostrich::Image::GenerateMipmaps(const ostrich::Image &image) {
+    int32_t bytesperpixel = ostrich::Image::BytesPerPixel(image.getPixelFormat());
+    auto data = image.getData().lock();
+    if (!image.isValid() || (bytesperpixel == 0) || (data == nullptr) ||
+        (image.getDataSize() < ostrich::Image::LevelSize(image.getPixelFormat(), image.getWidth(), image.getHeight())))
+        return ostrich::Image();
+
+    std::vector<ostrich::Image::MipLevel> levels = ostrich::Image::LayoutMipLevels(image.getPixelFormat(), image.getWidth(),
+        image.getHeight(), ostrich::Image::FullMipCount(image.getWidth(), image.getHeight()));
+    int32_t datasize = levels.back().m_Offset + levels.back().m_Size;
+    std::unique_ptr<uint8_t[]> pixels(new uint8_t[static_cast<std::size_t>(datasize)]);
+    std::copy_n(data.get(), levels[0].m_Size, pixels.get());
+
+    // each level is filtered from the one before it, so the work shrinks by four every step
+    for (std::size_t i = 1; i < levels.size(); i++) {
+        const ostrich::Image::MipLevel &source = levels[i - 1];
+        const ostrich::Image::MipLevel &target = levels[i];
+        const uint8_t *from = &pixels[static_cast<std::size_t>(source.m_Offset)];
+        uint8_t *to = &pixels[static_cast<std::size_t>(target.m_Offset)];
+        for (int32_t y = 0; y < target.m_Height; y++) {
+            int32_t y0 = std::min(y * 2, source.m_Height - 1), y1 = std::min((y * 2) + 1, source.m_Height - 1);
+            for (int32_t x = 0; x < target.m_Width; x++) {
+                int32_t x0 = std::min(x * 2, source.m_Width - 1), x1 = std::min((x * 2) + 1, source.m_Width - 1);
+                for (int32_t c = 0; c < bytesperpixel; c++) {
+                    int32_t sum = from[(((y0 * source.m_Width) + x0) * bytesperpixel) + c] + from[(((y0 * source.m_Width) + x1) * bytesperpixel) + c] +
+                        from[(((y1 * source.m_Width) + x0) * bytesperpixel) + c] + from[(((y1 * source.m_Width) + x1) * bytesperpixel) + c];
+                    to[(((y * target.m_Width) + x) * bytesperpixel) + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+
+    ostrich::Image mipmapped(u8"", ostrich::ImageType::IMGTYPE_RAW, image.getPixelFormat(), image.getWidth(), image.getHeight(),
+        bytesperpixel * 8, datasize, pixels.release());
+    if (levels.size() > 1)
+        mipmapped.m_MipLevels = std::move(levels);
+    return mipmapped;
+}
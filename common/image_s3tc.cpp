@@ -0,0 +1,249 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+S3TC (DXT) functions
+
+Block sizes, and a software decoder for GPUs without S3TC support (like the Raspberry Pi's).
+Every format stores 4x4 pixel blocks, left to right and top to bottom:
+    DXT1 - 8 bytes: two RGB565 colours and 2 bits per pixel picking one of four colours (or three plus transparent)
+    DXT3 - 16 bytes: 4 bits of alpha per pixel, then a DXT1 colour block that always uses four colours
+    DXT5 - 16 bytes: two alphas and 3 bits per pixel picking one of eight, then a four colour DXT1 block
+==========================================
+*/
+
+#include "image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/////////////////////////////////////////////////
+// Read a little-endian value out of a block
+//
+// in:
+//      data - the first byte
+//      bytes - how many bytes, up to 8
+// returns:
+//      the value
+uint64_t ReadLE(const uint8_t *data, int bytes) noexcept {
+    uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; i--) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+/////////////////////////////////////////////////
+// Expand an RGB565 colour
+//
+// in:
+//      colour - the packed colour
+// out:
+//      rgba - red, green and blue; alpha is left alone
+// returns:
+//      void
+void Expand565(uint16_t colour, uint8_t *rgba) noexcept {
+    uint8_t red = static_cast<uint8_t>((colour >> 11) & 0x1F);
+    uint8_t green = static_cast<uint8_t>((colour >> 5) & 0x3F);
+    uint8_t blue = static_cast<uint8_t>(colour & 0x1F);
+    rgba[0] = static_cast<uint8_t>((red << 3) | (red >> 2));
+    rgba[1] = static_cast<uint8_t>((green << 2) | (green >> 4));
+    rgba[2] = static_cast<uint8_t>((blue << 3) | (blue >> 2));
+}
+
+/////////////////////////////////////////////////
+// Decode a DXT1-style colour block into 16 RGBA pixels
+//
+// in:
+//      block - 8 bytes
+//      punchthrough - true for DXT1, where the colour order picks the three colour + transparent mode
+// out:
+//      pixels - 16 pixels, 4 bytes each, row by row; alpha is only written in three colour mode
+// returns:
+//      void
+void DecodeColours(const uint8_t *block, bool punchthrough, uint8_t *pixels) noexcept {
+    uint16_t first = static_cast<uint16_t>(ReadLE(block, 2));
+    uint16_t second = static_cast<uint16_t>(ReadLE(block + 2, 2));
+    uint32_t indices = static_cast<uint32_t>(ReadLE(block + 4, 4));
+
+    uint8_t palette[4][4] = {};
+    Expand565(first, palette[0]);
+    Expand565(second, palette[1]);
+    palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 0xFF;
+    bool fourcolours = (!punchthrough || (first > second));
+    for (int c = 0; c < 3; c++) {
+        if (fourcolours) {
+            palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c]) / 3);
+            palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c]) / 3);
+        }
+        else {
+            palette[2][c] = static_cast<uint8_t>((palette[0][c] + palette[1][c]) / 2);
+            palette[3][c] = 0;
+        }
+    }
+    if (!fourcolours)
+        palette[3][3] = 0;
+
+    for (int i = 0; i < 16; i++) {
+        const uint8_t *colour = palette[(indices >> (i * 2)) & 0x3];
+        uint8_t *pixel = pixels + (i * 4);
+        pixel[0] = colour[0];
+        pixel[1] = colour[1];
+        pixel[2] = colour[2];
+        if (punchthrough)
+            pixel[3] = colour[3];
+    }
+}
+
+/////////////////////////////////////////////////
+// Decode a DXT5 alpha block
+//
+// in:
+//      block - 8 bytes
+// out:
+//      pixels - 16 RGBA pixels; only alpha is written
+// returns:
+//      void
+void DecodeInterpolatedAlpha(const uint8_t *block, uint8_t *pixels) noexcept {
+    uint8_t alphas[8] = { block[0], block[1] };
+    if (alphas[0] > alphas[1]) {
+        for (int i = 1; i < 7; i++) {
+            alphas[i + 1] = static_cast<uint8_t>(((7 - i) * alphas[0] + i * alphas[1]) / 7);
+        }
+    }
+    else {
+        for (int i = 1; i < 5; i++) {
+            alphas[i + 1] = static_cast<uint8_t>(((5 - i) * alphas[0] + i * alphas[1]) / 5);
+        }
+        alphas[6] = 0;
+        alphas[7] = 0xFF;
+    }
+
+    uint64_t indices = ReadLE(block + 2, 6);
+    for (int i = 0; i < 16; i++) {
+        pixels[(i * 4) + 3] = alphas[(indices >> (i * 3)) & 0x7];
+    }
+}
+
+/////////////////////////////////////////////////
+// Decode a DXT3 alpha block
+//
+// in:
+//      block - 8 bytes
+// out:
+//      pixels - 16 RGBA pixels; only alpha is written
+// returns:
+//      void
+void DecodeExplicitAlpha(const uint8_t *block, uint8_t *pixels) noexcept {
+    uint64_t alphas = ReadLE(block, 8);
+    for (int i = 0; i < 16; i++) {
+        uint8_t alpha = static_cast<uint8_t>((alphas >> (i * 4)) & 0xF);
+        pixels[(i * 4) + 3] = static_cast<uint8_t>((alpha << 4) | alpha);
+    }
+}
+
+/////////////////////////////////////////////////
+// Decode one level of a compressed image
+//
+// in:
+//      format - FORMAT_DXT1, FORMAT_DXT3 or FORMAT_DXT5
+//      block - the level's first block
+//      width, height - size of the level in pixels
+// out:
+//      pixels - width * height RGBA pixels
+// returns:
+//      void
+void DecodeLevel(ostrich::PixelFormat format, const uint8_t *block, int32_t width, int32_t height, uint8_t *pixels) noexcept {
+    int32_t blockbytes = (format == ostrich::PixelFormat::FORMAT_DXT1) ? 8 : 16;
+    uint8_t decoded[16 * 4];
+    for (int32_t blocky = 0; blocky < height; blocky += 4) {
+        for (int32_t blockx = 0; blockx < width; blockx += 4) {
+            switch (format) {
+                case ostrich::PixelFormat::FORMAT_DXT1:
+                {
+                    DecodeColours(block, true, decoded);
+                    break;
+                }
+                case ostrich::PixelFormat::FORMAT_DXT3:
+                {
+                    DecodeExplicitAlpha(block, decoded);
+                    DecodeColours(block + 8, false, decoded);
+                    break;
+                }
+                default:
+                {
+                    DecodeInterpolatedAlpha(block, decoded);
+                    DecodeColours(block + 8, false, decoded);
+                    break;
+                }
+            }
+            block += blockbytes;
+
+            // blocks hanging off the right or bottom edge only keep the pixels inside the image
+            int32_t columns = std::min(4, width - blockx);
+            for (int32_t row = 0; (row < 4) && ((blocky + row) < height); row++) {
+                std::memcpy(&pixels[((static_cast<std::size_t>(blocky + row) * static_cast<std::size_t>(width)) + static_cast<std::size_t>(blockx)) * 4],
+                    &decoded[row * 16], static_cast<std::size_t>(columns) * 4);
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int32_t ostrich::Image::CompressedSize(ostrich::PixelFormat format, int32_t width, int32_t height) noexcept {
+    int32_t blockbytes = 0;
+    switch (format) {
+        case ostrich::PixelFormat::FORMAT_DXT1:
+        {
+            blockbytes = 8;
+            break;
+        }
+        case ostrich::PixelFormat::FORMAT_DXT3:
+        case ostrich::PixelFormat::FORMAT_DXT5:
+        {
+            blockbytes = 16;
+            break;
+        }
+        default:
+        {
+            return 0;
+        }
+    }
+    return std::max((width + 3) / 4, 1) * std::max((height + 3) / 4, 1) * blockbytes;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::Image ostrich::Image::Decompress(const ostrich::Image &image) {
+    ostrich::PixelFormat format = image.getPixelFormat();
+    ostrich::Image::MipLevel last = image.getMipLevel(image.getMipCount() - 1);
+    auto data = image.getData().lock();
+    if (!image.isValid() || !image.isCompressed() || (image.getWidth() <= 0) || (image.getHeight() <= 0) ||
+        (last.m_Size == 0) || (image.getDataSize() < (last.m_Offset + last.m_Size)) || (data == nullptr))
+        return ostrich::Image();
+
+    // the decoded chain has the same levels, just bigger ones
+    std::vector<ostrich::Image::MipLevel> levels = ostrich::Image::LayoutMipLevels(ostrich::PixelFormat::FORMAT_RGBA,
+        image.getWidth(), image.getHeight(), image.getMipCount());
+    int32_t datasize = levels.back().m_Offset + levels.back().m_Size;
+    std::unique_ptr<uint8_t[]> pixels(new uint8_t[static_cast<std::size_t>(datasize)]);
+    for (int32_t i = 0; i < image.getMipCount(); i++) {
+        ostrich::Image::MipLevel source = image.getMipLevel(i);
+        const ostrich::Image::MipLevel &target = levels[static_cast<std::size_t>(i)];
+        ::DecodeLevel(format, &data[static_cast<std::size_t>(source.m_Offset)], target.m_Width, target.m_Height,
+            &pixels[static_cast<std::size_t>(target.m_Offset)]);
+    }
+
+    ostrich::Image decoded(u8"", ostrich::ImageType::IMGTYPE_RAW, ostrich::PixelFormat::FORMAT_RGBA, image.getWidth(), image.getHeight(),
+        32, datasize, pixels.release());
+    if (levels.size() > 1)
+        decoded.m_MipLevels = std::move(levels);
+    return decoded;
+}
@@ -20,6 +20,7 @@ Future supported planned but not implemented (and low priority):
 
 #include <cstring>
 #include <fstream>
+#include <utility>
 #include "filesystem.h"
 
 namespace {
@@ -107,7 +108,7 @@ TGAHeader::TGAHeader(uint8_t data[TGAHeader::SIZE]) {
     std::memcpy(&m_XOrigin, &data[8], sizeof(m_XOrigin));
     std::memcpy(&m_YOrigin, &data[10], sizeof(m_YOrigin));
     std::memcpy(&m_Width, &data[12], sizeof(m_Width));
-    std::memcpy(&m_Height, &data[12], sizeof(m_Height));
+    std::memcpy(&m_Height, &data[14], sizeof(m_Height));
     m_BitsPerPixel = data[16];
     m_ImageDescriptor = data[17];
 }
@@ -158,10 +159,11 @@ ostrich::Image ostrich::Image::LoadTGA(const char *filename) {
         return ostrich::Image();
     }
 
-    ostrich::PixelFormat pixformat = ostrich::PixelFormat::FORMAT_RGB;
+    // truecolor TGA pixels are stored blue first
+    ostrich::PixelFormat pixformat = ostrich::PixelFormat::FORMAT_BGR;
     uint8_t alphabits = header.m_ImageDescriptor & 0x0F;
     if (alphabits > 0) {
-        pixformat = ostrich::PixelFormat::FORMAT_RGBA;
+        pixformat = ostrich::PixelFormat::FORMAT_BGRA;
     }
 
     // Detecting TGA version - this only means something once RLE is supported, maybe
@@ -175,7 +177,7 @@ ostrich::Image ostrich::Image::LoadTGA(const char *filename) {
     handle.seekg(TGAHeader::SIZE, std::ios_base::beg);
 
     // this is the UNPACKED data size
-    int32_t datasize = static_cast<int32_t>(header.m_Height) * header.m_Width * header.m_BitsPerPixel;
+    int32_t datasize = static_cast<int32_t>(header.m_Height) * header.m_Width * (header.m_BitsPerPixel / 8);
     uint8_t *imgdata = nullptr;
 
     if (!isRLE) {
@@ -190,6 +192,65 @@ ostrich::Image ostrich::Image::LoadTGA(const char *filename) {
         return ostrich::Image();
     }
 
+    // descriptor bit 5 clear means the file stores its bottom row first; Images are always top row first
+    if ((header.m_ImageDescriptor & 0x20) == 0) {
+        std::size_t rowbytes = static_cast<std::size_t>(header.m_Width) * (header.m_BitsPerPixel / 8);
+        std::unique_ptr<uint8_t[]> row(new uint8_t[rowbytes]);
+        for (int32_t top = 0, bottom = header.m_Height - 1; top < bottom; top++, bottom--) {
+            uint8_t *toprow = &imgdata[static_cast<std::size_t>(top) * rowbytes];
+            uint8_t *bottomrow = &imgdata[static_cast<std::size_t>(bottom) * rowbytes];
+            std::memcpy(row.get(), toprow, rowbytes);
+            std::memcpy(toprow, bottomrow, rowbytes);
+            std::memcpy(bottomrow, row.get(), rowbytes);
+        }
+    }
+
     return ostrich::Image(filename, ostrich::ImageType::IMGTYPE_TGA, pixformat, header.m_Width,
         header.m_Height, header.m_BitsPerPixel, datasize, imgdata);
-}
\ No newline at end of file
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::Image::SaveTGA(const char *filename) const {
+    int32_t bytesperpixel = ostrich::Image::BytesPerPixel(m_Format);
+    if (!this->isValid() || (bytesperpixel == 0) || (m_Width > 0xFFFF) || (m_Height > 0xFFFF))
+        return false;
+
+    auto data = m_Data;
+    if (data == nullptr)
+        return false;
+
+    ostrich::File file;
+    if (!file.Open(filename, ostrich::FileMode::OPEN_WRITETRUNCATE))
+        return false;
+    std::fstream &handle = file.getFStream();
+
+    // type 2 (uncompressed truecolor); descriptor bit 5 puts the first row at the top
+    uint8_t header[TGAHeader::SIZE] = { };
+    header[2] = 2;
+    header[12] = static_cast<uint8_t>(m_Width & 0xFF);
+    header[13] = static_cast<uint8_t>((m_Width >> 8) & 0xFF);
+    header[14] = static_cast<uint8_t>(m_Height & 0xFF);
+    header[15] = static_cast<uint8_t>((m_Height >> 8) & 0xFF);
+    header[16] = static_cast<uint8_t>(bytesperpixel * 8);
+    header[17] = static_cast<uint8_t>(0x20 | ((bytesperpixel == 4) ? 8 : 0));
+    handle.write((const char *)header, TGAHeader::SIZE);
+
+    // TGA wants blue first, so red-first images are swapped a row at a time on the way out
+    std::size_t rowbytes = static_cast<std::size_t>(m_Width) * static_cast<std::size_t>(bytesperpixel);
+    bool swap = ((m_Format == ostrich::PixelFormat::FORMAT_RGB) || (m_Format == ostrich::PixelFormat::FORMAT_RGBA));
+    std::unique_ptr<uint8_t[]> row(new uint8_t[rowbytes]);
+    for (int32_t y = 0; y < m_Height; y++) {
+        const uint8_t *source = &data[static_cast<std::size_t>(y) * rowbytes];
+        if (swap) {
+            std::memcpy(row.get(), source, rowbytes);
+            for (std::size_t i = 0; i < rowbytes; i += static_cast<std::size_t>(bytesperpixel)) {
+                std::swap(row[i], row[i + 2]);
+            }
+            source = row.get();
+        }
+        handle.write((const char *)source, static_cast<std::streamsize>(rowbytes));
+    }
+
+    return !handle.fail();
+}
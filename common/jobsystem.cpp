@@ -0,0 +1,247 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "jobsystem.h"
+
+#include <algorithm>
+#include "trace.h"
+
+namespace {
+
+// which system's worker the calling thread is, and which queue it owns
+thread_local const ostrich::JobSystem *t_Owner = nullptr;
+thread_local std::size_t t_QueueIndex = 0;
+
+} // anonymous namespace
+
+std::atomic<ostrich::JobSystem *> ostrich::JobSystem::ms_Active(nullptr);
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::JobSystem::JobSystem() :
+    m_Queued(0), m_Executed(0), m_Stolen(0), m_Stop(false) {
+    m_Queues.push_back(std::make_unique<WorkQueue>());
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int32_t ostrich::JobSystem::Initialize(int32_t workercount) {
+    this->Destroy();
+
+    if (workercount <= 0) {
+        workercount = std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency()) - 1);
+    }
+
+    m_Stop = false;
+    m_Queues.resize(1);
+    for (int32_t i = 0; i < workercount; i++) {
+        m_Queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (int32_t i = 0; i < workercount; i++) {
+        m_Workers.emplace_back(&JobSystem::WorkerThread, this, static_cast<std::size_t>(i + 1));
+    }
+
+    ms_Active.store(this, std::memory_order_release);
+    return workercount;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::JobSystem::Destroy() {
+    JobSystem *self = this;
+    ms_Active.compare_exchange_strong(self, nullptr, std::memory_order_acq_rel);
+
+    if (!m_Workers.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(m_SleepMutex);
+            m_Stop = true;
+        }
+        m_Wake.notify_all();
+        for (auto &worker : m_Workers) {
+            worker.join();
+        }
+        m_Workers.clear();
+    }
+
+    // anything released by the last jobs, or submitted with no workers and never waited on
+    while (this->RunOne()) {}
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::JobSystem::Submit(ostrich::JobFunction job, ostrich::JobCounter *counter) {
+    if (counter != nullptr) {
+        counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    this->Push(Job{ std::move(job), counter });
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::JobSystem::SubmitAfter(ostrich::JobCounter &dependency, ostrich::JobFunction job, ostrich::JobCounter *counter) {
+    if (counter != nullptr) {
+        counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        // checked under the lock, so the dependency can't finish between the check and the push_back
+        std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+        if (!dependency.isDone()) {
+            dependency.m_Waiting.emplace_back(std::move(job), counter);
+            return;
+        }
+    }
+    this->Push(Job{ std::move(job), counter });
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::JobSystem::ParallelFor(std::size_t count, std::size_t batchsize,
+    const std::function<void(std::size_t, std::size_t)> &job) {
+    if (batchsize == 0) {
+        batchsize = 1;
+    }
+
+    JobCounter counter;
+    for (std::size_t begin = 0; begin < count; begin += batchsize) {
+        std::size_t end = std::min(count, begin + batchsize);
+        this->Submit([&job, begin, end]() { job(begin, end); }, &counter);
+    }
+    this->Wait(counter);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::JobSystem::Wait(const ostrich::JobCounter &counter) {
+    OST_TRACE_SCOPE("JobSystem::Wait");
+    while (!counter.isDone()) {
+        if (!this->RunOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::JobSystem::RunOne() {
+    Job job;
+    if (!this->Take(this->getQueueIndex(), job))
+        return false;
+
+    this->Execute(job);
+    return true;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+std::size_t ostrich::JobSystem::getQueueIndex() const noexcept {
+    return (t_Owner == this) ? t_QueueIndex : 0;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::JobSystem::Push(Job job) {
+    WorkQueue &queue = *m_Queues[this->getQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.m_Mutex);
+        queue.m_Jobs.push_back(std::move(job));
+    }
+    m_Queued.fetch_add(1, std::memory_order_release);
+
+    if (!m_Workers.empty()) {
+        // taking the lock means a worker can't be between checking m_Queued and going to sleep
+        { std::lock_guard<std::mutex> lock(m_SleepMutex); }
+        m_Wake.notify_one();
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::JobSystem::Take(std::size_t index, Job &job) {
+    if (m_Queued.load(std::memory_order_acquire) <= 0)
+        return false;
+
+    {
+        WorkQueue &queue = *m_Queues[index];
+        std::lock_guard<std::mutex> lock(queue.m_Mutex);
+        if (!queue.m_Jobs.empty()) {
+            job = std::move(queue.m_Jobs.back());
+            queue.m_Jobs.pop_back();
+            m_Queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // start with the next queue along, so thieves spread out instead of all hitting queue 0
+    std::size_t count = m_Queues.size();
+    for (std::size_t i = 1; i < count; i++) {
+        WorkQueue &victim = *m_Queues[(index + i) % count];
+        std::lock_guard<std::mutex> lock(victim.m_Mutex);
+        if (!victim.m_Jobs.empty()) {
+            job = std::move(victim.m_Jobs.front());
+            victim.m_Jobs.pop_front();
+            m_Queued.fetch_sub(1, std::memory_order_relaxed);
+            m_Stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::JobSystem::Execute(Job &job) {
+    job.m_Function();
+    job.m_Function = nullptr; // let go of anything it captured before whoever is waiting carries on
+    m_Executed.fetch_add(1, std::memory_order_relaxed);
+
+    JobCounter *counter = job.m_Counter;
+    if (counter == nullptr)
+        return;
+
+    // the last job doesn't drop the counter to zero directly; see JobCounter::RELEASING
+    int32_t pending = counter->m_Pending.load(std::memory_order_relaxed);
+    for (;;) {
+        int32_t next = (pending == 1) ? JobCounter::RELEASING : (pending - 1);
+        if (counter->m_Pending.compare_exchange_weak(pending, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            if (pending != 1)
+                return;
+            break;
+        }
+    }
+
+    // that was the last one; release whatever was waiting on this counter
+    std::vector<std::pair<JobFunction, JobCounter *>> waiting;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_Mutex);
+        waiting.swap(counter->m_Waiting);
+        counter->m_Pending.fetch_sub(JobCounter::RELEASING, std::memory_order_acq_rel);
+    }
+    for (auto &next : waiting) {
+        this->Push(Job{ std::move(next.first), next.second });
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::JobSystem::WorkerThread(std::size_t index) {
+    t_Owner = this;
+    t_QueueIndex = index;
+    OST_TRACE_THREAD("Job worker");
+
+    for (;;) {
+        if (this->RunOne())
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_Wake.wait(lock, [this]() { return (m_Stop || (m_Queued.load(std::memory_order_acquire) > 0)); });
+        if (m_Stop && (m_Queued.load(std::memory_order_acquire) <= 0))
+            break;
+    }
+
+    t_Owner = nullptr;
+}
@@ -0,0 +1,267 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Job system
+
+A fixed pool of worker threads running small jobs (any callable) with work stealing:
+every worker has its own queue, pushes and pops its own work at the back (newest first, while it's cache-hot)
+and, when it runs dry, steals from the front of someone else's (oldest first, likely the biggest pieces).
+Threads that aren't workers (the main thread, the simulation thread) share one more queue.
+
+Completion is tracked with JobCounters: submitting a job against a counter bumps it, finishing the job drops it.
+Jobs can be held back until a counter reaches zero (a dependency), and Wait() runs other jobs while it waits
+instead of blocking, so waiting on the main thread doesn't waste a core.
+
+Jobs must not throw; like any other thread, an exception escaping a job on a worker ends the program.
+==========================================
+*/
+
+#ifndef OSTRICH_JOBSYSTEM_H_
+#define OSTRICH_JOBSYSTEM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "ost_common.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+// A unit of work
+using JobFunction = std::function<void()>;
+
+/////////////////////////////////////////////////
+// forward declarations
+class JobSystem;
+
+/////////////////////////////////////////////////
+// Counts jobs that haven't finished yet
+// Has to outlive every job submitted against it (and every job waiting on it)
+class JobCounter {
+public:
+
+    /////////////////////////////////////////////////
+    // Constructor starts at zero (done)
+    // Destructor waits out the thread that finished the last job, in case it hasn't let go of the mutex yet
+    // Copy/move constructors/operators are deleted; jobs hold a pointer to this
+    JobCounter() noexcept : m_Pending(0) {}
+    ~JobCounter() { std::lock_guard<std::mutex> lock(m_Mutex); }
+    JobCounter(JobCounter &&) = delete;
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator=(JobCounter &&) = delete;
+    JobCounter &operator=(const JobCounter &) = delete;
+
+    /////////////////////////////////////////////////
+    // Check if every job counted here has finished
+    //
+    // returns:
+    //      true if nothing is pending
+    bool isDone() const noexcept { return (m_Pending.load(std::memory_order_acquire) == 0); }
+
+    /////////////////////////////////////////////////
+    // Get the number of unfinished jobs
+    //
+    // returns:
+    //      the pending count
+    int32_t getPending() const noexcept {
+        int32_t pending = m_Pending.load(std::memory_order_acquire);
+        return (pending >= RELEASING) ? (pending - RELEASING) : pending;
+    }
+
+private:
+
+    friend class JobSystem;
+
+    // added in place of the last job's decrement while the waiting jobs are released, so nobody sees the counter
+    // done (and destroys it) before then; taken off again under m_Mutex
+    static constexpr int32_t RELEASING = 0x40000000;
+
+    std::atomic<int32_t> m_Pending;
+    std::mutex m_Mutex;     // guards m_Waiting
+    std::vector<std::pair<JobFunction, JobCounter *>> m_Waiting;  // jobs to submit once m_Pending hits 0
+};
+
+/////////////////////////////////////////////////
+//
+class JobSystem {
+public:
+
+    /////////////////////////////////////////////////
+    // Constructor creates a system with no workers; Submit() still works, and Wait() runs everything itself
+    // Destructor stops the workers
+    // Copy/move constructors/operators are deleted; the workers hold a pointer to this
+    JobSystem();
+    virtual ~JobSystem() { this->Destroy(); }
+    JobSystem(JobSystem &&) = delete;
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(JobSystem &&) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    /////////////////////////////////////////////////
+    // Start the worker threads
+    // Makes this the engine's job system (see getActive()); stops any workers already running first
+    //
+    // in:
+    //      workercount - number of worker threads; 0 picks one per hardware thread, minus the main thread
+    // returns:
+    //      the number of workers started
+    int32_t Initialize(int32_t workercount = 0);
+
+    /////////////////////////////////////////////////
+    // Run whatever is still queued, then stop the workers
+    //
+    // returns:
+    //      void
+    void Destroy();
+
+    /////////////////////////////////////////////////
+    // Queue a job
+    // Safe to call from any thread, including from inside a job
+    //
+    // in:
+    //      job - the work
+    //      counter - bumped now and dropped when the job finishes; may be nullptr
+    // returns:
+    //      void
+    void Submit(JobFunction job, JobCounter *counter = nullptr);
+
+    /////////////////////////////////////////////////
+    // Queue a job once another counter reaches zero
+    // If it's already zero, this is the same as Submit()
+    //
+    // in:
+    //      dependency - the counter to wait for
+    //      job - the work
+    //      counter - bumped now and dropped when the job finishes; may be nullptr
+    // returns:
+    //      void
+    void SubmitAfter(JobCounter &dependency, JobFunction job, JobCounter *counter = nullptr);
+
+    /////////////////////////////////////////////////
+    // Split [0, count) into batches and run them as jobs, waiting (and helping) until all are done
+    //
+    // in:
+    //      count - number of items
+    //      batchsize - items per job; 0 is treated as 1
+    //      job - called with [begin, end) for each batch
+    // returns:
+    //      void
+    void ParallelFor(std::size_t count, std::size_t batchsize, const std::function<void(std::size_t, std::size_t)> &job);
+
+    /////////////////////////////////////////////////
+    // Wait for a counter to reach zero, running queued jobs in the meantime
+    //
+    // in:
+    //      counter - the counter to wait for
+    // returns:
+    //      void
+    void Wait(const JobCounter &counter);
+
+    /////////////////////////////////////////////////
+    // Run one queued job on the calling thread, if there is one
+    //
+    // returns:
+    //      true if a job was run
+    bool RunOne();
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    int32_t getWorkerCount() const noexcept { return static_cast<int32_t>(m_Workers.size()); }
+    uint64_t getExecutedCount() const noexcept { return m_Executed.load(std::memory_order_relaxed); }
+    uint64_t getStolenCount() const noexcept { return m_Stolen.load(std::memory_order_relaxed); }
+
+    /////////////////////////////////////////////////
+    // Get the engine's job system, for subsystems that weren't handed one
+    //
+    // returns:
+    //      a pointer to the most recently initialized JobSystem, or nullptr if none is running
+    static JobSystem *getActive() noexcept { return ms_Active.load(std::memory_order_acquire); }
+
+private:
+
+    /////////////////////////////////////////////////
+    // A queued job and the counter to drop when it's done
+    struct Job {
+        JobFunction m_Function;
+        JobCounter *m_Counter;
+    };
+
+    /////////////////////////////////////////////////
+    // One thread's queue; the owner works at the back, thieves take from the front
+    struct alignas(ostrich::g_CacheLineSize) WorkQueue {
+        std::mutex m_Mutex;
+        std::deque<Job> m_Jobs;
+    };
+
+    /////////////////////////////////////////////////
+    // Get the queue the calling thread owns (0 for anything that isn't one of this system's workers)
+    //
+    // returns:
+    //      an index into m_Queues
+    std::size_t getQueueIndex() const noexcept;
+
+    /////////////////////////////////////////////////
+    // Queue a job on the calling thread's queue and wake a worker
+    //
+    // in:
+    //      job - the job; its counter has already been bumped
+    // returns:
+    //      void
+    void Push(Job job);
+
+    /////////////////////////////////////////////////
+    // Take a job: the newest from the given queue, or failing that the oldest from any other
+    //
+    // in:
+    //      index - the calling thread's queue
+    // out:
+    //      job - the job taken
+    // returns:
+    //      true if a job was taken
+    bool Take(std::size_t index, Job &job);
+
+    /////////////////////////////////////////////////
+    // Run a job, drop its counter, and release anything that was waiting on the counter
+    //
+    // in:
+    //      job - the job to run
+    // returns:
+    //      void
+    void Execute(Job &job);
+
+    /////////////////////////////////////////////////
+    // Worker thread body
+    //
+    // in:
+    //      index - the worker's queue
+    // returns:
+    //      void
+    void WorkerThread(std::size_t index);
+
+    static std::atomic<JobSystem *> ms_Active;
+
+    std::vector<std::unique_ptr<WorkQueue>> m_Queues;  // [0] for non-workers, then one per worker
+    std::vector<std::thread> m_Workers;
+
+    std::atomic<int64_t> m_Queued;      // jobs sitting in any queue
+    std::atomic<uint64_t> m_Executed;
+    std::atomic<uint64_t> m_Stolen;
+
+    std::mutex m_SleepMutex;
+    std::condition_variable m_Wake;
+    bool m_Stop;                        // guarded by m_SleepMutex
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_JOBSYSTEM_H_ */
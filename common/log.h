@@ -0,0 +1,106 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Log levels, categories and the OST_LOG_* macros
+
+Every log call has a severity level and a category (roughly, the subsystem it comes from).
+There are two filters:
+    - at build time, anything below g_LogCompileLevel is compiled out entirely: the arguments aren't
+      even evaluated. Debug builds keep everything; release builds start at LOG_INFO.
+    - at run time, the Console keeps a minimum level per category (see Console::setLogLevel())
+
+TRACE and DEBUG messages go to debug.log, INFO and WARNING to console.log,
+and ERROR to console.log with an immediate flush (see Console::ErrorMessage()).
+
+Use the macros rather than calling ConsolePrinter::LogMessage() directly, so the build-time filter applies:
+    OST_LOG_DEBUG(m_ConsolePrinter, ostrich::LogCategory::LOG_INPUT, OST_FORMAT(u8"Added % devices"), count);
+    OST_LOG_INFO(m_ConsolePrinter, ostrich::LogCategory::LOG_CORE, u8"Shutting down");
+==========================================
+*/
+
+#ifndef OSTRICH_LOG_H_
+#define OSTRICH_LOG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include "ost_common.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+// Severity, lowest first
+enum class LogLevel : int32_t {
+    LOG_TRACE = 0,  // per-event noise (every input event, every message)
+    LOG_DEBUG,      // developer diagnostics
+    LOG_INFO,       // normal console output
+    LOG_WARNING,    // something's off but the game carries on
+    LOG_ERROR,      // something failed
+    LOG_NONE        // as a filter level, turns a category off completely
+};
+
+/////////////////////////////////////////////////
+// Where a message comes from
+// Add new categories before LOG_MAXCATEGORY
+enum class LogCategory : int32_t {
+    LOG_CORE = 0,   // Main, startup and shutdown
+    LOG_EVENTS,     // event queue, dispatch, journal
+    LOG_INPUT,      // input handlers
+    LOG_DISPLAY,    // windowing and contexts
+    LOG_RENDERER,   // renderers and GPU resources
+    LOG_GAME,       // game-specific state
+    LOG_MAXCATEGORY
+};
+
+namespace log {
+
+/////////////////////////////////////////////////
+// Lowest level compiled into this build
+#if defined(OST_LOG_COMPILE_LEVEL)
+constexpr LogLevel g_LogCompileLevel = static_cast<LogLevel>(OST_LOG_COMPILE_LEVEL);
+#else
+constexpr LogLevel g_LogCompileLevel = g_DebugBuild ? LogLevel::LOG_TRACE : LogLevel::LOG_INFO;
+#endif
+
+/////////////////////////////////////////////////
+// Lowest level let through at run time until someone changes it
+// TRACE is compiled into debug builds but has to be asked for; it's a lot
+constexpr LogLevel g_LogDefaultLevel = g_DebugBuild ? LogLevel::LOG_DEBUG : LogLevel::LOG_INFO;
+
+constexpr std::size_t g_NumCategories = static_cast<std::size_t>(LogCategory::LOG_MAXCATEGORY);
+
+/////////////////////////////////////////////////
+// Check whether a level survives the build-time filter
+//
+// in:
+//      level - the level to check
+// returns:
+//      true if messages of that level are compiled in
+constexpr bool isCompiledIn(LogLevel level) noexcept {
+    return (static_cast<int32_t>(level) >= static_cast<int32_t>(g_LogCompileLevel));
+}
+
+} // namespace log
+
+} // namespace ostrich
+
+/////////////////////////////////////////////////
+// Log through a ConsolePrinter (or anything with isLogEnabled() and LogMessage())
+// The rest of the arguments are a plain string, or an OST_FORMAT() string and its arguments
+// Nothing after the category is evaluated unless the message will actually be written
+#define OST_LOG(printer, level, category, ...) \
+    do { \
+        if constexpr (ostrich::log::isCompiledIn(level)) { \
+            if ((printer).isLogEnabled((level), (category))) { \
+                (printer).LogMessage((level), (category), __VA_ARGS__); \
+            } \
+        } \
+    } while (false)
+
+#define OST_LOG_TRACE(printer, category, ...)   OST_LOG(printer, ostrich::LogLevel::LOG_TRACE, category, __VA_ARGS__)
+#define OST_LOG_DEBUG(printer, category, ...)   OST_LOG(printer, ostrich::LogLevel::LOG_DEBUG, category, __VA_ARGS__)
+#define OST_LOG_INFO(printer, category, ...)    OST_LOG(printer, ostrich::LogLevel::LOG_INFO, category, __VA_ARGS__)
+#define OST_LOG_WARNING(printer, category, ...) OST_LOG(printer, ostrich::LogLevel::LOG_WARNING, category, __VA_ARGS__)
+#define OST_LOG_ERROR(printer, category, ...)   OST_LOG(printer, ostrich::LogLevel::LOG_ERROR, category, __VA_ARGS__)
+
+#endif /* OSTRICH_LOG_H_ */
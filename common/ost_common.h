@@ -37,6 +37,10 @@ const char * const g_Whitespace = u8" \t\n\r";
 const int32_t g_ScreenWidth = 1920;
 const int32_t g_ScreenHeight = 1080;
 
+// size of a cache line on every platform we currently target (x86/x64 and ARMv7/v8)
+// used to pad data shared between threads so it doesn't false share
+constexpr std::size_t g_CacheLineSize = 64;
+
 const int32_t g_PlatformWindows = 1;
 const int32_t g_PlatformRaspi = 2;
 const int32_t g_PlatformLinux = 3;
@@ -0,0 +1,184 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Bounded lock-free multi-producer/single-consumer ring buffer
+
+Any number of threads may push; exactly one thread may pop.
+Each cell carries a sequence number so producers can claim a cell with a single CAS
+and the consumer can tell a published cell from one that's still being written.
+Based on Dmitry Vyukov's bounded MPMC queue, with the consumer side simplified since there's only one.
+
+Push fails (returns false) when the buffer is full rather than allocating or waiting.
+Pop never loops or waits, so it's safe to call from the main loop every frame.
+==========================================
+*/
+
+#ifndef OSTRICH_RINGBUFFER_H_
+#define OSTRICH_RINGBUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "ost_common.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+// T must be copy or move constructible; it does not need to be default constructible
+// CAPACITY must be a power of two
+template <typename T, std::size_t CAPACITY>
+class MPSCRingBuffer {
+public:
+
+    static_assert((CAPACITY >= 2) && ((CAPACITY & (CAPACITY - 1)) == 0), "MPSCRingBuffer capacity must be a power of two");
+
+    /////////////////////////////////////////////////
+    // Constructor seeds each cell's sequence number with its index
+    // Destructor destroys anything still in the buffer
+    // Copy/move constructors/operators are deleted; the atomics can't move and other threads may hold a pointer to this
+    MPSCRingBuffer() noexcept : m_Tail(0), m_Head(0) {
+        for (std::size_t i = 0; i < CAPACITY; i++) {
+            m_Cells[i].m_Sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    ~MPSCRingBuffer() { this->Clear(); }
+    MPSCRingBuffer(MPSCRingBuffer &&) = delete;
+    MPSCRingBuffer(const MPSCRingBuffer &) = delete;
+    MPSCRingBuffer &operator=(MPSCRingBuffer &&) = delete;
+    MPSCRingBuffer &operator=(const MPSCRingBuffer &) = delete;
+
+    /////////////////////////////////////////////////
+    // Copy an item into the back of the buffer
+    // Safe to call from any thread
+    //
+    // in:
+    //      item - the item to copy
+    // returns:
+    //      true if the item was added, false if the buffer was full
+    bool TryPush(const T &item) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        Cell *cell = this->ClaimCell();
+        if (cell == nullptr)
+            return false;
+
+        new (cell->m_Storage) T(item);
+        cell->m_Sequence.store(cell->m_Claimed + 1, std::memory_order_release);
+        return true;
+    }
+
+    /////////////////////////////////////////////////
+    // Remove the item at the front of the buffer
+    // Only the consumer thread may call this; wait-free
+    //
+    // returns:
+    //      An optional<> possibly containing the item
+    std::optional<T> TryPop() noexcept(std::is_nothrow_move_constructible_v<T>) {
+        std::size_t pos = m_Head.load(std::memory_order_relaxed);
+        Cell &cell = m_Cells[pos & MASK];
+        std::size_t seq = cell.m_Sequence.load(std::memory_order_acquire);
+
+        // the cell hasn't been published yet, either because it's empty or a producer is mid-write
+        if (seq != (pos + 1))
+            return std::nullopt;
+
+        T *item = std::launder(reinterpret_cast<T *>(cell.m_Storage));
+        std::optional<T> result(std::move(*item));
+        item->~T();
+
+        // hand the cell back to producers for the next lap around the buffer
+        cell.m_Sequence.store(pos + CAPACITY, std::memory_order_release);
+        m_Head.store(pos + 1, std::memory_order_release);
+        return result;
+    }
+
+    /////////////////////////////////////////////////
+    // Pop and destroy everything currently in the buffer
+    // Only the consumer thread may call this
+    //
+    // returns:
+    //      void
+    void Clear() noexcept {
+        while (this->TryPop().has_value()) {}
+    }
+
+    /////////////////////////////////////////////////
+    // Check if the buffer is (probably) empty
+    // Exact from the consumer's point of view; a snapshot from anywhere else
+    //
+    // returns:
+    //      true if there are no claimed cells
+    bool isEmpty() const noexcept { return (this->getSize() == 0); }
+
+    /////////////////////////////////////////////////
+    // Get the number of claimed cells
+    // Includes cells a producer is still writing, so treat it as an estimate
+    //
+    // returns:
+    //      The number of items in the buffer
+    std::size_t getSize() const noexcept {
+        std::size_t head = m_Head.load(std::memory_order_acquire);
+        std::size_t tail = m_Tail.load(std::memory_order_acquire);
+        return (tail >= head) ? (tail - head) : 0;
+    }
+
+    /////////////////////////////////////////////////
+    // Get the maximum number of items the buffer can hold
+    //
+    // returns:
+    //      CAPACITY
+    static constexpr std::size_t getCapacity() noexcept { return CAPACITY; }
+
+private:
+
+    static constexpr std::size_t MASK = CAPACITY - 1;
+
+    /////////////////////////////////////////////////
+    // A slot in the buffer
+    // m_Sequence == index: free for the producer on this lap
+    // m_Sequence == index + 1: published, ready for the consumer
+    // m_Claimed is only touched by the producer that claimed the cell
+    struct Cell {
+        std::atomic<std::size_t> m_Sequence;
+        std::size_t m_Claimed;
+        alignas(T) unsigned char m_Storage[sizeof(T)];
+    };
+
+    /////////////////////////////////////////////////
+    // Reserve the next free cell for a producer
+    //
+    // returns:
+    //      a pointer to the claimed cell, or nullptr if the buffer is full
+    Cell *ClaimCell() noexcept {
+        std::size_t pos = m_Tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell *cell = &m_Cells[pos & MASK];
+            std::size_t seq = cell->m_Sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (m_Tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell->m_Claimed = pos;
+                    return cell;
+                }
+                // lost the race; pos was refreshed by compare_exchange_weak
+            }
+            else if (diff < 0) {
+                return nullptr; // consumer hasn't freed this cell from the last lap
+            }
+            else {
+                pos = m_Tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // producers hammer the tail, the consumer owns the head; keep them on separate cache lines
+    alignas(ostrich::g_CacheLineSize) std::atomic<std::size_t> m_Tail;
+    alignas(ostrich::g_CacheLineSize) std::atomic<std::size_t> m_Head;
+    alignas(ostrich::g_CacheLineSize) Cell m_Cells[CAPACITY];
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_RINGBUFFER_H_ */
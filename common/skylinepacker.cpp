@@ -0,0 +1,102 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "skylinepacker.h"
+
+#include <algorithm>
+#include <limits>
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::SkylinePacker::SkylinePacker(int32_t width, int32_t height) :
+    m_Width(std::max(width, 1)), m_Height(std::max(height, 1)), m_UsedArea(0) {
+    this->Reset();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::SkylinePacker::Insert(int32_t width, int32_t height, int32_t &xpos, int32_t &ypos) {
+    if ((width <= 0) || (height <= 0))
+        return false;
+
+    std::size_t best = m_Skyline.size();
+    int32_t bestbottom = std::numeric_limits<int32_t>::max();
+    int32_t bestwidth = std::numeric_limits<int32_t>::max();
+    int32_t besttop = 0;
+    for (std::size_t i = 0; i < m_Skyline.size(); i++) {
+        int32_t top = this->Fit(i, width, height);
+        if (top < 0)
+            continue;
+        int32_t bottom = top + height;
+        if ((bottom < bestbottom) || ((bottom == bestbottom) && (m_Skyline[i].m_Width < bestwidth))) {
+            best = i;
+            bestbottom = bottom;
+            bestwidth = m_Skyline[i].m_Width;
+            besttop = top;
+        }
+    }
+    if (best == m_Skyline.size())
+        return false;
+
+    // the new segment is the rectangle's bottom edge; segments it covers shrink or go
+    Segment placed = { m_Skyline[best].m_X, bestbottom, width };
+    m_Skyline.insert(m_Skyline.begin() + static_cast<std::ptrdiff_t>(best), placed);
+    std::size_t next = best + 1;
+    while (next < m_Skyline.size()) {
+        Segment &segment = m_Skyline[next];
+        int32_t overlap = (placed.m_X + placed.m_Width) - segment.m_X;
+        if (overlap <= 0)
+            break;
+        if (overlap < segment.m_Width) {
+            segment.m_X += overlap;
+            segment.m_Width -= overlap;
+            break;
+        }
+        m_Skyline.erase(m_Skyline.begin() + static_cast<std::ptrdiff_t>(next));
+    }
+
+    // neighbours at the same height become one segment
+    for (std::size_t i = 0; (i + 1) < m_Skyline.size();) {
+        if (m_Skyline[i].m_Y == m_Skyline[i + 1].m_Y) {
+            m_Skyline[i].m_Width += m_Skyline[i + 1].m_Width;
+            m_Skyline.erase(m_Skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+        }
+        else {
+            i++;
+        }
+    }
+
+    m_UsedArea += static_cast<int64_t>(width) * static_cast<int64_t>(height);
+    xpos = placed.m_X;
+    ypos = besttop;
+    return true;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::SkylinePacker::Reset() {
+    m_Skyline.clear();
+    m_Skyline.push_back({ 0, 0, m_Width });
+    m_UsedArea = 0;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int32_t ostrich::SkylinePacker::Fit(std::size_t index, int32_t width, int32_t height) const {
+    if ((m_Skyline[index].m_X + width) > m_Width)
+        return -1;
+
+    // the rectangle has to clear every segment it spans, so its top goes at the lowest of them (y grows downward)
+    int32_t top = 0;
+    int32_t remaining = width;
+    for (std::size_t i = index; remaining > 0; i++) {
+        top = std::max(top, m_Skyline[i].m_Y);
+        if ((top + height) > m_Height)
+            return -1;
+        remaining -= m_Skyline[i].m_Width;
+    }
+    return top;
+}
@@ -0,0 +1,104 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Skyline rectangle packer
+
+Places rectangles in a fixed-size bin without overlapping, for building texture atlases.
+The bin fills from the top down, and its used area is tracked as a skyline: a left-to-right list of horizontal
+segments, each the bottom edge of everything packed above it. A new rectangle goes where its bottom edge would end
+up highest (the bottom-left rule, upside down), breaking ties by the narrowest segment so wide gaps stay free for
+wide rectangles. Space beneath an overhang is never reused, which wastes a little but keeps every insert linear in
+the segment count.
+
+Packs best when fed tallest rectangles first.
+==========================================
+*/
+
+#ifndef OSTRICH_SKYLINEPACKER_H_
+#define OSTRICH_SKYLINEPACKER_H_
+
+#include <cstdint>
+#include <vector>
+#include "ost_common.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+//
+class SkylinePacker {
+public:
+
+    /////////////////////////////////////////////////
+    // Constructor creates an empty bin
+    // Data is all simple or a vector, so copy/move constructors/operators are default
+    //
+    // in:
+    //      width, height - size of the bin
+    SkylinePacker(int32_t width, int32_t height);
+    virtual ~SkylinePacker() {}
+    SkylinePacker(SkylinePacker &&) = default;
+    SkylinePacker(const SkylinePacker &) = default;
+    SkylinePacker &operator=(SkylinePacker &&) = default;
+    SkylinePacker &operator=(const SkylinePacker &) = default;
+
+    /////////////////////////////////////////////////
+    // Find room for a rectangle and mark it used
+    //
+    // in:
+    //      width, height - size of the rectangle
+    // out:
+    //      xpos, ypos - top left corner of the space found; untouched if there wasn't any
+    // returns:
+    //      true if the rectangle fit
+    bool Insert(int32_t width, int32_t height, int32_t &xpos, int32_t &ypos);
+
+    /////////////////////////////////////////////////
+    // Empty the bin
+    //
+    // returns:
+    //      void
+    void Reset();
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    int32_t getWidth() const noexcept { return m_Width; }
+    int32_t getHeight() const noexcept { return m_Height; }
+    int64_t getUsedArea() const noexcept { return m_UsedArea; }
+
+    // the share of the bin covered by rectangles, from 0 to 1
+    double getOccupancy() const noexcept {
+        return static_cast<double>(m_UsedArea) / (static_cast<double>(m_Width) * static_cast<double>(m_Height));
+    }
+
+private:
+
+    /////////////////////////////////////////////////
+    // One flat piece of the skyline: from m_X to m_X + m_Width, everything above m_Y is used
+    struct Segment {
+        int32_t m_X;
+        int32_t m_Y;
+        int32_t m_Width;
+    };
+
+    /////////////////////////////////////////////////
+    // Work out where a rectangle would sit with its left edge at a segment
+    //
+    // in:
+    //      index - the segment
+    //      width, height - size of the rectangle
+    // returns:
+    //      the rectangle's top edge; -1 if it would run off the right or bottom of the bin
+    int32_t Fit(std::size_t index, int32_t width, int32_t height) const;
+
+    int32_t m_Width;
+    int32_t m_Height;
+    int64_t m_UsedArea;
+    std::vector<Segment> m_Skyline;   // ordered left to right, covering the whole width
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_SKYLINEPACKER_H_ */
@@ -0,0 +1,281 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "textureatlas.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include "filesystem.h"
+#include "skylinepacker.h"
+
+namespace {
+
+constexpr int g_ManifestVersion = 1;
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::TextureAtlas::Add(std::string_view name, const ostrich::Image &image) {
+    int32_t bytesperpixel = ostrich::Image::BytesPerPixel(image.getPixelFormat());
+    if (!image.isValid() || (bytesperpixel == 0) || (image.getWidth() <= 0) || (image.getHeight() <= 0))
+        return false;
+
+    // formats are only named by channel order; a 16-bit TGA still claims to be BGR
+    int64_t expected = static_cast<int64_t>(image.getWidth()) * image.getHeight() * bytesperpixel;
+    if (image.getDataSize() < expected)
+        return false;
+
+    if (m_Regions.find(name) != m_Regions.end())
+        return false;
+    for (const auto &queued : m_Queue) {
+        if (queued.m_Name == name)
+            return false;
+    }
+
+    m_Queue.push_back({ std::string(name), image });
+    return true;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::TextureAtlas::Build(int32_t pagesize, int32_t padding) {
+    if (m_Queue.empty())
+        return true;
+    padding = std::max(padding, 0);
+
+    // tallest first packs tightest on a skyline
+    std::vector<std::size_t> order(m_Queue.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](std::size_t left, std::size_t right) {
+        const Image &a = m_Queue[left].m_Image, &b = m_Queue[right].m_Image;
+        return ((a.getHeight() != b.getHeight()) ? (a.getHeight() > b.getHeight()) : (a.getWidth() > b.getWidth()));
+    });
+
+    struct Placement {
+        int32_t m_Page;
+        int32_t m_X;
+        int32_t m_Y;
+    };
+    std::vector<Placement> placements(m_Queue.size());
+    std::vector<SkylinePacker> packers;
+    for (std::size_t index : order) {
+        const Image &image = m_Queue[index].m_Image;
+        int32_t width = image.getWidth() + (padding * 2), height = image.getHeight() + (padding * 2);
+        if ((width > pagesize) || (height > pagesize))
+            return false;
+
+        // earlier pages get first refusal, so small images fill the gaps big ones left
+        Placement &placement = placements[index];
+        bool placed = false;
+        for (std::size_t page = 0; (page < packers.size()) && !placed; page++) {
+            placed = packers[page].Insert(width, height, placement.m_X, placement.m_Y);
+            placement.m_Page = static_cast<int32_t>(page);
+        }
+        if (!placed) {
+            packers.emplace_back(pagesize, pagesize);
+            packers.back().Insert(width, height, placement.m_X, placement.m_Y);
+            placement.m_Page = static_cast<int32_t>(packers.size() - 1);
+        }
+    }
+
+    // paint the pages
+    std::size_t firstpage = m_Pages.size();
+    std::size_t pagebytes = static_cast<std::size_t>(pagesize) * static_cast<std::size_t>(pagesize) * 4;
+    std::vector<std::unique_ptr<uint8_t[]>> pagedata;
+    for (std::size_t page = 0; page < packers.size(); page++) {
+        pagedata.emplace_back(new uint8_t[pagebytes]);
+        std::memset(pagedata.back().get(), 0, pagebytes);
+    }
+
+    float scale = 1.0f / static_cast<float>(pagesize);
+    for (std::size_t index = 0; index < m_Queue.size(); index++) {
+        const Queued &queued = m_Queue[index];
+        const Placement &placement = placements[index];
+        int32_t xpos = placement.m_X + padding, ypos = placement.m_Y + padding;
+        Blit(queued.m_Image, xpos, ypos, padding, pagesize, pagedata[static_cast<std::size_t>(placement.m_Page)].get());
+
+        Region region = {};
+        region.m_Page = static_cast<int32_t>(firstpage) + placement.m_Page;
+        region.m_X = xpos;
+        region.m_Y = ypos;
+        region.m_Width = queued.m_Image.getWidth();
+        region.m_Height = queued.m_Image.getHeight();
+        region.m_Left = static_cast<float>(xpos) * scale;
+        region.m_Top = static_cast<float>(ypos) * scale;
+        region.m_Right = static_cast<float>(xpos + region.m_Width) * scale;
+        region.m_Bottom = static_cast<float>(ypos + region.m_Height) * scale;
+        m_Regions[queued.m_Name] = region;
+        m_PixelsUsed += static_cast<int64_t>(region.m_Width) * region.m_Height;
+    }
+
+    for (auto &data : pagedata) {
+        m_Pages.push_back({ pagesize, pagesize, std::string(),
+            ostrich::Image::FromPixels(ostrich::PixelFormat::FORMAT_BGRA, pagesize, pagesize, std::move(data)) });
+        m_PixelsTotal += static_cast<int64_t>(pagesize) * pagesize;
+    }
+    m_Queue.clear();
+    return true;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::TextureAtlas::Save(const std::string &filename) {
+    std::filesystem::path manifestpath(filename);
+    std::string stem = manifestpath.stem().string();
+
+    // the pages first, so the manifest can name them
+    for (std::size_t page = 0; page < m_Pages.size(); page++) {
+        if (!m_Pages[page].m_Image.has_value())
+            continue;
+        std::filesystem::path pagepath = manifestpath;
+        pagepath.replace_filename(stem + u8"_" + std::to_string(page) + u8".tga");
+        if (!m_Pages[page].m_Image->SaveTGA(pagepath.string().c_str()))
+            return false;
+        m_Pages[page].m_Filename = pagepath.string();
+    }
+
+    ostrich::File file;
+    if (!file.Open(filename, ostrich::FileMode::OPEN_WRITETRUNCATE))
+        return false;
+    std::fstream &handle = file.getFStream();
+
+    handle << u8"atlas " << g_ManifestVersion << ost_char::g_NewLine;
+    for (const auto &page : m_Pages) {
+        if (page.m_Filename.empty())
+            return false;
+        handle << u8"page " << page.m_Width << u8" " << page.m_Height << u8" "
+            << std::filesystem::path(page.m_Filename).filename().string() << ost_char::g_NewLine;
+    }
+    for (const auto &[name, region] : m_Regions) {
+        handle << u8"region " << region.m_Page << u8" " << region.m_X << u8" " << region.m_Y << u8" "
+            << region.m_Width << u8" " << region.m_Height << u8" " << name << ost_char::g_NewLine;
+    }
+    return !handle.fail();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::TextureAtlas::Load(const std::string &filename) {
+    this->Clear();
+
+    ostrich::File file;
+    if (!file.Open(filename, ostrich::FileMode::OPEN_READONLY))
+        return false;
+    std::fstream &handle = file.getFStream();
+    std::filesystem::path directory = std::filesystem::path(filename).parent_path();
+
+    std::string line;
+    bool valid = static_cast<bool>(std::getline(handle, line));
+    if (valid) {
+        std::istringstream header(line);
+        std::string tag;
+        int version = 0;
+        valid = ((header >> tag >> version) && (tag == u8"atlas") && (version == g_ManifestVersion));
+    }
+
+    while (valid && std::getline(handle, line)) {
+        if (!line.empty() && (line.back() == '\r'))
+            line.pop_back();
+        if (line.empty())
+            continue;
+
+        std::istringstream fields(line);
+        std::string tag;
+        fields >> tag;
+        if (tag == u8"page") {
+            Page page = { 0, 0, std::string(), std::nullopt };
+            std::string pagefile;
+            fields >> page.m_Width >> page.m_Height >> std::ws;
+            std::getline(fields, pagefile);
+            valid = (!fields.bad() && (page.m_Width > 0) && (page.m_Height > 0) && !pagefile.empty());
+            page.m_Filename = (directory / pagefile).string();
+            m_Pages.push_back(std::move(page));
+            m_PixelsTotal += static_cast<int64_t>(m_Pages.back().m_Width) * m_Pages.back().m_Height;
+        }
+        else if (tag == u8"region") {
+            Region region = {};
+            std::string name;
+            fields >> region.m_Page >> region.m_X >> region.m_Y >> region.m_Width >> region.m_Height >> std::ws;
+            std::getline(fields, name);
+            valid = (!fields.bad() && !name.empty() && (region.m_Page >= 0) &&
+                (static_cast<std::size_t>(region.m_Page) < m_Pages.size()));
+            if (valid) {
+                const Page &page = m_Pages[static_cast<std::size_t>(region.m_Page)];
+                region.m_Left = static_cast<float>(region.m_X) / static_cast<float>(page.m_Width);
+                region.m_Top = static_cast<float>(region.m_Y) / static_cast<float>(page.m_Height);
+                region.m_Right = static_cast<float>(region.m_X + region.m_Width) / static_cast<float>(page.m_Width);
+                region.m_Bottom = static_cast<float>(region.m_Y + region.m_Height) / static_cast<float>(page.m_Height);
+                m_Regions[name] = region;
+                m_PixelsUsed += static_cast<int64_t>(region.m_Width) * region.m_Height;
+            }
+        }
+        else {
+            valid = false;
+        }
+    }
+
+    if (!valid)
+        this->Clear();
+    return valid;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::TextureAtlas::Clear() {
+    m_Pages.clear();
+    m_Regions.clear();
+    m_Queue.clear();
+    m_PixelsUsed = 0;
+    m_PixelsTotal = 0;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+const ostrich::TextureAtlas::Region *ostrich::TextureAtlas::Find(std::string_view name) const {
+    auto found = m_Regions.find(name);
+    return ((found != m_Regions.end()) ? &found->second : nullptr);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::TextureAtlas::ForEachRegion(const std::function<void(const std::string &, const Region &)> &visit) const {
+    for (const auto &[name, region] : m_Regions) {
+        visit(name, region);
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::TextureAtlas::Blit(const ostrich::Image &image, int32_t xpos, int32_t ypos, int32_t padding, int32_t pagewidth, uint8_t *pagedata) {
+    auto data = image.getData().lock();
+    const uint8_t *source = data.get();
+    int32_t width = image.getWidth(), height = image.getHeight();
+    int32_t bytesperpixel = ostrich::Image::BytesPerPixel(image.getPixelFormat());
+    bool redfirst = ((image.getPixelFormat() == ostrich::PixelFormat::FORMAT_RGB) ||
+        (image.getPixelFormat() == ostrich::PixelFormat::FORMAT_RGBA));
+
+    // every page pixel in the padded rectangle takes the nearest source pixel, which is the pixel itself inside
+    // the image and the closest edge pixel out in the padding
+    for (int32_t y = -padding; y < (height + padding); y++) {
+        const uint8_t *sourcerow = source + (static_cast<std::size_t>(std::clamp(y, 0, height - 1)) *
+            static_cast<std::size_t>(width) * static_cast<std::size_t>(bytesperpixel));
+        uint8_t *pagerow = pagedata + ((static_cast<std::size_t>(ypos + y) * static_cast<std::size_t>(pagewidth) +
+            static_cast<std::size_t>(xpos - padding)) * 4);
+        for (int32_t x = -padding; x < (width + padding); x++) {
+            const uint8_t *pixel = sourcerow + (static_cast<std::size_t>(std::clamp(x, 0, width - 1)) * static_cast<std::size_t>(bytesperpixel));
+            pagerow[0] = redfirst ? pixel[2] : pixel[0];
+            pagerow[1] = pixel[1];
+            pagerow[2] = redfirst ? pixel[0] : pixel[2];
+            pagerow[3] = (bytesperpixel == 4) ? pixel[3] : 0xFF;
+            pagerow += 4;
+        }
+    }
+}
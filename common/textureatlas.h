@@ -0,0 +1,198 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Texture atlas
+
+Packs many small images (tiles, digits, buttons) into a few large pages, so a renderer binds one texture for all
+of them instead of one each. Every image becomes a named region: which page it's on, where, and the texture
+coordinates to draw it with.
+
+Images go in with Add() and are packed by Build() with a SkylinePacker, tallest first. Build() can be called again
+after more Add()s; the new images go on new pages and the old pages are left alone, so regions never move.
+
+Each image is surrounded by padding filled with copies of its edge pixels. Filtering (or a mipmap level) that
+reaches past a region's edge then picks up more of the same image instead of its neighbour on the page.
+The texture coordinates cover only the image itself, never the padding.
+
+An atlas can be built offline with tools/atlasbuild and saved as a plain text manifest plus one TGA per page:
+    atlas 1
+    page <width> <height> <page file, relative to the manifest>
+    region <page> <x> <y> <width> <height> <name>
+Load() reads the manifest only; the page images are left for the renderer to load by file name, which lets its
+texture cache drop and re-load them like any other file.
+==========================================
+*/
+
+#ifndef OSTRICH_TEXTUREATLAS_H_
+#define OSTRICH_TEXTUREATLAS_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "image.h"
+#include "ost_common.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+//
+class TextureAtlas {
+public:
+
+    /////////////////////////////////////////////////
+    // Where one image ended up
+    struct Region {
+        int32_t m_Page;
+        int32_t m_X;        // in page pixels, padding not included
+        int32_t m_Y;
+        int32_t m_Width;
+        int32_t m_Height;
+        float m_Left;       // the same rectangle in texture coordinates, from 0 to 1
+        float m_Top;
+        float m_Right;
+        float m_Bottom;
+    };
+
+    static constexpr int32_t DEFAULT_PAGE_SIZE = 1024;
+    static constexpr int32_t DEFAULT_PADDING = 2;
+
+    /////////////////////////////////////////////////
+    // Constructor creates an empty atlas
+    // Data is all either simple or copyable (Images share their pixels), so copy/move constructors/operators are default
+    TextureAtlas() noexcept : m_PixelsUsed(0), m_PixelsTotal(0) {}
+    virtual ~TextureAtlas() {}
+    TextureAtlas(TextureAtlas &&) = default;
+    TextureAtlas(const TextureAtlas &) = default;
+    TextureAtlas &operator=(TextureAtlas &&) = default;
+    TextureAtlas &operator=(const TextureAtlas &) = default;
+
+    /////////////////////////////////////////////////
+    // Queue an image for the next Build()
+    //
+    // in:
+    //      name - what to call its region; must be unique in the atlas
+    //      image - an uncompressed image (RGB, RGBA, BGR or BGRA)
+    // returns:
+    //      false if the name is taken or the image is invalid or compressed
+    bool Add(std::string_view name, const Image &image);
+
+    /////////////////////////////////////////////////
+    // Pack every queued image onto new pages
+    //
+    // in:
+    //      pagesize - width and height of each page
+    //      padding - pixels of repeated edge around each image
+    // returns:
+    //      false if an image (with its padding) is bigger than a page; nothing is packed and the queue is kept
+    bool Build(int32_t pagesize = DEFAULT_PAGE_SIZE, int32_t padding = DEFAULT_PADDING);
+
+    /////////////////////////////////////////////////
+    // Write the manifest, and each built page as <manifest name without extension>_<page>.tga beside it
+    //
+    // in:
+    //      filename - path for the manifest
+    // returns:
+    //      true if everything was written
+    bool Save(const std::string &filename);
+
+    /////////////////////////////////////////////////
+    // Replace the atlas with one from a manifest written by Save()
+    // Pages are not loaded; use getPageFilename() to load them
+    //
+    // in:
+    //      filename - path to the manifest
+    // returns:
+    //      false if the file couldn't be read or is malformed, leaving the atlas empty
+    bool Load(const std::string &filename);
+
+    /////////////////////////////////////////////////
+    // Forget every page, region and queued image
+    //
+    // returns:
+    //      void
+    void Clear();
+
+    /////////////////////////////////////////////////
+    // Look up an image's region
+    //
+    // in:
+    //      name - the name it was added with
+    // returns:
+    //      the region; nullptr if there isn't one by that name (or it hasn't been built yet)
+    const Region *Find(std::string_view name) const;
+
+    /////////////////////////////////////////////////
+    // Go through every region, in name order
+    //
+    // in:
+    //      visit - called with each name and region
+    // returns:
+    //      void
+    void ForEachRegion(const std::function<void(const std::string &, const Region &)> &visit) const;
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    std::size_t getPageCount() const noexcept { return m_Pages.size(); }
+    std::size_t getRegionCount() const noexcept { return m_Regions.size(); }
+    std::size_t getQueuedCount() const noexcept { return m_Queue.size(); }
+
+    // a built page's pixels (BGRA); nullptr for pages read by Load()
+    const Image *getPage(std::size_t page) const noexcept
+    { return (((page < m_Pages.size()) && m_Pages[page].m_Image.has_value()) ? &(*m_Pages[page].m_Image) : nullptr); }
+
+    // the page's image file; empty for pages that were built and not saved
+    const std::string &getPageFilename(std::size_t page) const noexcept { return m_Pages.at(page).m_Filename; }
+
+    // the share of page area covered by images (padding not counted), from 0 to 1
+    double getOccupancy() const noexcept
+    { return ((m_PixelsTotal > 0) ? (static_cast<double>(m_PixelsUsed) / static_cast<double>(m_PixelsTotal)) : 0.0); }
+
+private:
+
+    /////////////////////////////////////////////////
+    // One page: its pixels if it was built here, its file if it was saved or loaded
+    struct Page {
+        int32_t m_Width;
+        int32_t m_Height;
+        std::string m_Filename;
+        std::optional<Image> m_Image;
+    };
+
+    /////////////////////////////////////////////////
+    // An image waiting for Build()
+    struct Queued {
+        std::string m_Name;
+        Image m_Image;
+    };
+
+    /////////////////////////////////////////////////
+    // Copy an image onto a page as BGRA, repeating its edge pixels out into the padding
+    //
+    // in:
+    //      image - the source image; already checked to be uncompressed
+    //      xpos, ypos - where its top left pixel goes on the page
+    //      padding - how far to repeat the edges
+    //      pagewidth - page width in pixels
+    // out:
+    //      pagedata - the page's pixels
+    // returns:
+    //      void
+    static void Blit(const Image &image, int32_t xpos, int32_t ypos, int32_t padding, int32_t pagewidth, uint8_t *pagedata);
+
+    std::vector<Page> m_Pages;
+    std::map<std::string, Region, std::less<>> m_Regions;
+    std::vector<Queued> m_Queue;
+    int64_t m_PixelsUsed;
+    int64_t m_PixelsTotal;
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_TEXTUREATLAS_H_ */
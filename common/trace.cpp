@@ -0,0 +1,184 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "trace.h"
+
+#include <chrono>
+#include <ostream>
+
+namespace {
+
+// how often the writer thread empties the ring
+constexpr int32_t g_WriteIntervalMS = 100;
+
+std::atomic<uint32_t> g_NextThreadID(1);
+
+/////////////////////////////////////////////////
+// A small id unique to the calling thread; the trace viewer draws one track per id
+uint32_t TraceThreadID() {
+    thread_local uint32_t threadid = g_NextThreadID.fetch_add(1, std::memory_order_relaxed);
+    return threadid;
+}
+
+/////////////////////////////////////////////////
+// Trace-event timestamps are in microseconds; keep the nanoseconds as a fraction
+void WriteMicroseconds(std::ostream &out, int64_t nanoseconds) {
+    if (nanoseconds < 0)
+        nanoseconds = 0;
+
+    int64_t fraction = nanoseconds % 1000;
+    out << (nanoseconds / 1000) << '.';
+    if (fraction < 100)
+        out << '0';
+    if (fraction < 10)
+        out << '0';
+    out << fraction;
+}
+
+/////////////////////////////////////////////////
+// Names are literals from our own code, but a stray quote or backslash would still break the whole file
+void WriteJSONString(std::ostream &out, const char *text) {
+    out << '"';
+    for (const char *c = text; *c != ost_char::g_Null; c++) {
+        if ((*c == '"') || (*c == '\\'))
+            out << '\\';
+        out << *c;
+    }
+    out << '"';
+}
+
+} // anonymous namespace
+
+std::atomic<ostrich::Tracer *> ostrich::Tracer::ms_Active(nullptr);
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::Tracer::Tracer() noexcept :
+    m_DroppedCount(0), m_isRecording(false), m_Start(ostrich::timer::clock::now()), m_Stop(false), m_WroteEvent(false) {
+
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::Tracer::Initialize(std::string_view filename) {
+    this->Destroy();
+
+    if (!m_TraceFile.Open(filename, ostrich::FileMode::OPEN_WRITETRUNCATE))
+        return false;
+
+    m_TraceFile.getFStream() << '[' << ost_char::g_NewLine;
+    m_WroteEvent = false;
+    m_DroppedCount.store(0, std::memory_order_relaxed);
+    m_Ring.Clear();
+    m_Stop = false;
+    m_Start = ostrich::timer::clock::now();
+
+    m_Writer = std::thread(&Tracer::WriterThread, this);
+    m_isRecording.store(true, std::memory_order_release);
+    ms_Active.store(this, std::memory_order_release);
+    return true;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::Tracer::Destroy() {
+    if (!m_Writer.joinable())
+        return;
+
+    Tracer *self = this;
+    ms_Active.compare_exchange_strong(self, nullptr, std::memory_order_acq_rel);
+    m_isRecording.store(false, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_Signal.notify_all();
+    m_Writer.join();
+
+    // pick up anything recorded while the writer was on its way out
+    this->Drain();
+    m_TraceFile.getFStream() << ost_char::g_NewLine << ']' << ost_char::g_NewLine;
+    m_TraceFile.Close();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::Tracer::Record(char phase, const char *name, int64_t timestamp, int64_t value) noexcept {
+    if (!m_isRecording.load(std::memory_order_relaxed))
+        return;
+
+    Event event{ name, timestamp, value, TraceThreadID(), phase };
+    if (!m_Ring.TryPush(event)) {
+        m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::Tracer::WriterThread() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for (;;) {
+        m_Signal.wait_for(lock, std::chrono::milliseconds(g_WriteIntervalMS), [this]() { return m_Stop; });
+        bool stop = m_Stop;
+        lock.unlock();
+
+        this->Drain();
+
+        if (stop) {
+            break;
+        }
+        lock.lock();
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::Tracer::Drain() {
+    if (!m_TraceFile.isOpen()) {
+        m_Ring.Clear();
+        return;
+    }
+
+    std::fstream &out = m_TraceFile.getFStream();
+    bool wrote = false;
+    for (auto event = m_Ring.TryPop(); event.has_value(); event = m_Ring.TryPop()) {
+        if (m_WroteEvent) {
+            out << ',' << ost_char::g_NewLine;
+        }
+
+        if (event->m_Phase == PHASE_METADATA) {
+            out << u8"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << event->m_ThreadID << u8",\"args\":{\"name\":";
+            WriteJSONString(out, event->m_Name);
+            out << u8"}}";
+        }
+        else {
+            out << u8"{\"name\":";
+            WriteJSONString(out, event->m_Name);
+            out << u8",\"ph\":\"" << event->m_Phase << u8"\",\"pid\":1,\"tid\":" << event->m_ThreadID << u8",\"ts\":";
+            WriteMicroseconds(out, event->m_Timestamp);
+
+            if (event->m_Phase == PHASE_COMPLETE) {
+                out << u8",\"dur\":";
+                WriteMicroseconds(out, event->m_Value);
+            }
+            else if (event->m_Phase == PHASE_COUNTER) {
+                out << u8",\"args\":{\"value\":" << event->m_Value << '}';
+            }
+            else if (event->m_Phase == PHASE_INSTANT) {
+                out << u8",\"s\":\"t\"";
+            }
+            out << '}';
+        }
+
+        m_WroteEvent = true;
+        wrote = true;
+    }
+
+    if (wrote) {
+        out.flush();
+    }
+}
@@ -0,0 +1,293 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Timeline tracing
+
+Records scoped timings, counters and instant markers with the thread that made them and a timer::clock timestamp,
+and writes them as Chrome trace-event JSON (load the file in chrome://tracing or ui.perfetto.dev).
+Like the Console, recording an event only copies it into a fixed ring; a background thread does the file I/O.
+
+The file is written in the trace-event "JSON array" form, which viewers accept without the closing bracket,
+so a trace from a run that crashed can still be opened.
+
+Use the macros rather than the Tracer directly; they do nothing until a Tracer is started, and
+nothing at all if OST_TRACE_DISABLED is defined:
+    OST_TRACE_SCOPE("UpdateState");
+    OST_TRACE_COUNTER("Messages per update", batch.size());
+Names must be string literals; only the pointer is recorded
+==========================================
+*/
+
+#ifndef OSTRICH_TRACE_H_
+#define OSTRICH_TRACE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include "datetime.h"
+#include "filesystem.h"
+#include "ringbuffer.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+// Collects trace events from any thread and streams them to a file
+// Only one Tracer records at a time; the macros find it through getActive()
+class Tracer {
+public:
+
+    /////////////////////////////////////////////////
+    // Number of events the ring holds between writes; anything past that is dropped and counted
+    static constexpr std::size_t EVENT_COUNT = 16384;
+
+    /////////////////////////////////////////////////
+    // Constructor creates an idle object; use Initialize() to start recording
+    // Destructor stops recording, writing anything still in the ring
+    // Copy/move constructors/operators are deleted; the writer thread and getActive() hold pointers to this
+    Tracer() noexcept;
+    virtual ~Tracer() { this->Destroy(); }
+    Tracer(Tracer &&) = delete;
+    Tracer(const Tracer &) = delete;
+    Tracer &operator=(Tracer &&) = delete;
+    Tracer &operator=(const Tracer &) = delete;
+
+    /////////////////////////////////////////////////
+    // Open the trace file and start recording
+    // Makes this the active Tracer; any previous recording by this object is finished first
+    //
+    // in:
+    //      filename - the file to write; truncated if it exists
+    // returns:
+    //      true if the file was opened and recording started
+    bool Initialize(std::string_view filename);
+
+    /////////////////////////////////////////////////
+    // Stop recording, write everything still in the ring and close the file
+    //
+    // returns:
+    //      void
+    void Destroy();
+
+    /////////////////////////////////////////////////
+    // Check if events are being recorded
+    //
+    // returns:
+    //      true between a successful Initialize() and Destroy()
+    bool isRecording() const noexcept { return m_isRecording.load(std::memory_order_relaxed); }
+
+    /////////////////////////////////////////////////
+    // Get the current time on the trace's timeline
+    //
+    // returns:
+    //      nanoseconds since Initialize()
+    int64_t getTimestamp() const noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(ostrich::timer::clock::now() - m_Start).count();
+    }
+
+    /////////////////////////////////////////////////
+    // Record a span of time on the calling thread
+    //
+    // in:
+    //      name - a string literal naming the span
+    //      start - getTimestamp() when the span started
+    //      finish - getTimestamp() when the span ended
+    // returns:
+    //      void
+    void Complete(const char *name, int64_t start, int64_t finish) noexcept { this->Record(PHASE_COMPLETE, name, start, finish - start); }
+
+    /////////////////////////////////////////////////
+    // Record the value of a counter; viewers draw each name as its own graph
+    //
+    // in:
+    //      name - a string literal naming the counter
+    //      value - the counter's value now
+    // returns:
+    //      void
+    void Counter(const char *name, int64_t value) noexcept { this->Record(PHASE_COUNTER, name, this->getTimestamp(), value); }
+
+    /////////////////////////////////////////////////
+    // Record a point in time on the calling thread
+    //
+    // in:
+    //      name - a string literal naming the marker
+    // returns:
+    //      void
+    void Instant(const char *name) noexcept { this->Record(PHASE_INSTANT, name, this->getTimestamp(), 0); }
+
+    /////////////////////////////////////////////////
+    // Give the calling thread a name in the viewer
+    //
+    // in:
+    //      name - a string literal naming the thread
+    // returns:
+    //      void
+    void NameThread(const char *name) noexcept { this->Record(PHASE_METADATA, name, 0, 0); }
+
+    /////////////////////////////////////////////////
+    // Get the number of events dropped because the ring was full
+    //
+    // returns:
+    //      The number of dropped events since Initialize()
+    uint64_t getDroppedCount() const noexcept { return m_DroppedCount.load(std::memory_order_relaxed); }
+
+    /////////////////////////////////////////////////
+    // Get the Tracer that's currently recording
+    //
+    // returns:
+    //      a pointer to the recording Tracer, or nullptr if nothing is recording
+    static Tracer *getActive() noexcept { return ms_Active.load(std::memory_order_acquire); }
+
+private:
+
+    /////////////////////////////////////////////////
+    // Chrome trace-event phases
+    static constexpr char PHASE_COMPLETE = 'X';
+    static constexpr char PHASE_COUNTER = 'C';
+    static constexpr char PHASE_INSTANT = 'i';
+    static constexpr char PHASE_METADATA = 'M';
+
+    /////////////////////////////////////////////////
+    // One recorded event
+    struct Event {
+        const char *m_Name;
+        int64_t m_Timestamp;    // nanoseconds since Initialize()
+        int64_t m_Value;        // duration in nanoseconds for spans, the value for counters
+        uint32_t m_ThreadID;
+        char m_Phase;
+    };
+
+    /////////////////////////////////////////////////
+    // Copy an event into the ring, if recording
+    //
+    // in:
+    //      phase - one of the PHASE_ constants
+    //      name - the event's name
+    //      timestamp - when it happened
+    //      value - duration or counter value
+    // returns:
+    //      void
+    void Record(char phase, const char *name, int64_t timestamp, int64_t value) noexcept;
+
+    /////////////////////////////////////////////////
+    // Writer thread body: drain the ring every so often until told to stop
+    //
+    // returns:
+    //      void
+    void WriterThread();
+
+    /////////////////////////////////////////////////
+    // Write everything currently in the ring to the trace file
+    // Only the writer thread may call this while it's running
+    //
+    // returns:
+    //      void
+    void Drain();
+
+    static std::atomic<Tracer *> ms_Active;
+
+    MPSCRingBuffer<Event, EVENT_COUNT> m_Ring;
+    std::atomic<uint64_t> m_DroppedCount;
+    std::atomic<bool> m_isRecording;
+    ostrich::timer::time_point m_Start;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Signal;
+    bool m_Stop;                // guarded by m_Mutex
+
+    std::thread m_Writer;
+    ostrich::File m_TraceFile;  // only the writer thread touches this while it's running
+    bool m_WroteEvent;          // writer thread only; whether the next event needs a separator
+};
+
+/////////////////////////////////////////////////
+// Times the enclosing scope on the active Tracer; use OST_TRACE_SCOPE()
+class TraceScope {
+public:
+
+    /////////////////////////////////////////////////
+    // Constructor notes the start time if a Tracer is recording
+    // Destructor records the span
+    // Copy/move constructors/operators are deleted; it only makes sense on the stack
+    explicit TraceScope(const char *name) noexcept :
+        m_Tracer(Tracer::getActive()), m_Name(name), m_Start((m_Tracer != nullptr) ? m_Tracer->getTimestamp() : 0) {}
+    ~TraceScope() { if (m_Tracer != nullptr) m_Tracer->Complete(m_Name, m_Start, m_Tracer->getTimestamp()); }
+    TraceScope(TraceScope &&) = delete;
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(TraceScope &&) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+
+    Tracer *m_Tracer;
+    const char *m_Name;
+    int64_t m_Start;
+};
+
+namespace trace {
+
+/////////////////////////////////////////////////
+// Record a counter on the active Tracer, if any; use OST_TRACE_COUNTER()
+//
+// in:
+//      name - a string literal naming the counter
+//      value - the counter's value now
+// returns:
+//      void
+inline void Counter(const char *name, int64_t value) noexcept {
+    Tracer *tracer = Tracer::getActive();
+    if (tracer != nullptr)
+        tracer->Counter(name, value);
+}
+
+/////////////////////////////////////////////////
+// Record an instant marker on the active Tracer, if any; use OST_TRACE_INSTANT()
+//
+// in:
+//      name - a string literal naming the marker
+// returns:
+//      void
+inline void Instant(const char *name) noexcept {
+    Tracer *tracer = Tracer::getActive();
+    if (tracer != nullptr)
+        tracer->Instant(name);
+}
+
+/////////////////////////////////////////////////
+// Name the calling thread on the active Tracer, if any; use OST_TRACE_THREAD()
+//
+// in:
+//      name - a string literal naming the thread
+// returns:
+//      void
+inline void NameThread(const char *name) noexcept {
+    Tracer *tracer = Tracer::getActive();
+    if (tracer != nullptr)
+        tracer->NameThread(name);
+}
+
+} // namespace trace
+
+} // namespace ostrich
+
+/////////////////////////////////////////////////
+// Tracing macros
+// u8"" name only compiles for string literals, which is what keeps recording down to a pointer copy
+#if !defined(OST_TRACE_DISABLED)
+#   define OST_TRACE_CONCAT_INNER(a, b) a##b
+#   define OST_TRACE_CONCAT(a, b) OST_TRACE_CONCAT_INNER(a, b)
+#   define OST_TRACE_SCOPE(name) ostrich::TraceScope OST_TRACE_CONCAT(ost_tracescope_, __LINE__)(u8"" name)
+#   define OST_TRACE_COUNTER(name, value) ostrich::trace::Counter(u8"" name, static_cast<int64_t>(value))
+#   define OST_TRACE_INSTANT(name) ostrich::trace::Instant(u8"" name)
+#   define OST_TRACE_THREAD(name) ostrich::trace::NameThread(u8"" name)
+#else
+#   define OST_TRACE_SCOPE(name) do {} while (false)
+#   define OST_TRACE_COUNTER(name, value) do {} while (false)
+#   define OST_TRACE_INSTANT(name) do {} while (false)
+#   define OST_TRACE_THREAD(name) do {} while (false)
+#endif
+
+#endif /* OSTRICH_TRACE_H_ */
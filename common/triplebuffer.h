@@ -0,0 +1,115 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Lock-free triple buffer
+
+Hands the latest version of some state from one producer thread to one consumer thread.
+The producer always has a buffer to write and the consumer always has a complete one to read;
+neither ever waits on the other. Versions the consumer was too slow to see are simply skipped.
+
+Three buffers: one being written (back), one being read (front), and the newest complete one (middle).
+Publishing swaps back and middle; acquiring swaps middle and front, if the middle holds something new.
+Both swaps are a single atomic exchange on the middle index.
+==========================================
+*/
+
+#ifndef OSTRICH_TRIPLEBUFFER_H_
+#define OSTRICH_TRIPLEBUFFER_H_
+
+#include <atomic>
+#include <cstdint>
+#include "ost_common.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+// T must be default constructible
+// The producer gets back whichever buffer it published two swaps ago, not its last write;
+// write the whole state every time rather than patching what's there
+template <typename T>
+class TripleBuffer {
+public:
+
+    /////////////////////////////////////////////////
+    // Constructor default constructs all three buffers; nothing is published yet
+    // Destructor is default
+    // Copy/move constructors/operators are deleted; both threads hold a pointer to this
+    TripleBuffer() : m_Middle(MIDDLE_START), m_Back(BACK_START), m_Front(FRONT_START) {}
+    ~TripleBuffer() = default;
+    TripleBuffer(TripleBuffer &&) = delete;
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(TripleBuffer &&) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    /////////////////////////////////////////////////
+    // Get the buffer to write the next version into
+    // Producer thread only
+    //
+    // returns:
+    //      a reference to the back buffer
+    T &getWriteBuffer() noexcept { return m_Buffers[m_Back].m_Value; }
+
+    /////////////////////////////////////////////////
+    // Make the back buffer the newest version and take a fresh one to write into
+    // Producer thread only
+    //
+    // returns:
+    //      void
+    void Publish() noexcept {
+        m_Back = m_Middle.exchange(m_Back | FLAG_FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /////////////////////////////////////////////////
+    // Swap in the newest version, if there's one the consumer hasn't seen
+    // Consumer thread only
+    //
+    // returns:
+    //      true if getReadBuffer() now refers to a newer version
+    bool Acquire() noexcept {
+        if ((m_Middle.load(std::memory_order_relaxed) & FLAG_FRESH) == 0)
+            return false;
+
+        m_Front = m_Middle.exchange(m_Front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /////////////////////////////////////////////////
+    // Get the version the consumer holds
+    // Consumer thread only; stays valid and unchanged until the next Acquire()
+    //
+    // returns:
+    //      a reference to the front buffer
+    const T &getReadBuffer() const noexcept { return m_Buffers[m_Front].m_Value; }
+
+    /////////////////////////////////////////////////
+    // Check if anything has been published since the consumer last acquired
+    // Safe to call from any thread, though it's only a snapshot
+    //
+    // returns:
+    //      true if the middle buffer holds an unseen version
+    bool hasFresh() const noexcept { return ((m_Middle.load(std::memory_order_relaxed) & FLAG_FRESH) != 0); }
+
+private:
+
+    static constexpr uint32_t INDEX_MASK = 0x03;
+    static constexpr uint32_t FLAG_FRESH = 0x04;
+    static constexpr uint32_t BACK_START = 0;
+    static constexpr uint32_t MIDDLE_START = 1;
+    static constexpr uint32_t FRONT_START = 2;
+
+    /////////////////////////////////////////////////
+    // Each buffer on its own cache lines, so writing the back doesn't slow down reading the front
+    struct alignas(ostrich::g_CacheLineSize) Slot {
+        T m_Value;
+    };
+
+    Slot m_Buffers[3];
+    alignas(ostrich::g_CacheLineSize) std::atomic<uint32_t> m_Middle;  // index of the middle buffer, plus FLAG_FRESH
+    alignas(ostrich::g_CacheLineSize) uint32_t m_Back;     // producer only
+    alignas(ostrich::g_CacheLineSize) uint32_t m_Front;    // consumer only
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_TRIPLEBUFFER_H_ */
@@ -26,6 +26,12 @@ std::size_t ostrich::utility::HashString(std::string_view target) {
     return std::hash<std::string_view>{}(target);
 }
 
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+std::size_t ostrich::utility::HashBytes(const void *data, std::size_t size) {
+    return std::hash<std::string_view>{}(std::string_view(static_cast<const char *>(data), size));
+}
+
 /////////////////////////////////////////////////
 // uses standard functionality that is deprecated in C++17
 // give me better standard library support and I will use it
@@ -33,6 +33,16 @@ namespace utility {
 //      a generated hash value for the contents of target
 std::size_t HashString(std::string_view target);
 
+/////////////////////////////////////////////////
+// Generate a hash value for a block of memory
+//
+// in:
+//      data - the bytes to hash
+//      size - number of bytes
+// returns:
+//      a generated hash value for the contents of data
+std::size_t HashBytes(const void *data, std::size_t size);
+
 /////////////////////////////////////////////////
 // UTF Conversion Functions
 /////////////////////////////////////////////////
@@ -0,0 +1,63 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "entityregistry.h"
+
+std::atomic<uint32_t> ostrich::EntityRegistry::ms_NextComponentType(0);
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::EntityHandle ostrich::EntityRegistry::Create() {
+    uint32_t index = 0;
+    if (!m_FreeIndices.empty()) {
+        index = m_FreeIndices.back();
+        m_FreeIndices.pop_back();
+    }
+    else {
+        index = static_cast<uint32_t>(m_Generations.size());
+        m_Generations.push_back(0);
+    }
+
+    m_AliveCount++;
+    return EntityHandle(index, m_Generations[index]);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::EntityRegistry::Destroy(ostrich::EntityHandle entity) {
+    if (!this->isAlive(entity))
+        return false;
+
+    uint32_t index = entity.getIndex();
+    for (auto &pool : m_Pools) {
+        if (pool) {
+            pool->Remove(index);
+        }
+    }
+
+    m_Generations[index]++;
+    m_FreeIndices.push_back(index);
+    m_AliveCount--;
+    return true;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::EntityRegistry::Clear() {
+    for (auto &pool : m_Pools) {
+        if (pool) {
+            pool->Clear();
+        }
+    }
+
+    // every index becomes free; reversed so Create() hands them out from 0 again
+    m_FreeIndices.clear();
+    for (uint32_t index = static_cast<uint32_t>(m_Generations.size()); index > 0; index--) {
+        m_Generations[index - 1]++;
+        m_FreeIndices.push_back(index - 1);
+    }
+    m_AliveCount = 0;
+}
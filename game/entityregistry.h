@@ -0,0 +1,387 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Entity registry (entity component system)
+
+An entity is just a handle: an index plus a generation. Destroying an entity bumps the generation stored
+for its index, so old handles to it stop working even after the index is reused for a new entity.
+
+State lives in components, which are plain structs. Each component type has its own pool (a sparse set):
+the components themselves are packed into one dense array, with a sparse array mapping entity index to
+dense position. Adding and removing is constant time, and a system iterating one component type walks a
+contiguous array with no virtual calls:
+
+    registry.Each<Position, Velocity>([](ostrich::EntityHandle, Position &pos, Velocity &vel) {
+        pos.m_X += vel.m_X;
+    });
+
+Each<> walks the pool of the first type listed and skips entities missing any of the others,
+so list the rarest component first.
+==========================================
+*/
+
+#ifndef OSTRICH_ENTITYREGISTRY_H_
+#define OSTRICH_ENTITYREGISTRY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "../common/error.h"
+#include "../common/ost_common.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+// Refers to an entity; default constructed handles refer to nothing
+class EntityHandle {
+public:
+
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+    /////////////////////////////////////////////////
+    // Constructors make null or specific handles
+    // Destructor is default
+    // Copy/move constructors/operators are default; it's two integers
+    constexpr EntityHandle() noexcept : m_Index(INVALID_INDEX), m_Generation(0) {}
+    constexpr EntityHandle(uint32_t index, uint32_t generation) noexcept : m_Index(index), m_Generation(generation) {}
+    ~EntityHandle() = default;
+    EntityHandle(EntityHandle &&) = default;
+    EntityHandle(const EntityHandle &) = default;
+    EntityHandle &operator=(EntityHandle &&) = default;
+    EntityHandle &operator=(const EntityHandle &) = default;
+
+    bool operator==(const EntityHandle &other) const noexcept { return (m_Index == other.m_Index) && (m_Generation == other.m_Generation); }
+    bool operator!=(const EntityHandle &other) const noexcept { return !(*this == other); }
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    bool isNull() const noexcept { return (m_Index == INVALID_INDEX); }
+    uint32_t getIndex() const noexcept { return m_Index; }
+    uint32_t getGeneration() const noexcept { return m_Generation; }
+
+private:
+
+    uint32_t m_Index;
+    uint32_t m_Generation;
+};
+
+/////////////////////////////////////////////////
+// What the registry needs from a pool without knowing its component type
+class IComponentPool {
+public:
+
+    /////////////////////////////////////////////////
+    // Empty constructor and destructor; interface has no data.
+    // Copy/move constructors/operators are deleted; the registry owns pools through pointers
+    IComponentPool() noexcept {}
+    virtual ~IComponentPool() {}
+    IComponentPool(IComponentPool &&) = delete;
+    IComponentPool(const IComponentPool &) = delete;
+    IComponentPool &operator=(IComponentPool &&) = delete;
+    IComponentPool &operator=(const IComponentPool &) = delete;
+
+    /////////////////////////////////////////////////
+    // Remove the component belonging to an entity index, if there is one
+    //
+    // in:
+    //      index - the entity's index
+    // returns:
+    //      void
+    virtual void Remove(uint32_t index) = 0;
+
+    /////////////////////////////////////////////////
+    // Remove every component, keeping the memory
+    //
+    // returns:
+    //      void
+    virtual void Clear() noexcept = 0;
+
+    /////////////////////////////////////////////////
+    // Get the number of components in the pool
+    //
+    // returns:
+    //      the dense array size
+    virtual std::size_t getSize() const noexcept = 0;
+};
+
+/////////////////////////////////////////////////
+// Sparse set of one component type
+// Removing swaps the last component into the gap, so pointers and dense positions don't survive a removal
+template <typename T>
+class ComponentPool final : public IComponentPool {
+public:
+
+    static constexpr uint32_t ABSENT = 0xFFFFFFFF;
+
+    /////////////////////////////////////////////////
+    // Constructor and destructor are default
+    // Copy/move constructors/operators are deleted (see IComponentPool)
+    ComponentPool() = default;
+    ~ComponentPool() = default;
+
+    /////////////////////////////////////////////////
+    // Give an entity this component, replacing the one it has
+    //
+    // in:
+    //      entity - the entity, assumed alive
+    //      value - the component
+    // returns:
+    //      a reference to the stored component, valid until the pool is next changed
+    T &Add(EntityHandle entity, T value) {
+        uint32_t index = entity.getIndex();
+        if (index >= m_Sparse.size()) {
+            m_Sparse.resize(index + 1, ABSENT);
+        }
+        if (m_Sparse[index] != ABSENT) {
+            m_Components[m_Sparse[index]] = std::move(value);
+            m_Entities[m_Sparse[index]] = entity;
+            return m_Components[m_Sparse[index]];
+        }
+
+        m_Sparse[index] = static_cast<uint32_t>(m_Components.size());
+        m_Entities.push_back(entity);
+        m_Components.push_back(std::move(value));
+        return m_Components.back();
+    }
+
+    /////////////////////////////////////////////////
+    // Remove the component belonging to an entity index, if there is one
+    //
+    // in:
+    //      index - the entity's index
+    // returns:
+    //      void
+    void Remove(uint32_t index) override {
+        if ((index >= m_Sparse.size()) || (m_Sparse[index] == ABSENT))
+            return;
+
+        uint32_t dense = m_Sparse[index];
+        uint32_t last = static_cast<uint32_t>(m_Components.size() - 1);
+        if (dense != last) {
+            m_Components[dense] = std::move(m_Components[last]);
+            m_Entities[dense] = m_Entities[last];
+            m_Sparse[m_Entities[dense].getIndex()] = dense;
+        }
+        m_Components.pop_back();
+        m_Entities.pop_back();
+        m_Sparse[index] = ABSENT;
+    }
+
+    /////////////////////////////////////////////////
+    // Remove every component, keeping the memory
+    //
+    // returns:
+    //      void
+    void Clear() noexcept override {
+        m_Sparse.assign(m_Sparse.size(), ABSENT);
+        m_Entities.clear();
+        m_Components.clear();
+    }
+
+    /////////////////////////////////////////////////
+    // Find the component belonging to an entity index
+    //
+    // in:
+    //      index - the entity's index
+    // returns:
+    //      a pointer to the component, or nullptr if the entity doesn't have one
+    T *Find(uint32_t index) noexcept {
+        if ((index >= m_Sparse.size()) || (m_Sparse[index] == ABSENT))
+            return nullptr;
+        return &m_Components[m_Sparse[index]];
+    }
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    std::size_t getSize() const noexcept override { return m_Components.size(); }
+
+    // the dense arrays; index i of each belongs together
+    T *getComponents() noexcept { return m_Components.data(); }
+    const T *getComponents() const noexcept { return m_Components.data(); }
+    const EntityHandle *getEntities() const noexcept { return m_Entities.data(); }
+
+private:
+
+    std::vector<uint32_t> m_Sparse;         // entity index -> position in the dense arrays, or ABSENT
+    std::vector<EntityHandle> m_Entities;   // dense: which entity each component belongs to
+    std::vector<T> m_Components;            // dense
+};
+
+/////////////////////////////////////////////////
+//
+class EntityRegistry {
+public:
+
+    /////////////////////////////////////////////////
+    // Constructor starts with no entities and no pools
+    // Destructor is default
+    // Copy/move constructors/operators are deleted; handles are only meaningful to the registry that made them
+    EntityRegistry() noexcept : m_AliveCount(0) {}
+    ~EntityRegistry() = default;
+    EntityRegistry(EntityRegistry &&) = delete;
+    EntityRegistry(const EntityRegistry &) = delete;
+    EntityRegistry &operator=(EntityRegistry &&) = delete;
+    EntityRegistry &operator=(const EntityRegistry &) = delete;
+
+    /////////////////////////////////////////////////
+    // Create an entity with no components
+    //
+    // returns:
+    //      a handle to the new entity
+    EntityHandle Create();
+
+    /////////////////////////////////////////////////
+    // Destroy an entity and all of its components
+    // Its handle (and any copies) stop being alive; the index is reused by a later Create()
+    //
+    // in:
+    //      entity - the entity to destroy
+    // returns:
+    //      true if it was alive
+    bool Destroy(EntityHandle entity);
+
+    /////////////////////////////////////////////////
+    // Destroy every entity, keeping the memory of every pool
+    //
+    // returns:
+    //      void
+    void Clear();
+
+    /////////////////////////////////////////////////
+    // Check if a handle refers to a living entity
+    //
+    // in:
+    //      entity - the handle to check
+    // returns:
+    //      true if it was created and hasn't been destroyed since
+    bool isAlive(EntityHandle entity) const noexcept {
+        return ((entity.getIndex() < m_Generations.size()) && (m_Generations[entity.getIndex()] == entity.getGeneration()));
+    }
+
+    /////////////////////////////////////////////////
+    // Give an entity a component, replacing the one it has
+    // Throws an ostrich::Exception if the entity isn't alive
+    //
+    // in:
+    //      entity - the entity
+    //      value - the component
+    // returns:
+    //      a reference to the stored component, valid until that component type's pool is next changed
+    template <typename T>
+    T &AddComponent(EntityHandle entity, T value) {
+        if (!this->isAlive(entity))
+            throw ostrich::Exception(u8"Adding a component to an entity that isn't alive");
+        return this->getPool<T>().Add(entity, std::move(value));
+    }
+
+    /////////////////////////////////////////////////
+    // Take a component away from an entity, if it has one
+    //
+    // in:
+    //      entity - the entity
+    // returns:
+    //      void
+    template <typename T>
+    void RemoveComponent(EntityHandle entity) {
+        if (this->isAlive(entity)) {
+            this->getPool<T>().Remove(entity.getIndex());
+        }
+    }
+
+    /////////////////////////////////////////////////
+    // Find one of an entity's components
+    //
+    // in:
+    //      entity - the entity
+    // returns:
+    //      a pointer to the component, or nullptr if the entity isn't alive or doesn't have one
+    template <typename T>
+    T *getComponent(EntityHandle entity) {
+        if (!this->isAlive(entity))
+            return nullptr;
+        return this->getPool<T>().Find(entity.getIndex());
+    }
+
+    /////////////////////////////////////////////////
+    // Run a function on every entity that has all of the listed components
+    // The function must not add or remove components of the listed types, or destroy entities
+    //
+    // in:
+    //      function - called as function(EntityHandle, First &, Rest &...)
+    // returns:
+    //      void
+    template <typename First, typename... Rest, typename Function>
+    void Each(Function &&function) {
+        this->EachIn(function, this->getPool<First>(), this->getPool<Rest>()...);
+    }
+
+    /////////////////////////////////////////////////
+    // Get the pool for a component type, creating it if this is the first use
+    // For systems that want the dense arrays directly
+    //
+    // returns:
+    //      a reference to the pool
+    template <typename T>
+    ComponentPool<T> &getPool() {
+        uint32_t type = getComponentType<T>();
+        if (type >= m_Pools.size()) {
+            m_Pools.resize(type + 1);
+        }
+        if (!m_Pools[type]) {
+            m_Pools[type] = std::make_unique<ComponentPool<T>>();
+        }
+        return static_cast<ComponentPool<T> &>(*m_Pools[type]);
+    }
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    std::size_t getAliveCount() const noexcept { return m_AliveCount; }
+
+private:
+
+    /////////////////////////////////////////////////
+    // Each() once the pools have been looked up: walk the first pool's dense arrays, finding the rest by entity index
+    template <typename Function, typename First, typename... Rest>
+    void EachIn(Function &function, ComponentPool<First> &first, ComponentPool<Rest> &...rest) {
+        std::size_t count = first.getSize();
+        First *components = first.getComponents();
+        const EntityHandle *entities = first.getEntities();
+        for (std::size_t i = 0; i < count; i++) {
+            auto found = std::make_tuple(rest.Find(entities[i].getIndex())...);
+            bool hasall = std::apply([](auto *...pointers) { return (true && ... && (pointers != nullptr)); }, found);
+            if (hasall) {
+                std::apply([&](auto *...pointers) { function(entities[i], components[i], *pointers...); }, found);
+            }
+        }
+    }
+
+    /////////////////////////////////////////////////
+    // Get a small number unique to a component type, for indexing m_Pools
+    template <typename T>
+    static uint32_t getComponentType() {
+        static const uint32_t type = ms_NextComponentType++;
+        return type;
+    }
+
+    static std::atomic<uint32_t> ms_NextComponentType;
+
+    std::vector<uint32_t> m_Generations;    // current generation of each index
+    std::vector<uint32_t> m_FreeIndices;    // destroyed indices, waiting to be reused
+    std::size_t m_AliveCount;
+
+    std::vector<std::unique_ptr<IComponentPool>> m_Pools;  // indexed by getComponentType()
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_ENTITYREGISTRY_H_ */
@@ -78,14 +78,26 @@ Using good ol' defines because enums might by type safe but also I don't care
 #define OST_ERROR_GL4VERSION            (OST_ERROR_GL4+0x02) // GL - retrieved OpenGL version unsupported
 #define OST_ERROR_GLSHADERVERSION       (OST_ERROR_GL4+0x03) // GL - OpenGL Shading Language version unsupported
 #define OST_ERROR_GL4COREGETPROCADDR    (OST_ERROR_GL4+0x04) // GL - Failed to load a core OpenGL 4 function pointer
+#define OST_ERROR_GL4SHADERLOAD         (OST_ERROR_GL4+0x05) // GL - unable to read a shader source file
+#define OST_ERROR_GL4SHADERCOMPILE      (OST_ERROR_GL4+0x06) // GL - a shader failed to compile
+#define OST_ERROR_GL4SHADERLINK         (OST_ERROR_GL4+0x07) // GL - a shader program failed to link
+#define OST_ERROR_GL4BUFFER             (OST_ERROR_GL4+0x08) // GL - unable to create a buffer or vertex array object
 
 // Renderer - OpenGL ES2
 #define OST_ERROR_ES2                   0x0000'0700 // start of OpenGL ES2 renderer errors
 #define OST_ERROR_ES2GETSTRING          (OST_ERROR_ES2+0x01) // ES2 - call to glGetString() failed
 #define OST_ERROR_ES2VERSION            (OST_ERROR_ES2+0x02) // ES2 - retrieved OpenGL ES version unsupported
 #define OST_ERROR_ES2SHADERVERSION      (OST_ERROR_ES2+0x03) // ES2 - OpenGL ES Shading Language version unsupported
+#define OST_ERROR_ES2SHADERLOAD         (OST_ERROR_ES2+0x04) // ES2 - unable to read a shader source file
+#define OST_ERROR_ES2SHADERCOMPILE      (OST_ERROR_ES2+0x05) // ES2 - a shader failed to compile
+#define OST_ERROR_ES2SHADERLINK         (OST_ERROR_ES2+0x06) // ES2 - a shader program failed to link
+#define OST_ERROR_ES2TEXTURE            (OST_ERROR_ES2+0x07) // ES2 - unable to create a texture
 
 // State machine
 #define OST_ERROR_STATEMACHINE 0x0000'00900 // start of state machine errors
 
+// Journal replay
+#define OST_ERROR_REPLAY        0x0000'0A00 // start of journal replay errors
+#define OST_ERROR_REPLAYLOAD    (OST_ERROR_REPLAY+0x01) // unable to open or read the journal to replay
+
 #endif /* OSTRICH_ERRORCODES_H_ */
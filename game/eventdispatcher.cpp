@@ -0,0 +1,73 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "eventdispatcher.h"
+
+#include <cstdint>
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::EventDispatcher::Subscribe(ostrich::Message::Type type, Handler handler) {
+    std::size_t index = static_cast<std::size_t>(type);
+    if ((index < NUM_TYPES) && handler) {
+        m_Table[index].push_back(std::move(handler));
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::EventDispatcher::Clear() {
+    for (auto &handlers : m_Table) {
+        handlers.clear();
+    }
+    m_Pending.clear();
+    m_Unhandled = nullptr;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::EventDispatcher::Collect(const ostrich::Message &msg) {
+    m_Pending.push_back(msg);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::EventDispatcher::Dispatch() {
+    bool done = false;
+    std::size_t first = 0;
+    while ((first < m_Pending.size()) && !done) {
+        // getTypeAsInt() so a damaged replayed type can't index past the table
+        int32_t type = m_Pending[first].getTypeAsInt();
+        std::size_t last = first + 1;
+        while ((last < m_Pending.size()) && (m_Pending[last].getTypeAsInt() == type)) {
+            last++;
+        }
+
+        std::size_t index = static_cast<std::size_t>(static_cast<uint32_t>(type));
+        if ((index < NUM_TYPES) && !m_Table[index].empty()) {
+            done = Deliver(m_Table[index], &m_Pending[first], last - first);
+        }
+        else if (m_Unhandled) {
+            done = m_Unhandled(&m_Pending[first], last - first);
+        }
+        first = last;
+    }
+    m_Pending.clear();
+
+    return done;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::EventDispatcher::Deliver(const std::vector<Handler> &handlers, const ostrich::Message *msgs, std::size_t count) {
+    bool done = false;
+    for (const auto &handler : handlers) {
+        if (handler(msgs, count)) {
+            done = true;
+        }
+    }
+    return done;
+}
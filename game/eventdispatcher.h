@@ -0,0 +1,116 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+EventDispatcher - routes popped Messages to whoever subscribed to their type
+
+Subscriptions live in a flat table indexed by Message::Type, so finding a handler is a single lookup.
+Messages are collected as they're popped and delivered once per update, in the order they arrived: each run of
+consecutive messages of one type goes to that type's handlers as a single batch. Types are never reordered, so a
+click is still handled against the mouse position that came before it, not one that came after.
+==========================================
+*/
+
+#ifndef OSTRICH_EVENTDISPATCHER_H_
+#define OSTRICH_EVENTDISPATCHER_H_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "message.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+//
+class EventDispatcher {
+public:
+
+    /////////////////////////////////////////////////
+    // A batch handler
+    //
+    // in:
+    //      msgs - pointer to the first Message of the batch; all share one type
+    //      count - number of Messages in the batch (never 0)
+    // returns:
+    //      true if the game should stop running (is "done"); delivery stops after the current batch
+    using Handler = std::function<bool(const Message *msgs, std::size_t count)>;
+
+    /////////////////////////////////////////////////
+    // Number of slots in the table; one per possible Message::Type
+    static constexpr std::size_t NUM_TYPES = static_cast<std::size_t>(Message::Type::MAXTYPES);
+
+    /////////////////////////////////////////////////
+    // Constructor is effectively default; all data has default constructors
+    // Destructor can do nothing because all data has its own destructors
+    // Copy/move constructors/operators are deleted; handlers usually capture pointers to their owners
+    EventDispatcher() noexcept { }
+    virtual ~EventDispatcher() { }
+    EventDispatcher(EventDispatcher &&) = delete;
+    EventDispatcher(const EventDispatcher &) = delete;
+    EventDispatcher &operator=(EventDispatcher &&) = delete;
+    EventDispatcher &operator=(const EventDispatcher &) = delete;
+
+    /////////////////////////////////////////////////
+    // Add a handler for a type of Message
+    // A type may have any number of handlers; they're called in the order they subscribed
+    // Don't subscribe from inside a handler
+    //
+    // in:
+    //      type - the Message type to receive
+    //      handler - the function to call with each batch of that type
+    // returns:
+    //      void
+    void Subscribe(Message::Type type, Handler handler);
+
+    /////////////////////////////////////////////////
+    // Set the handler for Messages that nobody subscribed to (or with a type out of range)
+    //
+    // in:
+    //      handler - the function to call; an empty function drops them silently
+    // returns:
+    //      void
+    void setUnhandled(Handler handler) { m_Unhandled = std::move(handler); }
+
+    /////////////////////////////////////////////////
+    // Remove every handler and anything waiting to be delivered
+    //
+    // returns:
+    //      void
+    void Clear();
+
+    /////////////////////////////////////////////////
+    // Hold a Message for the next Dispatch()
+    //
+    // in:
+    //      msg - the Message to deliver
+    // returns:
+    //      void
+    void Collect(const Message &msg);
+
+    /////////////////////////////////////////////////
+    // Deliver everything collected since the last call in arrival order, one batch per run of a single type
+    // Anything left undelivered because a handler asked to stop is discarded
+    //
+    // returns:
+    //      true if a handler reported the game should stop running
+    bool Dispatch();
+
+private:
+
+    /////////////////////////////////////////////////
+    // Hand a batch to a list of handlers
+    //
+    // returns:
+    //      true if any handler reported the game should stop running
+    static bool Deliver(const std::vector<Handler> &handlers, const Message *msgs, std::size_t count);
+
+    std::array<std::vector<Handler>, NUM_TYPES> m_Table;
+    std::vector<Message> m_Pending;     // in arrival order; keeps its capacity, so steady-state collection doesn't allocate
+    Handler m_Unhandled;
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_EVENTDISPATCHER_H_ */
@@ -0,0 +1,186 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "eventjournal.h"
+
+#include <chrono>
+#include <cstring>
+#include "../common/datetime.h"
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::journal::Record ostrich::journal::MakeRecord(const ostrich::Message &msg, uint32_t updatetick) noexcept {
+    ostrich::journal::Record record = { };
+    record.m_Timestamp = msg.getTimestamp();
+    record.m_Type = msg.getTypeAsInt();
+    record.m_Data1 = msg.getData1();
+    record.m_Data2 = msg.getData2();
+    record.m_UpdateTick = updatetick;
+
+    const char *sender = msg.getSender();
+    if (sender != nullptr) {
+        // record was zeroed, so the last byte stays null
+        std::strncpy(record.m_Sender, sender, ostrich::journal::g_SenderLength - 1);
+    }
+
+    return record;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::journal::ReadHeader(std::istream &handle, ostrich::journal::FileHeader &header) {
+    handle.read(reinterpret_cast<char *>(&header), sizeof(header));
+    return ((handle.gcount() == sizeof(header)) &&
+            (header.m_FileCode == ostrich::journal::g_FileCode) &&
+            (header.m_Version == ostrich::journal::g_Version) &&
+            (header.m_RecordSize == sizeof(ostrich::journal::Record)));
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::journal::FormatEntry(std::string &target, std::string_view timestamp, int32_t type, int32_t data1, int32_t data2, std::string_view sender) {
+    target = u8"[";
+    target += timestamp;
+    target += u8"] Message type >";
+    target += std::to_string(type);
+    target += u8"< Data1: >";
+    target += std::to_string(data1);
+    target += u8"< Data2: >";
+    target += std::to_string(data2);
+    target += u8"< Sender: >";
+    target += sender;
+    target += u8"<";
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::EventJournal::EventJournal() noexcept :
+    m_ActiveBlock(0), m_PendingBlock(NO_BLOCK), m_Stop(false) {
+
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::EventJournal::Open(std::string_view filename) {
+    this->Close();
+
+    if (!m_File.Open(filename, ostrich::FileMode::OPEN_WRITETRUNCATE)) {
+        return false;
+    }
+
+    ostrich::journal::FileHeader header = { };
+    header.m_FileCode = ostrich::journal::g_FileCode;
+    header.m_Version = ostrich::journal::g_Version;
+    header.m_RecordSize = sizeof(ostrich::journal::Record);
+    header.m_AnchorTick = ostrich::timer::ticks();
+    header.m_AnchorTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::fstream &handle = m_File.getFStream();
+    handle.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (handle.fail()) {
+        m_File.Close();
+        return false;
+    }
+
+    if (!m_Blocks) {
+        m_Blocks = std::make_unique<Block[]>(2);
+    }
+    m_Blocks[0].m_Count = 0;
+    m_Blocks[1].m_Count = 0;
+    m_ActiveBlock = 0;
+    m_PendingBlock = NO_BLOCK;
+    m_Stop = false;
+
+    m_Writer = std::thread(&EventJournal::WriterThread, this);
+    return true;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::EventJournal::Close() {
+    if (!this->isOpen())
+        return;
+
+    if (m_Blocks[m_ActiveBlock].m_Count > 0) {
+        this->Submit(true);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_Signal.notify_all();
+    m_Writer.join();
+
+    m_File.Close();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::EventJournal::Append(const ostrich::Message &msg, uint32_t updatetick) {
+    if (!this->isOpen())
+        return;
+
+    Block &block = m_Blocks[m_ActiveBlock];
+    block.m_Records[block.m_Count] = ostrich::journal::MakeRecord(msg, updatetick);
+    block.m_Count++;
+
+    if (block.m_Count >= BLOCK_RECORDS) {
+        this->Submit(true);
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::EventJournal::Flush() {
+    if (this->isOpen() && (m_Blocks[m_ActiveBlock].m_Count > 0)) {
+        this->Submit(false);
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::EventJournal::Submit(bool wait) {
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        if (m_PendingBlock != NO_BLOCK) {
+            if (!wait) {
+                return false;
+            }
+            m_Signal.wait(lock, [this]() { return (m_PendingBlock == NO_BLOCK); });
+        }
+        m_PendingBlock = m_ActiveBlock;
+    }
+    m_Signal.notify_all();
+
+    // the writer just finished with the other block, so it's safe to refill
+    m_ActiveBlock ^= 1;
+    m_Blocks[m_ActiveBlock].m_Count = 0;
+    return true;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::EventJournal::WriterThread() {
+    std::fstream &handle = m_File.getFStream();
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for (;;) {
+        m_Signal.wait(lock, [this]() { return ((m_PendingBlock != NO_BLOCK) || m_Stop); });
+        if (m_PendingBlock == NO_BLOCK) {
+            break; // stopping with nothing left to write
+        }
+
+        const Block &block = m_Blocks[m_PendingBlock];
+        lock.unlock();
+        handle.write(reinterpret_cast<const char *>(block.m_Records), block.m_Count * sizeof(block.m_Records[0]));
+        handle.flush();
+        lock.lock();
+
+        m_PendingBlock = NO_BLOCK;
+        m_Signal.notify_all();
+    }
+}
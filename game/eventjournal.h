@@ -0,0 +1,211 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Binary event journal
+
+Every Message popped from the EventQueue becomes a fixed-size 64-byte Record.
+Records are appended to one of two in-memory blocks; when a block fills (or at a frame boundary)
+it's handed to a background thread that writes it to disk while the other block keeps filling.
+The main loop never touches the file.
+
+File layout: one FileHeader followed by Records until end of file.
+tools/journaldump.cpp turns a journal back into the plain-text message.log format.
+==========================================
+*/
+
+#ifndef OSTRICH_EVENTJOURNAL_H_
+#define OSTRICH_EVENTJOURNAL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "message.h"
+#include "../common/filesystem.h"
+
+namespace ostrich {
+
+namespace journal {
+
+/////////////////////////////////////////////////
+// file format constants
+constexpr uint32_t g_FileCode = 0x4A54534F; // "OSTJ"
+constexpr uint32_t g_Version = 2;
+constexpr std::size_t g_SenderLength = 40;  // including the null; longer senders are truncated
+
+/////////////////////////////////////////////////
+// Written once at the start of the file
+// The anchor pair maps record timestamps (steady clock ticks) back onto wall-clock time
+struct FileHeader {
+    uint32_t m_FileCode;    // g_FileCode
+    uint32_t m_Version;     // g_Version
+    uint32_t m_RecordSize;  // sizeof(Record), as a sanity check
+    uint32_t m_Reserved;
+    int64_t m_AnchorTick;   // timer::ticks() when the file was opened
+    int64_t m_AnchorTime;   // system clock when the file was opened, in nanoseconds since the Unix epoch
+};
+
+/////////////////////////////////////////////////
+// One journaled Message
+// All fields are fixed width so the file reads back the same on every platform we support
+struct Record {
+    int64_t m_Timestamp;    // Message timestamp (timer::ticks())
+    int32_t m_Type;
+    int32_t m_Data1;
+    int32_t m_Data2;
+    uint32_t m_UpdateTick;  // fixed-timestep update that popped the Message; what replay keys on
+    char m_Sender[g_SenderLength];
+};
+
+static_assert(sizeof(FileHeader) == 32, "journal FileHeader layout changed");
+static_assert(sizeof(Record) == 64, "journal Record layout changed");
+
+/////////////////////////////////////////////////
+// Build a Record from a Message
+//
+// in:
+//      msg - the Message to record
+//      updatetick - the fixed-timestep update the Message was popped in
+// returns:
+//      A filled Record; the sender is copied and truncated if necessary
+Record MakeRecord(const Message &msg, uint32_t updatetick) noexcept;
+
+/////////////////////////////////////////////////
+// Read and validate a journal header
+//
+// in:
+//      handle - a stream positioned at the start of a journal file
+// out:
+//      header - the header read from the file
+// returns:
+//      true if the header was read and matches this version of the format
+bool ReadHeader(std::istream &handle, FileHeader &header);
+
+/////////////////////////////////////////////////
+// Format a journal entry the way the plain-text journal (message.log) always has
+// Used by the text journal and by tools reading back binary Records; no newline is appended
+//
+// in:
+//      timestamp - a pre-formatted timestamp for the entry
+//      type - the Message type as an integer
+//      data1, data2 - the Message's generic data fields
+//      sender - the Message sender
+// out:
+//      target - the formatted line; original contents are destroyed
+// returns:
+//      void
+void FormatEntry(std::string &target, std::string_view timestamp, int32_t type, int32_t data1, int32_t data2, std::string_view sender);
+
+} // namespace journal
+
+/////////////////////////////////////////////////
+// Double-buffered binary journal with a background writer thread
+// Append() and Flush() must be called from one thread only (the EventQueue consumer)
+class EventJournal {
+public:
+
+    /////////////////////////////////////////////////
+    // Number of records in each of the two blocks
+    static constexpr std::size_t BLOCK_RECORDS = 1024;
+
+    /////////////////////////////////////////////////
+    // Constructor does nothing; use Open()
+    // Destructor closes the journal, writing anything still buffered
+    // Copy/move constructors/operators are deleted; the writer thread holds a pointer to this
+    EventJournal() noexcept;
+    virtual ~EventJournal() { this->Close(); }
+    EventJournal(EventJournal &&) = delete;
+    EventJournal(const EventJournal &) = delete;
+    EventJournal &operator=(EventJournal &&) = delete;
+    EventJournal &operator=(const EventJournal &) = delete;
+
+    /////////////////////////////////////////////////
+    // Open (truncate) the journal file, write the header, and start the writer thread
+    // Any open journal is closed first
+    //
+    // in:
+    //      filename - a string_view with the file/path+file name
+    // returns:
+    //      true/false whether or not the open was successful
+    bool Open(std::string_view filename);
+
+    /////////////////////////////////////////////////
+    // Write everything still buffered, stop the writer thread and close the file
+    //
+    // returns:
+    //      void
+    void Close();
+
+    /////////////////////////////////////////////////
+    // Check whether or not the journal is open
+    //
+    // returns:
+    //      true/false depending on if the journal is accepting records
+    bool isOpen() const noexcept { return m_Writer.joinable(); }
+
+    /////////////////////////////////////////////////
+    // Append a Message to the active block
+    // Only waits if the active block fills while the writer is still busy with the other one
+    //
+    // in:
+    //      msg - the Message to record
+    //      updatetick - the fixed-timestep update the Message was popped in
+    // returns:
+    //      void
+    void Append(const Message &msg, uint32_t updatetick);
+
+    /////////////////////////////////////////////////
+    // Hand a partially filled block to the writer, if the writer is idle
+    // Meant to be called at frame boundaries; never waits
+    //
+    // returns:
+    //      void
+    void Flush();
+
+private:
+
+    /////////////////////////////////////////////////
+    // A buffer of records
+    struct Block {
+        journal::Record m_Records[BLOCK_RECORDS];
+        std::size_t m_Count;
+    };
+
+    static constexpr int NO_BLOCK = -1;
+
+    /////////////////////////////////////////////////
+    // Hand the active block to the writer and switch to the other one
+    //
+    // in:
+    //      wait - if true, wait for the writer to free the other block; if false, give up instead
+    // returns:
+    //      true if the block was handed off
+    bool Submit(bool wait);
+
+    /////////////////////////////////////////////////
+    // Writer thread body: write blocks as they're submitted until told to stop
+    //
+    // returns:
+    //      void
+    void WriterThread();
+
+    std::unique_ptr<Block[]> m_Blocks;
+    int m_ActiveBlock;      // owned by the appending thread
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Signal;
+    int m_PendingBlock;     // block waiting for or being written by the writer; guarded by m_Mutex
+    bool m_Stop;            // guarded by m_Mutex
+
+    std::thread m_Writer;
+    ostrich::File m_File;   // only the writer thread touches this while it's running
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_EVENTJOURNAL_H_ */
@@ -6,13 +6,46 @@ Copyright (c) 2020-2021 Ostrich Labs
 
 #include "eventqueue.h"
 #include "errorcodes.h"
+#include "../common/datetime.h"
 #include "../common/filesystem.h"
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-int ostrich::EventQueue::Initialize() {
-    if (!m_MessageJournal.Open(u8"message.log", ostrich::FileMode::OPEN_WRITETRUNCATE)) {
-        return OST_ERROR_JOURNAL;
+int ostrich::EventQueue::Initialize(JournalMode journalmode) {
+    this->Destroy();
+    m_HighLane.Clear();
+    m_NormalLane.Clear();
+    for (std::size_t i = 0; i < NUM_LANES; i++) {
+        m_DroppedCount[i].store(0, std::memory_order_relaxed);
+        m_LaneStats[i] = { };
+    }
+    m_UpdateTick = 0;
+    m_CoalescedLast = 0;
+    m_CoalescedPeak = 0;
+    m_CoalescedTotal = 0;
+    this->setCoalescing(m_isCoalescing);
+
+    m_JournalMode = journalmode;
+    switch (m_JournalMode) {
+        case JournalMode::JOURNAL_TEXT:
+        {
+            if (!m_MessageJournal.Open(u8"message.log", ostrich::FileMode::OPEN_WRITETRUNCATE)) {
+                return OST_ERROR_JOURNAL;
+            }
+            break;
+        }
+        case JournalMode::JOURNAL_BINARY:
+        {
+            if (!m_BinaryJournal.Open(u8"message.jnl")) {
+                return OST_ERROR_JOURNAL;
+            }
+            break;
+        }
+        case JournalMode::JOURNAL_NONE:
+        default:
+        {
+            break;
+        }
     }
 
     return OST_ERROR_OK;
@@ -20,20 +53,146 @@ int ostrich::EventQueue::Initialize() {
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-void ostrich::EventQueue::Push(const Message &msg) {
-    m_MessageQueue.push(msg);
-    this->WriteToJournal(msg);
+void ostrich::EventQueue::Destroy() {
+    m_BinaryJournal.Close();
+    m_MessageJournal.Close();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::EventQueue::Push(const Message &msg) {
+    bool pushed = false;
+    Lane lane = Lane::LANE_NORMAL;
+    if (msg.getType() == ostrich::Message::Type::SYSTEM) {
+        lane = Lane::LANE_HIGH;
+        pushed = m_HighLane.TryPush(msg);
+    }
+    else {
+        pushed = m_NormalLane.TryPush(msg);
+    }
+
+    if (!pushed) {
+        m_DroppedCount[static_cast<std::size_t>(lane)].fetch_add(1, std::memory_order_relaxed);
+    }
+    return pushed;
 }
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 std::optional<ostrich::Message> ostrich::EventQueue::Pop() {
-    if (!m_MessageQueue.empty()) {
-        ostrich::Message msg = m_MessageQueue.front();
-        m_MessageQueue.pop();
-        return std::make_optional(msg);
+    const int64_t now = ostrich::timer::ticks();
+    auto msg = this->PopLane(Lane::LANE_HIGH, now);
+    if (!msg.has_value()) {
+        msg = this->PopLane(Lane::LANE_NORMAL, now);
+    }
+    return msg;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+std::size_t ostrich::EventQueue::getLaneDepth(Lane lane) const noexcept {
+    switch (lane) {
+        case Lane::LANE_HIGH:
+            return m_HighLane.getSize();
+        case Lane::LANE_NORMAL:
+            return m_NormalLane.getSize();
+        case Lane::LANE_MAX:
+        default:
+            return 0;
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+std::optional<ostrich::Message> ostrich::EventQueue::PopLane(Lane lane, int64_t now) {
+    auto msg = (lane == Lane::LANE_HIGH) ? m_HighLane.TryPop() : m_NormalLane.TryPop();
+    if (msg.has_value()) {
+        LaneStats &stats = m_LaneStats[static_cast<std::size_t>(lane)];
+        int64_t age = now - msg->getTimestamp();
+        stats.m_Popped++;
+        stats.m_TotalAge += age;
+        if (age > stats.m_MaxAge) {
+            stats.m_MaxAge = age;
+        }
+
+        this->WriteToJournal(msg.value());
+    }
+    return msg;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+std::size_t ostrich::EventQueue::PopAll(Lane lane, std::vector<Message> &batch) {
+    const std::size_t first = batch.size();
+    std::size_t coalesced = 0;
+
+    auto pending = this->getLaneDepth(lane);
+    LaneStats &stats = m_LaneStats[static_cast<std::size_t>(lane)];
+    if (pending > stats.m_PeakDepth) {
+        stats.m_PeakDepth = pending;
+    }
+
+    const int64_t now = ostrich::timer::ticks();
+    while (pending-- > 0) {
+        auto queuemsg = this->PopLane(lane, now);
+        if (!queuemsg.has_value()) {
+            break; // a producer is still writing the next message; pick it up next time
+        }
+        const ostrich::Message &msg = queuemsg.value();
+
+        if (m_isCoalescing) {
+            if ((msg.getType() == ostrich::Message::Type::SYSTEM) && (msg.getSystemCode() == OST_SYSTEMMSG_FOCUSLOST)) {
+                // the releases for any keys held now went to another window
+                this->ResetKeyStates();
+            }
+            else if (msg.getType() == ostrich::Message::Type::INPUT_MOUSEPOS) {
+                // only the latest position in a run matters; anything else in between ends the run
+                if ((batch.size() > first) && (batch.back().getType() == ostrich::Message::Type::INPUT_MOUSEPOS)) {
+                    batch.back() = msg;
+                    coalesced++;
+                    continue;
+                }
+            }
+            else if (msg.getType() == ostrich::Message::Type::INPUT_KEY) {
+                // key repeat, or a release for a key we never saw pressed
+                auto keystatus = msg.getKeyStatus();
+                if ((keystatus.first >= 0) && (static_cast<std::size_t>(keystatus.first) < NUM_KEY_STATES)) {
+                    if (m_KeyStates[keystatus.first] == keystatus.second) {
+                        coalesced++;
+                        continue;
+                    }
+                    m_KeyStates[keystatus.first] = keystatus.second;
+                }
+            }
+        }
+
+        batch.push_back(msg);
+    }
+
+    if (lane == Lane::LANE_NORMAL) {
+        m_CoalescedLast = coalesced;
+    }
+    m_CoalescedTotal += coalesced;
+    if (coalesced > m_CoalescedPeak) {
+        m_CoalescedPeak = coalesced;
+    }
+
+    return coalesced;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::EventQueue::setCoalescing(bool coalesce) noexcept {
+    m_isCoalescing = coalesce;
+    this->ResetKeyStates();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::EventQueue::ResetKeyStates() noexcept {
+    for (auto &keystate : m_KeyStates) {
+        keystate = false;
     }
-    return std::nullopt;
 }
 
 /////////////////////////////////////////////////
@@ -45,20 +204,18 @@ ostrich::EventSender ostrich::EventQueue::CreateSender() noexcept {
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 void ostrich::EventQueue::WriteToJournal(const Message &msg) {
+    if (m_JournalMode == JournalMode::JOURNAL_BINARY) {
+        m_BinaryJournal.Append(msg, m_UpdateTick);
+        return;
+    }
+
     if (!m_MessageJournal.isOpen())
         return;
 
-    std::string message = u8"[";
-    message += msg.getTimestamp();
-    message += u8"] Message type >";
-    message += std::to_string(msg.getTypeAsInt());
-    message += u8"< Data1: >";
-    message += std::to_string(msg.getData1());
-    message += u8"< Data2: >";
-    message += std::to_string(msg.getData2());
-    message += u8"< Sender: >";
-    message += msg.getSender();
-    message += u8"<";
+    std::string message;
+    const char *sender = msg.getSender();
+    ostrich::journal::FormatEntry(message, ostrich::datetime::timestamp_ms(msg.getTimestamp()),
+        msg.getTypeAsInt(), msg.getData1(), msg.getData2(), (sender != nullptr) ? sender : u8"");
     std::fstream &handle = m_MessageJournal.getFStream();
     handle.write(message.c_str(), message.length());
     handle.put(ost_char::g_NewLine);
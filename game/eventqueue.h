@@ -3,16 +3,39 @@
 Copyright (c) 2020-2021 Ostrich Labs
 
 The EventQueue and its wrappers
+
+Storage is a bounded lock-free ring buffer, so EventSenders may push from any thread
+(input threads, signal handlers, workers) while the main loop pops without waiting.
+Only the main loop may pop.
+
+There are two lanes, each its own ring buffer: SYSTEM messages (quit, signals) go in the high-priority lane
+and everything else in the normal lane. The main loop drains the high lane first, so a shutdown never
+waits behind a backlog of input. Each lane keeps depth and age statistics for the console.
+
+The main loop drains the queue once per update with PopAll(). If coalescing is on, runs of consecutive
+mouse position messages collapse to the last one and key messages that don't change a key's state are dropped;
+nothing is ever reordered. Coalescing happens after journaling, so journals keep every raw message.
+Key state is remembered across updates, not just within one, so a key held through many updates lets only its first
+press through. It's forgotten when the window loses focus (OST_SYSTEMMSG_FOCUSLOST), since the releases for keys held
+then never arrive, and the next press of each has to get through.
+
+Popped messages are journaled for debugging/auditing, either as plain text written on the spot (message.log)
+or as binary records written by a background thread (message.jnl; see eventjournal.h).
 ==========================================
 */
 
 #ifndef OSTRICH_EVENTQUEUE_H_
 #define OSTRICH_EVENTQUEUE_H_
 
+#include <atomic>
+#include <cstdint>
 #include <optional>
-#include <queue>
+#include <vector>
+#include "eventjournal.h"
 #include "message.h"
 #include "../common/filesystem.h"
+#include "../common/datetime.h"
+#include "../common/ringbuffer.h"
 
 namespace ostrich {
 
@@ -25,11 +48,49 @@ class EventSender;
 class EventQueue {
 public:
 
+    /////////////////////////////////////////////////
+    // Maximum number of messages waiting in each lane
+    // Messages pushed beyond this are dropped (and counted) rather than allocating
+    static constexpr std::size_t QUEUE_CAPACITY = 4096;
+    static constexpr std::size_t HIGH_CAPACITY = 256;
+
+    /////////////////////////////////////////////////
+    // Priority lanes, highest priority first
+    enum class Lane : int32_t {
+        LANE_HIGH = 0,  // SYSTEM messages
+        LANE_NORMAL,    // everything else
+        LANE_MAX
+    };
+
+    /////////////////////////////////////////////////
+    // Per-lane statistics, kept by the main loop as it pops
+    // Age is how long a message waited, from its timestamp to when it was popped
+    // (meaningless for replayed messages, which keep their recorded timestamps)
+    struct LaneStats {
+        std::size_t m_PeakDepth;    // most messages waiting when a drain started
+        uint64_t m_Popped;          // messages popped since Initialize()
+        int64_t m_TotalAge;         // in timer ticks (nanoseconds); divide by m_Popped for an average
+        int64_t m_MaxAge;           // in timer ticks (nanoseconds)
+    };
+
+    /////////////////////////////////////////////////
+    // Number of key states tracked for coalescing; every ostrich::Keys value is below this
+    static constexpr std::size_t NUM_KEY_STATES = 256;
+
+    /////////////////////////////////////////////////
+    // How popped messages are journaled
+    enum class JournalMode : int32_t {
+        JOURNAL_NONE = 0,   // no journal
+        JOURNAL_TEXT,       // plain text, written synchronously to message.log
+        JOURNAL_BINARY      // fixed-size binary records, written to message.jnl by a background thread
+    };
+
     /////////////////////////////////////////////////
     // Constructor is effectively default; all data has default constructors
     // Destructor can do nothing because all data has its own destructors
     // Copy/move constructors/operators are deleted for performance reasons
-    EventQueue() noexcept { }
+    EventQueue() noexcept : m_DroppedCount{}, m_LaneStats{}, m_JournalMode(JournalMode::JOURNAL_NONE), m_UpdateTick(0),
+        m_isCoalescing(false), m_KeyStates{}, m_CoalescedLast(0), m_CoalescedPeak(0), m_CoalescedTotal(0) { }
     virtual ~EventQueue() { }
     EventQueue(EventQueue &&) = delete;
     EventQueue(const EventQueue &) = delete;
@@ -40,9 +101,46 @@ public:
     // Initialize the object
     // Any open files or data will be destroyed first
     //
+    // in:
+    //      journalmode - how to journal popped messages
     // returns:
     //      An error code (OST_ERROR_OK (0) is the only successful code)
-    int Initialize();
+    int Initialize(JournalMode journalmode = JournalMode::JOURNAL_BINARY);
+
+    /////////////////////////////////////////////////
+    // Close the journal, writing anything still buffered
+    //
+    // returns:
+    //      void
+    void Destroy();
+
+    /////////////////////////////////////////////////
+    // Let the binary journal write out what it has buffered so far
+    // Meant to be called once a frame from the main loop; never waits on file I/O
+    //
+    // returns:
+    //      void
+    void FlushJournal() { m_BinaryJournal.Flush(); }
+
+    /////////////////////////////////////////////////
+    // Set the fixed-timestep update number stamped on journaled messages
+    // The main loop sets this before draining the queue each update; replay uses it to line messages back up
+    //
+    // in:
+    //      tick - the current update number
+    // returns:
+    //      void
+    void setUpdateTick(uint32_t tick) noexcept { m_UpdateTick = tick; }
+
+    /////////////////////////////////////////////////
+    // Turn input coalescing in PopAll() on or off
+    // Key states are forgotten whenever it's turned on or off, so the first message for each key always gets through
+    //
+    // in:
+    //      coalesce - true to merge redundant input messages
+    // returns:
+    //      void
+    void setCoalescing(bool coalesce) noexcept;
 
     /////////////////////////////////////////////////
     // Create an EventSender object using this
@@ -55,37 +153,120 @@ public:
     // Check if there are any pending messages in the queue.
     //
     // returns:
-    //      true if there is one or more messages in the queue
-    bool isPending() const noexcept { return !m_MessageQueue.empty(); }
+    //      true if there is one or more messages in either lane
+    bool isPending() const noexcept { return (!m_HighLane.isEmpty() || !m_NormalLane.isEmpty()); }
 
     /////////////////////////////////////////////////
     // Get the number of messages in the queue
+    // Only exact when called from the main loop; from other threads it's a snapshot
+    //
+    // returns:
+    //      The number of messages in both lanes
+    std::size_t getQueueLength() const noexcept { return (m_HighLane.getSize() + m_NormalLane.getSize()); }
+
+    /////////////////////////////////////////////////
+    // Get the number of messages waiting in one lane
+    // Only exact when called from the main loop; from other threads it's a snapshot
     //
+    // in:
+    //      lane - the lane to check
+    // returns:
+    //      The number of messages in the lane
+    std::size_t getLaneDepth(Lane lane) const noexcept;
+
+    /////////////////////////////////////////////////
+    // Get a lane's statistics
+    // Only the main loop should call this
+    //
+    // in:
+    //      lane - the lane to check; must not be LANE_MAX
     // returns:
-    //      The number of messages in the queue; return type depends on internal representation of the queue
-    auto getQueueLength() const noexcept { return m_MessageQueue.size(); }
+    //      A reference to the lane's statistics since Initialize()
+    const LaneStats &getLaneStats(Lane lane) const noexcept { return m_LaneStats[static_cast<std::size_t>(lane)]; }
 
     /////////////////////////////////////////////////
-    // Add a new Message to the back of the queue
+    // Get the number of messages dropped because a lane was full
+    //
+    // in:
+    //      lane - the lane to check; must not be LANE_MAX
+    // returns:
+    //      The number of dropped messages since Initialize()
+    uint64_t getDroppedCount(Lane lane) const noexcept
+    { return m_DroppedCount[static_cast<std::size_t>(lane)].load(std::memory_order_relaxed); }
+
+    /////////////////////////////////////////////////
+    // Get the number of messages dropped because the queue was full
+    //
+    // returns:
+    //      The number of dropped messages in both lanes since Initialize()
+    uint64_t getDroppedCount() const noexcept
+    { return (this->getDroppedCount(Lane::LANE_HIGH) + this->getDroppedCount(Lane::LANE_NORMAL)); }
+
+    /////////////////////////////////////////////////
+    // Coalescing statistics
+    // "Last" is the most recent PopAll() of the normal lane (one per update); the rest cover everything since Initialize()
+    /////////////////////////////////////////////////
+
+    bool isCoalescing() const noexcept { return m_isCoalescing; }
+    std::size_t getCoalescedLast() const noexcept { return m_CoalescedLast; }
+    std::size_t getCoalescedPeak() const noexcept { return m_CoalescedPeak; }
+    uint64_t getCoalescedTotal() const noexcept { return m_CoalescedTotal; }
+
+    /////////////////////////////////////////////////
+    // Add a new Message to the back of its lane
+    // Safe to call from any thread
     //
     // in:
     //      msg - a reference to a Message to push
     // returns:
-    //      void
-    void Push(const Message &msg);
+    //      true if the message was queued, false if the queue was full and the message was dropped
+    bool Push(const Message &msg);
 
     /////////////////////////////////////////////////
     // Pop a Message from the front of the queue and remove it
+    // The high lane is always emptied before the normal lane is touched
     // Maybe removing the message should be separate, or there should be a Peek(), but for now this works
+    // Only the main loop may call this; it never waits
     //
     // returns:
     //      An optional<> possibly containing a Message object
     std::optional<Message> Pop();
 
+    /////////////////////////////////////////////////
+    // Pop everything queued in one lane right now, coalescing input if it's turned on
+    // Messages pushed while this runs wait for the next call. Only the main loop may call this
+    // An OST_SYSTEMMSG_FOCUSLOST popped here forgets every key state, as setCoalescing() does
+    //
+    // in:
+    //      lane - the lane to drain; must not be LANE_MAX
+    // out:
+    //      batch - popped messages are appended, in queue order
+    // returns:
+    //      The number of messages dropped by coalescing
+    std::size_t PopAll(Lane lane, std::vector<Message> &batch);
+
 private:
 
+    /////////////////////////////////////////////////
+    // Pop a Message from one lane, journal it and update the lane's statistics
+    //
+    // in:
+    //      lane - the lane to pop from; must not be LANE_MAX
+    //      now - the current timer tick, for the age statistics
+    // returns:
+    //      An optional<> possibly containing a Message object
+    std::optional<Message> PopLane(Lane lane, int64_t now);
+
+    /////////////////////////////////////////////////
+    // Forget every key state coalescing tracks, treating all keys as up
+    //
+    // returns:
+    //      void
+    void ResetKeyStates() noexcept;
+
     /////////////////////////////////////////////////
     // Writes details about a Message to a message log for debugging/auditing purposes
+    // Called from Pop() so only the main loop ever touches the journal
     //
     // in:
     //      msg - a Message object to write
@@ -93,8 +274,24 @@ private:
     //      void
     void WriteToJournal(const Message &msg);
 
-    std::queue<Message> m_MessageQueue;
+    static constexpr std::size_t NUM_LANES = static_cast<std::size_t>(Lane::LANE_MAX);
+
+    MPSCRingBuffer<Message, HIGH_CAPACITY> m_HighLane;
+    MPSCRingBuffer<Message, QUEUE_CAPACITY> m_NormalLane;
+    std::atomic<uint64_t> m_DroppedCount[NUM_LANES];
+    LaneStats m_LaneStats[NUM_LANES];
+
+    JournalMode m_JournalMode;
+    uint32_t m_UpdateTick;
+
+    bool m_isCoalescing;
+    bool m_KeyStates[NUM_KEY_STATES];   // last key state let through PopAll(); true is down
+    std::size_t m_CoalescedLast;
+    std::size_t m_CoalescedPeak;
+    uint64_t m_CoalescedTotal;
+
     ostrich::File m_MessageJournal;
+    EventJournal m_BinaryJournal;
 };
 
 /////////////////////////////////////////////////
@@ -135,13 +332,14 @@ public:
     bool isValid() const noexcept { if (m_Parent) return true; return false; }
 
     /////////////////////////////////////////////////
-    // Add a new Message to the back of the queue
+    // Add a new Message to the back of its lane
+    // Safe to call from any thread
     //
     // in:
     //      msg - a reference to a Message to push
     // returns:
-    //      void
-    void Send(const Message &msg) { if (m_Parent) m_Parent->Push(msg); }
+    //      true if the message was queued
+    bool Send(const Message &msg) { if (m_Parent) return m_Parent->Push(msg); return false; }
 
 private:
 
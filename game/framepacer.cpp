@@ -0,0 +1,115 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "framepacer.h"
+
+#include <algorithm>
+#include <thread>
+#include "../common/trace.h"
+
+namespace {
+
+// the spin stretch at the end of a wait is the recent worst oversleep plus a margin, but never less than the minimum
+// (and never more than the whole period, which means not sleeping at all on a scheduler that oversleeps that badly)
+constexpr std::chrono::nanoseconds g_MinSpinThreshold = std::chrono::microseconds(250);
+constexpr std::chrono::nanoseconds g_SpinMargin = std::chrono::microseconds(100);
+
+/////////////////////////////////////////////////
+// Nanoseconds to microseconds for the summary
+double ToMicroseconds(std::chrono::nanoseconds value) {
+    return static_cast<double>(value.count()) / 1.0e3;
+}
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::FramePacer::FramePacer() noexcept :
+    m_TargetRate(0.0), m_Period(0), m_SpinThreshold(g_MinSpinThreshold), m_Oversleep(0),
+    m_Deadline(ostrich::timer::now()), m_WaitedFrames(0), m_LateFrames(0), m_TotalJitter(0), m_MaxJitter(0) {
+
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::FramePacer::setTargetRate(double framespersecond) noexcept {
+    if (framespersecond > 0.0) {
+        m_TargetRate = framespersecond;
+        m_Period = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(1.0 / framespersecond));
+    }
+    else {
+        m_TargetRate = 0.0;
+        m_Period = std::chrono::nanoseconds(0);
+    }
+    this->Start();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::FramePacer::Start() noexcept {
+    m_Deadline = ostrich::timer::now();
+    m_SpinThreshold = g_MinSpinThreshold;
+    m_Oversleep = std::chrono::nanoseconds(0);
+    m_WaitedFrames = 0;
+    m_LateFrames = 0;
+    m_TotalJitter = std::chrono::nanoseconds(0);
+    m_MaxJitter = std::chrono::nanoseconds(0);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::FramePacer::Wait() {
+    if (!this->isEnabled())
+        return;
+
+    OST_TRACE_SCOPE("FramePacer::Wait");
+
+    m_Deadline += m_Period;
+    auto now = ostrich::timer::now();
+    if (now >= m_Deadline) {
+        m_LateFrames++;
+        if ((now - m_Deadline) > m_Period) {
+            m_Deadline = now;
+        }
+        return;
+    }
+
+    if ((m_Deadline - now) > m_SpinThreshold) {
+        auto wakeup = m_Deadline - m_SpinThreshold;
+        std::this_thread::sleep_until(wakeup);
+
+        // track the worst recent oversleep, letting it fade so one hiccup doesn't mean spinning forever
+        auto oversleep = std::max(std::chrono::nanoseconds(0),
+            std::chrono::duration_cast<std::chrono::nanoseconds>(ostrich::timer::now() - wakeup));
+        m_Oversleep = std::max(oversleep, m_Oversleep - (m_Oversleep / 16));
+        m_SpinThreshold = std::clamp(m_Oversleep + g_SpinMargin, g_MinSpinThreshold, std::max(g_MinSpinThreshold, m_Period));
+    }
+
+    do {
+        std::this_thread::yield();
+        now = ostrich::timer::now();
+    } while (now < m_Deadline);
+
+    auto jitter = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_Deadline);
+    m_WaitedFrames++;
+    m_TotalJitter += jitter;
+    m_MaxJitter = std::max(m_MaxJitter, jitter);
+    OST_TRACE_COUNTER("Pacing jitter (ns)", jitter.count());
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::FramePacer::WriteSummary(ostrich::ConsolePrinter &consoleprinter) const {
+    if (!this->isEnabled()) {
+        consoleprinter.WriteMessage(u8"Frame pacing: off");
+        return;
+    }
+
+    consoleprinter.WriteMessage(OST_FORMAT(u8"Frame pacing at % Hz: % frames waited, % late; jitter avg % us, max % us; spinning the last % us"),
+        m_TargetRate, m_WaitedFrames, m_LateFrames,
+        ToMicroseconds(std::chrono::nanoseconds(this->getAverageJitter())), ToMicroseconds(m_MaxJitter),
+        ToMicroseconds(m_SpinThreshold));
+}
@@ -0,0 +1,115 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+FramePacer - waits out the rest of each frame instead of spinning the main loop
+
+Frames are paced to fixed deadlines (one period apart, so small errors don't accumulate).
+Most of the wait is a normal sleep; the last stretch, where the OS might oversleep, is a short yielding spin.
+How long that stretch is adapts to how late sleeps have actually been waking up on this machine.
+==========================================
+*/
+
+#ifndef OSTRICH_FRAMEPACER_H_
+#define OSTRICH_FRAMEPACER_H_
+
+#include <chrono>
+#include <cstdint>
+#include "../common/console.h"
+#include "../common/datetime.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+//
+class FramePacer {
+public:
+
+    /////////////////////////////////////////////////
+    // Constructor creates a pacer that doesn't wait (target rate 0)
+    // Destructor is default; nothing is allocated
+    // Copy/move constructors/operators are default; it's all plain data
+    FramePacer() noexcept;
+    ~FramePacer() = default;
+    FramePacer(FramePacer &&) = default;
+    FramePacer(const FramePacer &) = default;
+    FramePacer &operator=(FramePacer &&) = default;
+    FramePacer &operator=(const FramePacer &) = default;
+
+    /////////////////////////////////////////////////
+    // Set how many frames a second to pace to
+    // Restarts the deadlines and statistics
+    //
+    // in:
+    //      framespersecond - the target rate; 0 (or less) turns pacing off
+    // returns:
+    //      void
+    void setTargetRate(double framespersecond) noexcept;
+
+    /////////////////////////////////////////////////
+    // Get the rate being paced to
+    //
+    // returns:
+    //      frames per second, or 0 if pacing is off
+    double getTargetRate() const noexcept { return m_TargetRate; }
+
+    /////////////////////////////////////////////////
+    // Check if Wait() does anything
+    //
+    // returns:
+    //      true if there's a target rate
+    bool isEnabled() const noexcept { return (m_Period.count() > 0); }
+
+    /////////////////////////////////////////////////
+    // Start pacing from now
+    // Call right before the first frame, so time spent loading doesn't count as a late frame
+    //
+    // returns:
+    //      void
+    void Start() noexcept;
+
+    /////////////////////////////////////////////////
+    // Wait until the current frame's deadline
+    // Sleeps for most of the time left and spins for the rest; returns right away if the frame is already late.
+    // A frame more than a whole period late moves the deadlines up, rather than rushing frames to catch up.
+    //
+    // returns:
+    //      void
+    void Wait();
+
+    /////////////////////////////////////////////////
+    // Write the target rate and measured jitter to the console
+    //
+    // in:
+    //      consoleprinter - where to write
+    // returns:
+    //      void
+    void WriteSummary(ConsolePrinter &consoleprinter) const;
+
+    /////////////////////////////////////////////////
+    // Pacing statistics since the last Start() or setTargetRate()
+    // Jitter is how long after its deadline a waited frame actually woke up
+    uint64_t getWaitedFrames() const noexcept { return m_WaitedFrames; }
+    uint64_t getLateFrames() const noexcept { return m_LateFrames; }
+    int64_t getAverageJitter() const noexcept {
+        return (m_WaitedFrames > 0) ? (m_TotalJitter.count() / static_cast<int64_t>(m_WaitedFrames)) : 0;
+    }
+    int64_t getMaxJitter() const noexcept { return m_MaxJitter.count(); }
+
+private:
+
+    double m_TargetRate;
+    std::chrono::nanoseconds m_Period;          // 0 when pacing is off
+    std::chrono::nanoseconds m_SpinThreshold;   // time left at which sleeping stops and spinning starts
+    std::chrono::nanoseconds m_Oversleep;       // decaying peak of how late sleep_until() has woken up
+    ostrich::timer::time_point m_Deadline;
+
+    uint64_t m_WaitedFrames;
+    uint64_t m_LateFrames;
+    std::chrono::nanoseconds m_TotalJitter;
+    std::chrono::nanoseconds m_MaxJitter;
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_FRAMEPACER_H_ */
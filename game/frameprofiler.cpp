@@ -0,0 +1,145 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "frameprofiler.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// 60 updates a second
+constexpr int64_t g_DefaultBudget = 16'666'667;
+
+const char *const g_StageNames[ostrich::FrameProfiler::NUM_STAGES] = {
+    u8"Input",
+    u8"Update",
+    u8"Render",
+    u8"Frame"
+};
+
+/////////////////////////////////////////////////
+// Nanoseconds to milliseconds for the summary
+double ToMilliseconds(int64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1.0e6;
+}
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::FrameProfiler::FrameProfiler() noexcept :
+    m_isEnabled(false), m_Budget(g_DefaultBudget), m_FrameCount(0), m_OverBudgetCount(0),
+    m_Current{}, m_Last{}, m_Window{} {
+
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::FrameProfiler::setEnabled(bool enabled) noexcept {
+    if (enabled && !m_isEnabled) {
+        m_FrameCount = 0;
+        m_OverBudgetCount = 0;
+        m_Current.fill(0);
+        m_Last.fill(0);
+    }
+    m_isEnabled = enabled;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::FrameProfiler::BeginFrame() noexcept {
+    if (!m_isEnabled)
+        return;
+
+    m_Current.fill(0);
+    m_FrameStart = ostrich::timer::now();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::FrameProfiler::AddStageTime(Stage stage, const ostrich::timer::time_point &start,
+    const ostrich::timer::time_point &finish) noexcept {
+    std::size_t index = static_cast<std::size_t>(stage);
+    if (!m_isEnabled || (index >= NUM_STAGES))
+        return;
+
+    m_Current[index] += std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::FrameProfiler::EndFrame() noexcept {
+    if (!m_isEnabled)
+        return false;
+
+    constexpr std::size_t frame = static_cast<std::size_t>(Stage::STAGE_FRAME);
+    m_Current[frame] = std::chrono::duration_cast<std::chrono::nanoseconds>(ostrich::timer::now() - m_FrameStart).count();
+
+    std::size_t slot = static_cast<std::size_t>(m_FrameCount % WINDOW_SIZE);
+    for (std::size_t i = 0; i < NUM_STAGES; i++) {
+        m_Window[i][slot] = m_Current[i];
+    }
+    m_Last = m_Current;
+    m_FrameCount++;
+
+    if (m_Current[frame] > m_Budget) {
+        m_OverBudgetCount++;
+        return true;
+    }
+    return false;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int64_t ostrich::FrameProfiler::getLastTime(Stage stage) const noexcept {
+    std::size_t index = static_cast<std::size_t>(stage);
+    return (index < NUM_STAGES) ? m_Last[index] : 0;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::FrameProfiler::Summary ostrich::FrameProfiler::getSummary(Stage stage) const {
+    Summary summary{ 0, 0, 0, 0, 0 };
+    std::size_t index = static_cast<std::size_t>(stage);
+    std::size_t count = static_cast<std::size_t>(std::min<uint64_t>(m_FrameCount, WINDOW_SIZE));
+    if ((index >= NUM_STAGES) || (count == 0))
+        return summary;
+
+    std::array<int64_t, WINDOW_SIZE> sorted = m_Window[index];
+    std::sort(sorted.begin(), sorted.begin() + count);
+
+    int64_t total = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        total += sorted[i];
+    }
+
+    summary.m_Min = sorted[0];
+    summary.m_Avg = total / static_cast<int64_t>(count);
+    summary.m_P50 = sorted[(count - 1) / 2];
+    summary.m_P99 = sorted[((count - 1) * 99) / 100];
+    summary.m_Max = sorted[count - 1];
+    return summary;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::FrameProfiler::WriteSummary(ostrich::ConsolePrinter &consoleprinter) const {
+    if (m_FrameCount == 0) {
+        consoleprinter.WriteMessage(u8"Frame profile: no frames recorded");
+        return;
+    }
+
+    consoleprinter.WriteMessage(OST_FORMAT(u8"Frame profile over the last % of % frames, % over the % ms budget:"),
+        std::min<uint64_t>(m_FrameCount, WINDOW_SIZE), m_FrameCount, m_OverBudgetCount, ToMilliseconds(m_Budget));
+
+    for (std::size_t i = 0; i < NUM_STAGES; i++) {
+        Summary summary = this->getSummary(static_cast<Stage>(i));
+        consoleprinter.WriteMessage(OST_FORMAT(u8"    %: min % avg % p50 % p99 % max % ms"), g_StageNames[i],
+            ToMilliseconds(summary.m_Min), ToMilliseconds(summary.m_Avg), ToMilliseconds(summary.m_P50),
+            ToMilliseconds(summary.m_P99), ToMilliseconds(summary.m_Max));
+    }
+}
@@ -0,0 +1,196 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+FrameProfiler - per-stage CPU time for every frame of the main loop
+
+Each frame, Main times its stages (input, update, render) and the frame as a whole.
+The last WINDOW_SIZE frames are kept per stage, so a summary can give min/avg/p50/p99/max for recent play;
+frames longer than the budget are counted and reported back to the caller.
+While disabled, every call returns after a single check, without reading the clock.
+==========================================
+*/
+
+#ifndef OSTRICH_FRAMEPROFILER_H_
+#define OSTRICH_FRAMEPROFILER_H_
+
+#include <array>
+#include <cstdint>
+#include "../common/console.h"
+#include "../common/datetime.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+//
+class FrameProfiler {
+public:
+
+    /////////////////////////////////////////////////
+    // What gets timed
+    // A stage can run more than once a frame (several updates to catch up, say); its time is summed
+    enum class Stage : int32_t {
+        STAGE_INPUT = 0,
+        STAGE_UPDATE,
+        STAGE_RENDER,
+        STAGE_FRAME,    // the whole frame, BeginFrame() to EndFrame(); filled in by EndFrame()
+        STAGE_MAX
+    };
+
+    static constexpr std::size_t NUM_STAGES = static_cast<std::size_t>(Stage::STAGE_MAX);
+
+    /////////////////////////////////////////////////
+    // Number of frames the rolling statistics cover
+    static constexpr std::size_t WINDOW_SIZE = 512;
+
+    /////////////////////////////////////////////////
+    // Rolling statistics for a stage, in nanoseconds
+    struct Summary {
+        int64_t m_Min;
+        int64_t m_Avg;
+        int64_t m_P50;
+        int64_t m_P99;
+        int64_t m_Max;
+    };
+
+    /////////////////////////////////////////////////
+    // Times one stage for as long as it's in scope
+    // Copy/move constructors/operators are deleted; it only makes sense on the stack
+    class StageTimer {
+    public:
+        StageTimer(FrameProfiler &profiler, Stage stage) noexcept :
+            m_Profiler(profiler.isEnabled() ? &profiler : nullptr), m_Stage(stage),
+            m_Start((m_Profiler != nullptr) ? ostrich::timer::now() : ostrich::timer::time_point()) {}
+        ~StageTimer() { if (m_Profiler != nullptr) m_Profiler->AddStageTime(m_Stage, m_Start, ostrich::timer::now()); }
+        StageTimer(StageTimer &&) = delete;
+        StageTimer(const StageTimer &) = delete;
+        StageTimer &operator=(StageTimer &&) = delete;
+        StageTimer &operator=(const StageTimer &) = delete;
+
+    private:
+
+        FrameProfiler *m_Profiler;
+        Stage m_Stage;
+        ostrich::timer::time_point m_Start;
+    };
+
+    /////////////////////////////////////////////////
+    // Constructor creates a disabled profiler with a 60 Hz budget
+    // Destructor is default; nothing is allocated
+    // Copy/move constructors/operators are default; it's all plain data
+    FrameProfiler() noexcept;
+    ~FrameProfiler() = default;
+    FrameProfiler(FrameProfiler &&) = default;
+    FrameProfiler(const FrameProfiler &) = default;
+    FrameProfiler &operator=(FrameProfiler &&) = default;
+    FrameProfiler &operator=(const FrameProfiler &) = default;
+
+    /////////////////////////////////////////////////
+    // Turn profiling on or off
+    // Turning it on starts from empty statistics
+    //
+    // in:
+    //      enabled - true to profile
+    // returns:
+    //      void
+    void setEnabled(bool enabled) noexcept;
+
+    /////////////////////////////////////////////////
+    // Check if the profiler is recording
+    //
+    // returns:
+    //      true if enabled
+    bool isEnabled() const noexcept { return m_isEnabled; }
+
+    /////////////////////////////////////////////////
+    // Set how long a frame may take before it counts as over budget
+    //
+    // in:
+    //      budget - the frame budget, in nanoseconds
+    // returns:
+    //      void
+    void setBudget(int64_t budget) noexcept { m_Budget = budget; }
+
+    /////////////////////////////////////////////////
+    // Start timing a frame
+    //
+    // returns:
+    //      void
+    void BeginFrame() noexcept;
+
+    /////////////////////////////////////////////////
+    // Add time to a stage of the current frame
+    // Usually done through a StageTimer
+    //
+    // in:
+    //      stage - the stage to add to
+    //      start - when the stage started
+    //      finish - when the stage finished
+    // returns:
+    //      void
+    void AddStageTime(Stage stage, const ostrich::timer::time_point &start, const ostrich::timer::time_point &finish) noexcept;
+
+    /////////////////////////////////////////////////
+    // Finish the current frame and add its stage times to the rolling window
+    //
+    // returns:
+    //      true if the frame went over budget
+    bool EndFrame() noexcept;
+
+    /////////////////////////////////////////////////
+    // Get a stage's time in the frame that just ended
+    //
+    // in:
+    //      stage - the stage to get
+    // returns:
+    //      the stage's time, in nanoseconds
+    int64_t getLastTime(Stage stage) const noexcept;
+
+    /////////////////////////////////////////////////
+    // Calculate the rolling statistics for a stage
+    // Sorts a copy of the window, so keep it out of the per-frame path
+    //
+    // in:
+    //      stage - the stage to summarize
+    // returns:
+    //      min/avg/p50/p99/max over the window; all 0 if no frames have been recorded
+    Summary getSummary(Stage stage) const;
+
+    /////////////////////////////////////////////////
+    // Get the number of frames recorded since profiling was enabled
+    //
+    // returns:
+    //      the frame count
+    uint64_t getFrameCount() const noexcept { return m_FrameCount; }
+
+    /////////////////////////////////////////////////
+    // Get the number of frames that went over budget since profiling was enabled
+    //
+    // returns:
+    //      the over-budget frame count
+    uint64_t getOverBudgetCount() const noexcept { return m_OverBudgetCount; }
+
+    /////////////////////////////////////////////////
+    // Write the rolling statistics for every stage to the console, in milliseconds
+    //
+    // in:
+    //      consoleprinter - where to write
+    // returns:
+    //      void
+    void WriteSummary(ConsolePrinter &consoleprinter) const;
+
+private:
+
+    bool m_isEnabled;
+    int64_t m_Budget;           // nanoseconds
+    uint64_t m_FrameCount;      // frames recorded; the window is full once this reaches WINDOW_SIZE
+    uint64_t m_OverBudgetCount;
+    ostrich::timer::time_point m_FrameStart;
+    std::array<int64_t, NUM_STAGES> m_Current;  // the frame in progress
+    std::array<int64_t, NUM_STAGES> m_Last;     // the frame that just ended
+    std::array<std::array<int64_t, WINDOW_SIZE>, NUM_STAGES> m_Window;
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_FRAMEPROFILER_H_ */
@@ -55,11 +55,11 @@ public:
     // Given passed scene data, draw to the screen
     //
     // in:
-    //      scenedata - a pointer to the scene data (think right now it's just screen clear color and an entity list)
-    //      extrapolation - how far into the next frame we are, in milliseconds (lag/msperframe)
+    //      scenedata - a pointer to the scene data: the clear color and the sprite render list
+    //      alpha - how far this frame is between the last update and the next, from 0 to 1 (for interpolating)
     // returns:
     //      void
-    virtual void RenderScene(const SceneData *scenedata, int32_t extrapolation) = 0;
+    virtual void RenderScene(const SceneData *scenedata, double alpha) = 0;
 
 protected:
 
@@ -0,0 +1,77 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "journalreplay.h"
+#include "../common/filesystem.h"
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::JournalReplay::Load(std::string_view filename) {
+    m_Records.clear();
+    m_Position = 0;
+
+    ostrich::File input;
+    if (!input.Open(filename, ostrich::FileMode::OPEN_READONLY)) {
+        return false;
+    }
+    std::fstream &handle = input.getFStream();
+
+    ostrich::journal::FileHeader header = { };
+    if (!ostrich::journal::ReadHeader(handle, header)) {
+        return false;
+    }
+
+    // size the vector up front so a long soak journal doesn't reallocate its way in
+    const std::streampos start = handle.tellg();
+    handle.seekg(0, std::ios::end);
+    const std::streamoff length = handle.tellg() - start;
+    handle.seekg(start);
+    if (length <= 0) {
+        return true;
+    }
+
+    m_Records.resize(static_cast<std::size_t>(length) / sizeof(ostrich::journal::Record));
+    handle.read(reinterpret_cast<char *>(m_Records.data()), m_Records.size() * sizeof(ostrich::journal::Record));
+    if (handle.gcount() != static_cast<std::streamsize>(m_Records.size() * sizeof(ostrich::journal::Record))) {
+        m_Records.clear();
+        return false;
+    }
+
+    // the sender field is fixed width; make sure it's terminated even if the file is damaged
+    for (auto &record : m_Records) {
+        record.m_Sender[ostrich::journal::g_SenderLength - 1] = ost_char::g_Null;
+    }
+
+    return true;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+std::size_t ostrich::JournalReplay::Inject(uint32_t updatetick, ostrich::EventSender &sender) {
+    std::size_t count = 0;
+
+    // records are in pop order, so update ticks never go backwards
+    while ((m_Position < m_Records.size()) && (m_Records[m_Position].m_UpdateTick <= updatetick)) {
+        const ostrich::journal::Record &record = m_Records[m_Position];
+        m_Position++;
+
+        bool external = (record.m_Type == static_cast<int32_t>(ostrich::Message::Type::SYSTEM)) ||
+                        ((record.m_Type >= static_cast<int32_t>(ostrich::Message::Type::INPUT_START)) &&
+                         (record.m_Type <= static_cast<int32_t>(ostrich::Message::Type::INPUT_LAST)));
+        bool derived = (record.m_Type == static_cast<int32_t>(ostrich::Message::Type::SYSTEM)) &&
+                       (record.m_Data1 == OST_SYSTEMMSG_PROFILE);
+        if (!external || derived) {
+            continue;
+        }
+
+        if (sender.Send(ostrich::Message::CreateReplayMessage(record.m_Type, record.m_Data1, record.m_Data2,
+            record.m_Sender, record.m_Timestamp))) {
+            count++;
+        }
+    }
+
+    return count;
+}
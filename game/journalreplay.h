@@ -0,0 +1,85 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Journal replay - feeds a recorded binary event journal back into the EventQueue
+
+Each Record carries the fixed-timestep update it was popped in, so the replay pushes exactly
+the messages a given update saw while recording, right before that update runs.
+Only input and system messages are replayed; state messages are sent again by the game itself.
+A quit the game sent itself can show up twice that way, which is harmless.
+Profile requests are skipped: Main derives them from the F12 key, which is replayed, so injecting the recorded one too
+would write the summary twice.
+==========================================
+*/
+
+#ifndef OSTRICH_JOURNALREPLAY_H_
+#define OSTRICH_JOURNALREPLAY_H_
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "eventjournal.h"
+#include "eventqueue.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+//
+class JournalReplay {
+public:
+
+    /////////////////////////////////////////////////
+    // Constructor is default; use Load()
+    // Destructor does nothing; Messages injected by this object point at its records, so keep it alive until they're popped
+    // Copy/move constructors/operators are deleted; injected Messages point into the record storage
+    JournalReplay() noexcept : m_Position(0) { }
+    virtual ~JournalReplay() { }
+    JournalReplay(JournalReplay &&) = delete;
+    JournalReplay(const JournalReplay &) = delete;
+    JournalReplay &operator=(JournalReplay &&) = delete;
+    JournalReplay &operator=(const JournalReplay &) = delete;
+
+    /////////////////////////////////////////////////
+    // Read an entire journal into memory and rewind to its first record
+    // A truncated record at the end of the file (from a crash mid-write) is ignored
+    //
+    // in:
+    //      filename - a string_view with the file/path+file name
+    // returns:
+    //      true if the file was a readable journal
+    bool Load(std::string_view filename);
+
+    /////////////////////////////////////////////////
+    // Push every replayable record recorded for an update into the queue
+    //
+    // in:
+    //      updatetick - the update that's about to run
+    //      sender - an EventSender for the queue being replayed into
+    // returns:
+    //      The number of messages pushed; records the queue had no room for are counted as drops by the queue
+    std::size_t Inject(uint32_t updatetick, EventSender &sender);
+
+    /////////////////////////////////////////////////
+    // Check whether every record has been injected
+    //
+    // returns:
+    //      true if there's nothing left to replay
+    bool isDone() const noexcept { return (m_Position >= m_Records.size()); }
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    std::size_t getRecordCount() const noexcept { return m_Records.size(); }
+    uint32_t getLastUpdateTick() const noexcept { return m_Records.empty() ? 0 : m_Records.back().m_UpdateTick; }
+
+private:
+
+    std::vector<journal::Record> m_Records;
+    std::size_t m_Position;
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_JOURNALREPLAY_H_ */
@@ -7,14 +7,17 @@ Message - x happened, or y needs to happen
 Should be lightweight, so copying is cheap.
 Methods should provide data in context based on type.
 Then when you want, say, mouse coords, you get just mouse coords.
+
+Messages are trivially copyable and no bigger than 32 bytes: no strings, no virtual functions, no allocation.
+The timestamp is a raw timer tick; format it with datetime::timestamp_ms(tick) only when it's actually displayed.
 ==========================================
 */
 
 #ifndef OSTRICH_MESSAGE_H_
 #define OSTRICH_MESSAGE_H_
 
-#include <string>
-#include <string_view>
+#include <cstdint>
+#include <type_traits>
 #include <utility>
 #include "../common/datetime.h"
 #include "../common/ost_common.h"
@@ -25,6 +28,8 @@ Then when you want, say, mouse coords, you get just mouse coords.
 #define OST_SYSTEMMSG_NULL      0x0000
 #define OST_SYSTEMMSG_QUIT      0x0001  // a sign to hard quit from the game regardless of game state
 #define OST_SYSTEMMSG_SIGNAL    0x0002  // a signal was raised
+#define OST_SYSTEMMSG_PROFILE   0x0003  // write the frame profiler's summary to the console
+#define OST_SYSTEMMSG_FOCUSLOST 0x0004  // the window lost keyboard focus; keys held then won't send their releases
 
 namespace ostrich {
 
@@ -61,9 +66,9 @@ public:
 
     /////////////////////////////////////////////////
     // Constructors are all private; use the static factory methods to create Messages
-    // Destructor can do nothing because all data is either simple or has its own destructor
-    // Data is all either simple or copyable, so copy/move constructors/operators are default
-    virtual ~Message() {}
+    // Destructor is default and non-virtual; Messages must stay trivially copyable
+    // Data is all simple, so copy/move constructors/operators are default
+    ~Message() = default;
     Message(Message &&) = default;
     Message(const Message &) = default;
     Message &operator=(Message &&) = default;
@@ -120,17 +125,30 @@ public:
     static Message CreateMousePosMessage(int32_t xpos, int32_t ypos, const char *sender)
     { return Message(Type::INPUT_MOUSEPOS, xpos, ypos, sender); }
 
+    /////////////////////////////////////////////////
+    // Recreate a previously recorded message exactly, timestamp included
+    // Only meant for replaying an event journal; everything else should use the typed factories above
+    //
+    // in:
+    //      type - the recorded Message type as an integer
+    //      data1, data2 - the recorded generic data fields
+    //      sender - the recorded sender; must outlive the Message like any other sender
+    //      timestamp - the recorded timer::ticks() value
+    // returns:
+    //      A constructed message of the recorded type
+    static Message CreateReplayMessage(int32_t type, int32_t data1, int32_t data2, const char *sender, int64_t timestamp)
+    { return Message(static_cast<Type>(type), data1, data2, sender, timestamp); }
+
     /////////////////////////////////////////////////
     // accessor methods
     // generic to each message
-    // data pointer is currently unused
+    // the timestamp is a timer::ticks() value, not a formatted string
     /////////////////////////////////////////////////
 
     Type getType() const noexcept { return m_Type; }
     int32_t getTypeAsInt() const noexcept{ return static_cast<int32_t>(m_Type); }
 
-    void *getDataPointer() const noexcept { return m_DataPtr; }
-    std::string_view getTimestamp() const noexcept { return std::string_view(m_Timestamp); }
+    int64_t getTimestamp() const noexcept { return m_Timestamp; }
     const char *getSender() const noexcept { return m_Sender; }
     
     /////////////////////////////////////////////////
@@ -158,48 +176,50 @@ private:
     /////////////////////////////////////////////////
     // Default constructor
     // Creates a NULLTYPE message with 0 or null data
-    Message() : m_Type(Type::NULLTYPE), m_Data1(0), m_Data2(0), m_DataPtr(nullptr), m_Sender(nullptr) {}
+    Message() noexcept : m_Type(Type::NULLTYPE), m_Data1(0), m_Data2(0), m_Sender(nullptr), m_Timestamp(0) {}
 
     /////////////////////////////////////////////////
     // Semi-default constructor
     // Creates a NULLTYPE message with 0 or null data, except for the sender
-    Message(const char *sender) : m_Type(Type::NULLTYPE), m_Data1(0), m_Data2(0), m_DataPtr(nullptr), m_Sender(sender) {}
+    Message(const char *sender) noexcept : m_Type(Type::NULLTYPE), m_Data1(0), m_Data2(0), m_Sender(sender), m_Timestamp(0) {}
 
     /////////////////////////////////////////////////
     // Delegate constructor
     // Used as a helper for the more specific constructors; should fill the entire message object
-    Message(Type type, int32_t data1, int32_t data2, void *dataptr, const char *sender) :
-        m_Type(type), m_Data1(data1), m_Data2(data2), m_DataPtr(dataptr), m_Sender(sender), m_Timestamp(ostrich::datetime::timestamp_ms())
+    Message(Type type, int32_t data1, int32_t data2, const char *sender, int64_t timestamp) noexcept :
+        m_Type(type), m_Data1(data1), m_Data2(data2), m_Sender(sender), m_Timestamp(timestamp)
     {}
 
     /////////////////////////////////////////////////
     // Single integer constructor
     // Currently used with BUTTON type messages
     Message(Type type, int32_t buttoncode, const char *sender) :
-        Message(type, buttoncode, 0, nullptr, sender) {}
+        Message(type, buttoncode, 0, sender, ostrich::timer::ticks()) {}
 
     /////////////////////////////////////////////////
     // Integer + boolean constructor
     // The boolean is converted to a known 1/0 value rather than trusting the compiler to be consistent
     // Currently used with KEY type messages
     Message(Type type, int32_t keycode, bool keydown, const char *sender) :
-        Message(type, keycode, (keydown ? 1 : 0), nullptr, sender) {}
+        Message(type, keycode, (keydown ? 1 : 0), sender, ostrich::timer::ticks()) {}
 
     /////////////////////////////////////////////////
     // Dual integer constructor
     // Currently used with MOUSEPOS and SYSTEM type messages
     Message(Type type, int32_t data1, int32_t data2, const char *sender) :
-        Message(type, data1, data2, nullptr, sender) {}
+        Message(type, data1, data2, sender, ostrich::timer::ticks()) {}
 
     Type m_Type;
     int32_t m_Data1;
     int32_t m_Data2;
-    void *m_DataPtr;
 
-    const char *m_Sender;
-    std::string m_Timestamp;
+    const char *m_Sender;   // always a string literal, never owned
+    int64_t m_Timestamp;    // timer::ticks() at creation
 };
 
+static_assert(std::is_trivially_copyable_v<Message>, "Message must stay trivially copyable");
+static_assert(sizeof(Message) <= 32, "Message must fit in 32 bytes");
+
 } // namespace ostrich
 
 #endif /* OSTRICH_MESSAGE_H_ */
@@ -4,22 +4,40 @@ Copyright (c) 2020-2021 Ostrich Labs
 ==========================================
 */
 
+#include <algorithm>
+#include <chrono>
 #include <csignal>
+#include <iostream>
+#include <ratio>
+#include <thread>
+#include "journalreplay.h"
 #include "ost_main.h"
 #include "ost_version.h"
 #include "../common/datetime.h"
 #include "../common/error.h"
 #include "../game/errorcodes.h"
+#include "../game/keydef.h"
 #include "../game/message.h"
 
 // game-specific includes
 #include "../minesweeper/ms_common.h"
 
+namespace {
+
+// most updates run in one frame; if the game falls further behind than this, the rest of the backlog is dropped
+// rather than trying to catch up (which would make the next frame even later, and so on)
+constexpr int64_t g_MaxUpdatesPerFrame = 8;
+
+}
+
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 ostrich::Main::Main() noexcept :
-m_isActive(false), m_Input(nullptr), m_Display(nullptr), m_Renderer(nullptr) {
+m_isActive(false), m_UpdateTick(0), m_SkippedUpdates(0), m_Input(nullptr), m_Display(nullptr), m_Renderer(nullptr),
+m_ProfileRequested(false), m_isThreaded(false), m_isSimulationDone(false), m_SimulationError(nullptr) {
+    m_Profiler.setEnabled(ostrich::g_DebugBuild);
+    m_Pacer.setTargetRate(static_cast<double>(UPDATES_PER_SECOND));
 
 }
 
@@ -40,10 +58,16 @@ int ostrich::Main::Start(ostrich::IDisplay *display, ostrich::IRenderer *rendere
     m_Renderer = renderer;
     m_Input = input;
 
-    int initresult = this->Initialize();
+    int initresult = this->Initialize(ostrich::EventQueue::JournalMode::JOURNAL_BINARY);
     if (initresult == 0) {
         m_isActive = true;
-        this->Run();
+        if (m_isThreaded) {
+            m_ConsolePrinter.WriteMessage(u8"Running the simulation on its own thread");
+            this->RunThreaded();
+        }
+        else {
+            this->Run();
+        }
     }
 
     return initresult;
@@ -51,13 +75,77 @@ int ostrich::Main::Start(ostrich::IDisplay *display, ostrich::IRenderer *rendere
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-int ostrich::Main::Initialize() {
+int ostrich::Main::Replay(std::string_view journalfile, bool realtime) {
+    m_Display = nullptr;
+    m_Renderer = nullptr;
+    m_Input = nullptr;
+
+    // don't journal the replay; it would overwrite message.jnl, which may well be the file being replayed
+    int initresult = this->Initialize(ostrich::EventQueue::JournalMode::JOURNAL_NONE);
+    if (initresult != OST_ERROR_OK) {
+        return initresult;
+    }
+    m_isActive = true;
+
+    ostrich::JournalReplay replay;
+    if (!replay.Load(journalfile)) {
+        m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Unable to read journal %"), journalfile);
+        return OST_ERROR_REPLAYLOAD;
+    }
+    m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Replaying % records over % updates from %"),
+        replay.getRecordCount(), replay.getLastUpdateTick() + 1, journalfile);
+
+    ostrich::EventSender sender = m_EventQueue.CreateSender();
+    uint64_t injected = 0;
+    bool done = false;
+
+    auto start = ostrich::timer::now();
+    UpdateClockTicks scheduled(0);
+    while (!done && !replay.isDone()) {
+        injected += replay.Inject(m_UpdateTick, sender);
+        done = this->UpdateState();
+
+        if (realtime) {
+            scheduled += UPDATE_INTERVAL;
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<ostrich::timer::clock::duration>(scheduled));
+        }
+    }
+    auto finish = ostrich::timer::now();
+
+    double duration = ostrich::timer::interval_d(start, finish);
+    double rate = (duration > 0.0) ? (static_cast<double>(m_UpdateTick) * 1000.0 / duration) : 0.0;
+    std::string_view summary = ostrich::format::Format(OST_FORMAT(u8"Replayed % updates (% messages) in % ms, % updates per second"),
+        m_UpdateTick, injected, duration, rate);
+    m_ConsolePrinter.WriteMessage(summary);
+
+    // the console only writes console.log; a headless replay is run from a shell, which wants the result on stdout
+    std::cout << summary << ost_char::g_NewLine;
+
+    return OST_ERROR_OK;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int ostrich::Main::Initialize(ostrich::EventQueue::JournalMode journalmode) {
+    // start tracing before the console so its writer thread shows up in the trace
+    bool tracing = (!m_TraceFilename.empty() && m_Tracer.Initialize(m_TraceFilename));
+    OST_TRACE_THREAD("Main");
+
     m_Console.Initialize();
     m_ConsolePrinter = m_Console.CreatePrinter();
 
-    m_ConsolePrinter.WriteMessage(u8"Running % version %", { ostrich::g_EngineName, ostrich::version::g_EngineVersion });
-    m_ConsolePrinter.WriteMessage(u8"Platform: %", { ostrich::platform::g_PlatformString });
-    m_ConsolePrinter.WriteMessage(u8"Started at: %", { ostrich::datetime::timestamp() });
+    m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Running % version %"), ostrich::g_EngineName, ostrich::version::g_EngineVersion);
+    m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Platform: %"), ostrich::platform::g_PlatformString);
+    m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Started at: %"), ostrich::datetime::timestamp());
+
+    if (!m_TraceFilename.empty()) {
+        if (tracing) {
+            m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Tracing to %"), m_TraceFilename);
+        }
+        else {
+            m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Unable to open trace file %"), m_TraceFilename);
+        }
+    }
 
     int initresult = OST_ERROR_OK;
 
@@ -66,21 +154,28 @@ int ostrich::Main::Initialize() {
     try {
 
         if (initresult == OST_ERROR_OK) {
-            m_ConsolePrinter.WriteMessage(u8"Initializing Event Queue");
-            initresult = m_EventQueue.Initialize();
+            int32_t workers = m_JobSystem.Initialize();
+            m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Job system running % worker threads"), workers);
         }
 
         if (initresult == OST_ERROR_OK) {
+            m_ConsolePrinter.WriteMessage(u8"Initializing Event Queue");
+            initresult = m_EventQueue.Initialize(journalmode);
+            m_EventQueue.setCoalescing(true);
+            m_UpdateBatch.reserve(ostrich::EventQueue::QUEUE_CAPACITY);
+        }
+
+        if ((initresult == OST_ERROR_OK) && (m_Display != nullptr)) {
             m_ConsolePrinter.WriteMessage(u8"Initializing Display");
             initresult = m_Display->Initialize(m_Console.CreatePrinter());
         }
 
-        if (initresult == OST_ERROR_OK) {
+        if ((initresult == OST_ERROR_OK) && (m_Renderer != nullptr)) {
             m_ConsolePrinter.WriteMessage(u8"Initializing Renderer");
             initresult = m_Renderer->Initialize(m_Console.CreatePrinter());
         }
 
-        if (initresult == OST_ERROR_OK) {
+        if ((initresult == OST_ERROR_OK) && (m_Input != nullptr)) {
             m_ConsolePrinter.WriteMessage(u8"Initializing Input Handler");
             initresult = m_Input->Initialize(m_Console.CreatePrinter(), m_EventQueue.CreateSender());
         }
@@ -89,24 +184,28 @@ int ostrich::Main::Initialize() {
             m_ConsolePrinter.WriteMessage(u8"Initializing State Machine");
             initresult = m_GameState.Initialize(m_Console.CreatePrinter(), m_EventQueue.CreateSender());
         }
+
+        if (initresult == OST_ERROR_OK) {
+            this->RegisterHandlers();
+        }
     }
     catch (const ostrich::ProxyException &e) {
-        m_ConsolePrinter.WriteMessage(u8"% at %", { e.what(), e.where() });
+        m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"% at %"), e.what(), e.where());
         initresult = OST_ERROR_EXCEPTPROXY;
     }
     catch (const ostrich::InitException &e) {
-        m_ConsolePrinter.WriteMessage(u8"% at %, our error code %", { e.what(), e.where(), std::to_string(e.getOurCode()) });
+        m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"% at %, our error code %"), e.what(), e.where(), e.getOurCode());
         if (e.hasReturnedCode()) {
-            m_ConsolePrinter.WriteMessage(u8"Additional code %", { std::to_string(e.getReturnedCode()) });
+            m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Additional code %"), e.getReturnedCode());
         }
         initresult = OST_ERROR_EXCEPTINIT;
     }
     catch (const ostrich::Exception &e) {
-        m_ConsolePrinter.WriteMessage(u8"% from unknown location", { e.what() });
+        m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"% from unknown location"), e.what());
         initresult = OST_ERROR_EXCEPTGENERIC;
     }
     catch (const std::exception &e) {
-        m_ConsolePrinter.WriteMessage(u8"std::exception: %", { e.what() });
+        m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"std::exception: %"), e.what());
         initresult = OST_ERROR_EXCEPTCPP;
     }
     catch (...) {
@@ -117,10 +216,10 @@ int ostrich::Main::Initialize() {
     if (initresult == OST_ERROR_OK) {
         auto finish = ostrich::timer::now();
         int32_t duration = ostrich::timer::interval(start, finish);
-        m_ConsolePrinter.WriteMessage(u8"Initialization complete in % milliseconds", { std::to_string(duration) });
+        m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Initialization complete in % milliseconds"), duration);
     }
     else {
-        m_ConsolePrinter.WriteMessage(u8"Bizzare initialization failure, code: %", { std::to_string(initresult) });
+        m_ConsolePrinter.ErrorMessage(OST_FORMAT(u8"Bizzare initialization failure, code: %"), initresult);
     }
 
     return initresult;
@@ -131,6 +230,21 @@ int ostrich::Main::Initialize() {
 void ostrich::Main::Destroy() {
     if (m_isActive) {
         m_Console.WriteMessage(u8"Shutting down...");
+        if (m_Profiler.isEnabled()) {
+            m_Profiler.WriteSummary(m_ConsolePrinter);
+        }
+        if (m_Display != nullptr) {
+            m_Pacer.WriteSummary(m_ConsolePrinter);
+        }
+        this->WriteQueueStats();
+        if (m_SkippedUpdates > 0) {
+            m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Main loop fell behind; skipped % updates"), m_SkippedUpdates);
+        }
+        if (m_EventQueue.getCoalescedTotal() > 0) {
+            m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Input coalescing dropped % messages over % updates, at most % in one update"),
+                m_EventQueue.getCoalescedTotal(), m_UpdateTick,
+                m_EventQueue.getCoalescedPeak());
+        }
         if (m_Input) {
             m_Input->Destroy();
             m_Input = nullptr;
@@ -143,6 +257,17 @@ void ostrich::Main::Destroy() {
             m_Display->Destroy();
             m_Display = nullptr;
         }
+        m_Dispatcher.Clear();
+        m_EventQueue.Destroy();
+        m_JobSystem.Destroy();
+        m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Job system ran % jobs, % stolen"),
+            m_JobSystem.getExecutedCount(), m_JobSystem.getStolenCount());
+        if (m_Tracer.isRecording()) {
+            m_Tracer.Destroy();
+            if (m_Tracer.getDroppedCount() > 0) {
+                m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Trace ring full; dropped % events"), m_Tracer.getDroppedCount());
+            }
+        }
         m_Console.Destroy();
         m_isActive = false;
     }
@@ -151,38 +276,197 @@ void ostrich::Main::Destroy() {
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 void ostrich::Main::Run() {
-    int32_t lag = 0;
-    const double updatespersec = 60.0;
-    const int32_t msperupdate = static_cast<int32_t>((1.0 / updatespersec) * 1000.0);
-
+    UpdateClockTicks lag(0);
     auto prevtick = ostrich::timer::now();
-    auto currtick = prevtick;
     bool done = false;
-    int32_t elapsedtime = 0;
-    //double fps = 0.0;
+    m_Profiler.setBudget(std::chrono::duration_cast<std::chrono::nanoseconds>(UPDATE_INTERVAL).count());
+    m_Pacer.Start();
     while (!done) {
-        currtick = ostrich::timer::now();
-        elapsedtime = ostrich::timer::interval(prevtick, currtick);
-        prevtick = currtick;
-        lag += elapsedtime;
-
-        /*
-        if (elapsedtime > 0)
-            fps = static_cast<double>(1.0 / static_cast<double>(elapsedtime)) * 1000.0;
-        */
-
-        this->ProcessInput();
-        while ((lag >= msperupdate) && (!done)) { // no need to update state if done
-            done = this->UpdateState();
-            lag -= msperupdate;
-        }
-        this->RenderScene(lag / msperupdate);
+        OST_TRACE_SCOPE("Frame");
+        m_Profiler.BeginFrame();
+
+        {
+            ostrich::FrameProfiler::StageTimer timer(m_Profiler, ostrich::FrameProfiler::Stage::STAGE_INPUT);
+            this->ProcessInput();
+        }
+        {
+            ostrich::FrameProfiler::StageTimer timer(m_Profiler, ostrich::FrameProfiler::Stage::STAGE_UPDATE);
+            done = this->RunDueUpdates(lag, prevtick);
+        }
+        {
+            ostrich::FrameProfiler::StageTimer timer(m_Profiler, ostrich::FrameProfiler::Stage::STAGE_RENDER);
+            this->RenderScene(m_GameState.GetSceneData(),
+                static_cast<double>(lag.count()) / static_cast<double>(UPDATE_INTERVAL.count()));
+        }
+        m_EventQueue.FlushJournal();
+        m_Console.Flush();
+
+        // measured after the frame is closed so waiting doesn't count against the frame budget
+        this->FinishFrame();
+        if (!done) {
+            m_Pacer.Wait();
+        }
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::Main::RunThreaded() {
+    m_Profiler.setBudget(std::chrono::duration_cast<std::chrono::nanoseconds>(UPDATE_INTERVAL).count());
+    m_isSimulationDone.store(false, std::memory_order_relaxed);
+    m_SimulationError = nullptr;
+    std::thread simulation(&Main::SimulationThread, this);
+
+    // whatever happens on this thread, the simulation has to be stopped before it goes out of scope
+    auto stopsimulation = [this, &simulation]() {
+        m_isSimulationDone.store(true, std::memory_order_release);
+        if (simulation.joinable()) {
+            simulation.join();
+        }
+    };
+
+    try {
+        bool done = false;
+        bool havesnapshot = false;
+        m_Pacer.Start();
+        while (!done) {
+            OST_TRACE_SCOPE("Frame");
+            m_Profiler.BeginFrame();
+
+            {
+                ostrich::FrameProfiler::StageTimer timer(m_Profiler, ostrich::FrameProfiler::Stage::STAGE_INPUT);
+                this->ProcessInput();
+            }
+            {
+                ostrich::FrameProfiler::StageTimer timer(m_Profiler, ostrich::FrameProfiler::Stage::STAGE_RENDER);
+                // the front buffer is default constructed until the simulation's first Publish(); draw nothing till then
+                if (m_SceneSnapshots.Acquire()) {
+                    havesnapshot = true;
+                }
+                if (havesnapshot) {
+                    const SceneSnapshot &snapshot = m_SceneSnapshots.getReadBuffer();
+                    double alpha = std::chrono::duration<double>(ostrich::timer::now() - snapshot.m_UpdateTime) /
+                        std::chrono::duration<double>(UPDATE_INTERVAL);
+                    this->RenderScene(&snapshot.m_Scene, std::clamp(alpha, 0.0, 1.0));
+                }
+            }
+            m_Console.Flush();
+
+            this->FinishFrame();
+            done = m_isSimulationDone.load(std::memory_order_acquire);
+            if (!done) {
+                m_Pacer.Wait();
+            }
+        }
+    }
+    catch (...) {
+        stopsimulation();
+        throw;
+    }
+
+    stopsimulation();
+
+    // an exception on the simulation thread surfaces here, where the caller's handlers and Destroy() still run
+    if (m_SimulationError) {
+        std::exception_ptr error = m_SimulationError;
+        m_SimulationError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::Main::SimulationThread() {
+    OST_TRACE_THREAD("Simulation");
+
+    UpdateClockTicks lag(0);
+    auto prevtick = ostrich::timer::now();
+    uint32_t publishedtick = m_UpdateTick - 1; // so the starting state gets published
+
+    // nothing may escape this thread (that would be std::terminate); hand the exception to RunThreaded() instead
+    try {
+        while (!m_isSimulationDone.load(std::memory_order_acquire)) {
+            bool done = this->RunDueUpdates(lag, prevtick);
+
+            if (m_UpdateTick != publishedtick) {
+                OST_TRACE_SCOPE("PublishScene");
+                SceneSnapshot &snapshot = m_SceneSnapshots.getWriteBuffer();
+                snapshot.m_Scene = *m_GameState.GetSceneData();
+                snapshot.m_UpdateTime = prevtick - std::chrono::duration_cast<ostrich::timer::clock::duration>(lag);
+                m_SceneSnapshots.Publish();
+                publishedtick = m_UpdateTick;
+                m_EventQueue.FlushJournal(); // the journal belongs to whoever pops the queue
+            }
+
+            if (done) {
+                m_isSimulationDone.store(true, std::memory_order_release);
+                break;
+            }
+
+            // sleep until the next update is due
+            std::this_thread::sleep_until(prevtick + std::chrono::duration_cast<ostrich::timer::clock::duration>(UPDATE_INTERVAL - lag));
+        }
+    }
+    catch (...) {
+        m_SimulationError = std::current_exception();
+        m_isSimulationDone.store(true, std::memory_order_release);
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::Main::RunDueUpdates(UpdateClockTicks &lag, ostrich::timer::time_point &prevtick) {
+    constexpr UpdateClockTicks maxlag = UPDATE_INTERVAL * g_MaxUpdatesPerFrame;
+
+    auto currtick = ostrich::timer::now();
+    lag += (currtick - prevtick);
+    prevtick = currtick;
+
+    // spiral of death: after a long stall (debugger, window drag, slow disk), slow the game down instead
+    if (lag > maxlag) {
+        int64_t skipped = (lag - maxlag) / UPDATE_INTERVAL;
+        m_SkippedUpdates += static_cast<uint64_t>(skipped);
+        OST_LOG_DEBUG(m_ConsolePrinter, ostrich::LogCategory::LOG_CORE,
+            OST_FORMAT(u8"Main loop fell behind by % ms; skipping % updates"),
+            std::chrono::duration<double, std::milli>(lag).count(), skipped);
+        lag = maxlag + (lag % UPDATE_INTERVAL);
+    }
+
+    bool done = false;
+    while ((lag >= UPDATE_INTERVAL) && (!done)) { // no need to update state if done
+        done = this->UpdateState();
+        lag -= UPDATE_INTERVAL;
+    }
+    return done;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::Main::FinishFrame() {
+    if (m_Profiler.EndFrame()) {
+        OST_LOG_DEBUG(m_ConsolePrinter, ostrich::LogCategory::LOG_CORE,
+            OST_FORMAT(u8"Frame % over budget: % ms (input % ms, update % ms, render % ms)"),
+            m_Profiler.getFrameCount(),
+            static_cast<double>(m_Profiler.getLastTime(ostrich::FrameProfiler::Stage::STAGE_FRAME)) / 1.0e6,
+            static_cast<double>(m_Profiler.getLastTime(ostrich::FrameProfiler::Stage::STAGE_INPUT)) / 1.0e6,
+            static_cast<double>(m_Profiler.getLastTime(ostrich::FrameProfiler::Stage::STAGE_UPDATE)) / 1.0e6,
+            static_cast<double>(m_Profiler.getLastTime(ostrich::FrameProfiler::Stage::STAGE_RENDER)) / 1.0e6);
+    }
+
+    if (m_ProfileRequested.exchange(false, std::memory_order_relaxed)) {
+        if (m_Profiler.isEnabled()) {
+            m_Profiler.WriteSummary(m_ConsolePrinter);
+        }
+        else {
+            m_ConsolePrinter.WriteMessage(u8"Frame profiler is disabled");
+        }
     }
 }
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 void ostrich::Main::ProcessInput() {
+    OST_TRACE_SCOPE("ProcessInput");
     if (m_Input) {
         m_Input->ProcessOSMessages();
         m_Input->ProcessKBM();
@@ -192,28 +476,102 @@ void ostrich::Main::ProcessInput() {
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 bool ostrich::Main::UpdateState() {
-    while (m_EventQueue.isPending()) {
-        auto queuemsg = m_EventQueue.Pop();
-        if (queuemsg.has_value()) {
-            ostrich::Message msg = queuemsg.value();
-            if ((msg.getType() >= ostrich::Message::Type::INPUT_START) &&
-                (msg.getType() <= ostrich::Message::Type::INPUT_LAST)) {
-                // update state based on input
-                m_GameState.ProcessInput(msg);
-            }
-            else if (msg.getType() == ostrich::Message::Type::SYSTEM) {
-                // process system-type messages
-                return this->ProcessSystemMessage(msg);
-            }
-            else {
-                m_ConsolePrinter.WriteMessage(u8"Unhandled message type % sent by %",
-                    { std::to_string(msg.getTypeAsInt()),
-                      msg.getSender() });
-            }
+    OST_TRACE_SCOPE("UpdateState");
+    m_EventQueue.setUpdateTick(m_UpdateTick++);
+
+    // system messages first, so a quit or signal doesn't wait behind an input backlog
+    m_UpdateBatch.clear();
+    m_EventQueue.PopAll(ostrich::EventQueue::Lane::LANE_HIGH, m_UpdateBatch);
+    if (!m_UpdateBatch.empty()) {
+        for (const auto &msg : m_UpdateBatch) {
+            m_Dispatcher.Collect(msg);
+        }
+        if (m_Dispatcher.Dispatch()) {
+            return true; // whatever's still in the normal lane doesn't matter anymore
         }
     }
 
-    return false;
+    // only drain what's queued now; other threads may keep pushing while we work
+    m_UpdateBatch.clear();
+    std::size_t coalesced = m_EventQueue.PopAll(ostrich::EventQueue::Lane::LANE_NORMAL, m_UpdateBatch);
+    if (coalesced > 0) {
+        OST_LOG_TRACE(m_ConsolePrinter, ostrich::LogCategory::LOG_EVENTS,
+            OST_FORMAT(u8"Update % coalesced % input messages"), m_UpdateTick - 1, coalesced);
+    }
+    OST_TRACE_COUNTER("Messages per update", m_UpdateBatch.size());
+    OST_TRACE_COUNTER("Coalesced per update", coalesced);
+
+    for (const auto &msg : m_UpdateBatch) {
+        m_Dispatcher.Collect(msg);
+    }
+
+    return m_Dispatcher.Dispatch();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::Main::WriteQueueStats() {
+    static constexpr std::pair<ostrich::EventQueue::Lane, const char *> lanes[] = {
+        { ostrich::EventQueue::Lane::LANE_HIGH, u8"High" },
+        { ostrich::EventQueue::Lane::LANE_NORMAL, u8"Normal" }
+    };
+
+    for (const auto &lane : lanes) {
+        const auto &stats = m_EventQueue.getLaneStats(lane.first);
+        double avgage = (stats.m_Popped > 0) ? (static_cast<double>(stats.m_TotalAge) / static_cast<double>(stats.m_Popped) / 1.0e6) : 0.0;
+        m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"% priority lane: % popped, % waiting, peak depth %, age avg % ms max % ms, % dropped"),
+            lane.second, stats.m_Popped, m_EventQueue.getLaneDepth(lane.first),
+            stats.m_PeakDepth, avgage,
+            static_cast<double>(stats.m_MaxAge) / 1.0e6,
+            m_EventQueue.getDroppedCount(lane.first));
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::Main::RegisterHandlers() {
+    m_Dispatcher.Clear();
+
+    m_Dispatcher.Subscribe(ostrich::Message::Type::SYSTEM,
+        [this](const ostrich::Message *msgs, std::size_t count) {
+            for (std::size_t i = 0; i < count; i++) {
+                if (this->ProcessSystemMessage(msgs[i]))
+                    return true;
+            }
+            return false;
+        });
+
+    // update state based on input
+    auto gameinput = [this](const ostrich::Message *msgs, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            m_GameState.ProcessInput(msgs[i]);
+        }
+        return false;
+    };
+    m_Dispatcher.Subscribe(ostrich::Message::Type::INPUT_KEY, gameinput);
+    m_Dispatcher.Subscribe(ostrich::Message::Type::INPUT_BUTTON, gameinput);
+    m_Dispatcher.Subscribe(ostrich::Message::Type::INPUT_MOUSEPOS, gameinput);
+
+    // F12 asks for a profiler summary; goes through the queue so anything else can ask the same way
+    m_Dispatcher.Subscribe(ostrich::Message::Type::INPUT_KEY,
+        [this](const ostrich::Message *msgs, std::size_t count) {
+            for (std::size_t i = 0; i < count; i++) {
+                auto key = msgs[i].getKeyStatus();
+                if ((key.first == static_cast<int32_t>(ostrich::Keys::OSTKEY_F12)) && key.second) {
+                    m_EventQueue.CreateSender().Send(ostrich::Message::CreateSystemMessage(OST_SYSTEMMSG_PROFILE, 0, m_Classname));
+                }
+            }
+            return false;
+        });
+
+    m_Dispatcher.setUnhandled(
+        [this](const ostrich::Message *msgs, std::size_t count) {
+            m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Unhandled message type % sent by % (% total)"),
+                msgs[0].getTypeAsInt(),
+                (msgs[0].getSender() != nullptr) ? msgs[0].getSender() : u8"",
+                count);
+            return false;
+        });
 }
 
 /////////////////////////////////////////////////
@@ -222,25 +580,36 @@ bool ostrich::Main::ProcessSystemMessage(const ostrich::Message &msg) {
     switch (msg.getSystemCode()) {
         case OST_SYSTEMMSG_QUIT:
         {
-            m_ConsolePrinter.DebugMessage(u8"Shutdown received from %",
-                { msg.getSender() });
+            OST_LOG_DEBUG(m_ConsolePrinter, ostrich::LogCategory::LOG_CORE,
+                OST_FORMAT(u8"Shutdown received from %"), msg.getSender());
             return true;
         }
         case OST_SYSTEMMSG_SIGNAL:
         {
             int32_t signal = msg.getSystemAddlData();
-            m_ConsolePrinter.DebugMessage(u8"Signal raised: %",
-                { std::to_string(signal) });
+            OST_LOG_DEBUG(m_ConsolePrinter, ostrich::LogCategory::LOG_CORE,
+                OST_FORMAT(u8"Signal raised: %"), signal);
             if ((signal == SIGINT) || (signal == SIGTERM) || (signal == SIGHUP)) {
                 return true;
             }
             break;
         }
+        case OST_SYSTEMMSG_PROFILE:
+        {
+            // the profiler belongs to the render loop, which writes the summary at the end of its frame
+            m_ProfileRequested.store(true, std::memory_order_relaxed);
+            break;
+        }
+        case OST_SYSTEMMSG_FOCUSLOST:
+        {
+            // the event queue has already forgotten which keys were down
+            break;
+        }
         case OST_SYSTEMMSG_NULL:
         default:
         {
-            m_ConsolePrinter.DebugMessage(u8"Unknown system message %",
-                { std::to_string(msg.getSystemCode()) });
+            OST_LOG_WARNING(m_ConsolePrinter, ostrich::LogCategory::LOG_CORE,
+                OST_FORMAT(u8"Unknown system message %"), msg.getSystemCode());
         }
     }
 
@@ -249,15 +618,14 @@ bool ostrich::Main::ProcessSystemMessage(const ostrich::Message &msg) {
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-void ostrich::Main::RenderScene(int32_t extrapolation) {
-    OST_UNUSED_PARAMETER(extrapolation);
+void ostrich::Main::RenderScene(const ostrich::SceneData *scenedata, double alpha) {
+    OST_TRACE_SCOPE("RenderScene");
     if (m_Renderer && m_Display) {
-        auto scenedata = m_GameState.GetSceneData();
         if (scenedata == nullptr) {
 
         }
         else {
-            m_Renderer->RenderScene(scenedata, extrapolation);
+            m_Renderer->RenderScene(scenedata, alpha);
             m_Display->SwapBuffers();
         }
     }
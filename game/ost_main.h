@@ -9,12 +9,27 @@ Main game object
 #ifndef OSTRICH_OST_MAIN_H_
 #define OSTRICH_OST_MAIN_H_
 
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <ratio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "eventdispatcher.h"
 #include "eventqueue.h"
+#include "framepacer.h"
+#include "frameprofiler.h"
 #include "i_display.h"
 #include "i_input.h"
 #include "i_renderer.h"
+#include "scenedata.h"
 #include "../common/console.h"
+#include "../common/datetime.h"
+#include "../common/jobsystem.h"
 #include "../common/ost_common.h"
+#include "../common/trace.h"
+#include "../common/triplebuffer.h"
 #include "../minesweeper/ms_statemachine.h"
 
 namespace ostrich {
@@ -48,6 +63,60 @@ public:
     //      the result of Initialize()
     int Start(IDisplay *display, IRenderer *renderer, IInput *input);
 
+    /////////////////////////////////////////////////
+    // Run the game headless, feeding it a recorded event journal instead of live input
+    // No display, renderer or input device is created; only the console, event queue and game state.
+    // Each recorded message is pushed right before the fixed-timestep update it was originally popped in,
+    // so the game state goes through the same sequence of updates it did while recording.
+    // Returns when the journal runs out or the game asks to quit; throughput is reported to the console and stdout.
+    //
+    // in:
+    //      journalfile - the binary journal (message.jnl) to replay
+    //      realtime - if true, pace updates at the normal update rate; otherwise run them as fast as possible
+    // returns:
+    //      the result of Initialize(), or OST_ERROR_REPLAYLOAD if the journal couldn't be read
+    int Replay(std::string_view journalfile, bool realtime);
+
+    /////////////////////////////////////////////////
+    // Record a timeline trace of the run (see trace.h)
+    // Must be called before Start() or Replay(); tracing starts with the console
+    //
+    // in:
+    //      filename - the Chrome trace-event JSON file to write
+    // returns:
+    //      void
+    void EnableTracing(std::string_view filename) { m_TraceFilename = filename; }
+
+    /////////////////////////////////////////////////
+    // Turn the frame profiler on or off (see frameprofiler.h)
+    // On by default in debug builds. The summary is written at shutdown, or whenever F12 is pressed.
+    //
+    // in:
+    //      enabled - true to profile every frame
+    // returns:
+    //      void
+    void EnableProfiling(bool enabled) noexcept { m_Profiler.setEnabled(enabled); }
+
+    /////////////////////////////////////////////////
+    // Set the frame rate the main loop paces itself to (see framepacer.h)
+    // Defaults to the update rate. With vsync on, the swap usually does the waiting and the pacer has little to do.
+    //
+    // in:
+    //      framespersecond - the target rate; 0 to run frames back to back, as fast as possible
+    // returns:
+    //      void
+    void setTargetFrameRate(double framespersecond) noexcept { m_Pacer.setTargetRate(framespersecond); }
+
+    /////////////////////////////////////////////////
+    // Run the simulation on its own thread (see RunThreaded())
+    // Must be called before Start(); off by default
+    //
+    // in:
+    //      threaded - true to update and render on separate threads
+    // returns:
+    //      void
+    void setThreadedMode(bool threaded) noexcept { m_isThreaded = threaded; }
+
     /////////////////////////////////////////////////
     // Clean up the game after a successful (or unsuccessful) run.
     // Should be called manually after Start() returns.
@@ -58,14 +127,31 @@ public:
 
 private:
 
+    /////////////////////////////////////////////////
+    // The fixed-timestep clock counts in 1/UPDATES_PER_SECOND nanoseconds, so one update is a whole number of ticks (1e9)
+    // and time read from timer::clock converts exactly; nothing is lost to rounding however long the game runs
+    static constexpr int64_t UPDATES_PER_SECOND = 60;
+    using UpdateClockTicks = std::chrono::duration<int64_t, std::ratio<1, 1'000'000'000 * UPDATES_PER_SECOND>>;
+    static constexpr UpdateClockTicks UPDATE_INTERVAL = UpdateClockTicks(1'000'000'000);
+
+    /////////////////////////////////////////////////
+    // What the simulation thread hands the render thread after each batch of updates
+    struct SceneSnapshot {
+        SceneData m_Scene;
+        ostrich::timer::time_point m_UpdateTime;   // the point in time the last update brought the game up to
+    };
+
     /////////////////////////////////////////////////
     // Initialize each subsystem.
     // Should not throw any exceptions from initialization; return a code if something goes wrong.
     // See errorcodes.h for a list
+    // Display, renderer and input are skipped if they weren't provided (headless replay)
     //
+    // in:
+    //      journalmode - how the event queue should journal messages
     // returns:
     //      An error code (OST_ERROR_OK (0) is the only successful code)
-    int Initialize();
+    int Initialize(EventQueue::JournalMode journalmode);
 
     /////////////////////////////////////////////////
     // Run the main game loop.
@@ -75,6 +161,42 @@ private:
     //      void
     void Run();
 
+    /////////////////////////////////////////////////
+    // Run the main game loop with the simulation on its own thread.
+    // This thread keeps input and rendering (both tied to the window), and draws the newest SceneSnapshot the
+    // simulation has published; update cost no longer adds to frame time. Returns once the simulation is done.
+    // The profiler's update stage reads 0 in this mode; a trace shows the simulation thread's updates instead.
+    //
+    // returns:
+    //      void
+    void RunThreaded();
+
+    /////////////////////////////////////////////////
+    // Simulation thread body for RunThreaded(): run updates as they come due and publish a snapshot after each batch
+    // An exception ends the thread and is kept for RunThreaded() to rethrow
+    //
+    // returns:
+    //      void
+    void SimulationThread();
+
+    /////////////////////////////////////////////////
+    // Advance the fixed-timestep clock to now and run the updates that have come due
+    // If the game has fallen more than a few updates behind, the rest of the backlog is skipped (spiral-of-death clamp)
+    //
+    // in/out:
+    //      lag - time not yet simulated
+    //      prevtick - when the clock was last advanced; set to now
+    // returns:
+    //      true if the game should stop running (is "done")
+    bool RunDueUpdates(UpdateClockTicks &lag, ostrich::timer::time_point &prevtick);
+
+    /////////////////////////////////////////////////
+    // Close the profiler's frame, log it if it went over budget, and write a summary if one was asked for
+    //
+    // returns:
+    //      void
+    void FinishFrame();
+
     /////////////////////////////////////////////////
     // Invoke the IInput object to process OS and device input messages.
     //
@@ -82,9 +204,26 @@ private:
     //      void
     void ProcessInput();
 
+    /////////////////////////////////////////////////
+    // Write the event queue's per-lane depth, age and drop statistics to the console
+    //
+    // returns:
+    //      void
+    void WriteQueueStats();
+
+    /////////////////////////////////////////////////
+    // Subscribe Main and the game state to the message types they handle.
+    // Called once the subsystems are initialized; anything left over is logged as unhandled.
+    //
+    // returns:
+    //      void
+    void RegisterHandlers();
+
     /////////////////////////////////////////////////
     // Event Queue message pump.
-    // Updates the state manager and processes system messages.
+    // Pops what's queued and hands it to the dispatcher, which delivers it in arrival order to subscribers.
+    // The high-priority lane is dispatched first; if that ends the game, the normal lane is left alone.
+    // Each call is one fixed-timestep update and advances m_UpdateTick.
     //
     // returns:
     //      true if the game should stop running (is "done")
@@ -102,10 +241,15 @@ private:
     // Currently does very little apart from call the IRenderer and swap buffers, but will become more complex as features are added.
     //
     // in:
-    //      extrapolation - how far into the next frame we are, in milliseconds (lag/msperframe)
-    void RenderScene(int32_t extrapolation);
+    //      scenedata - the scene to draw
+    //      alpha - how far this frame is between the last update and the next, from 0 to 1 (for interpolating)
+    // returns:
+    //      void
+    void RenderScene(const SceneData *scenedata, double alpha);
 
     bool m_isActive;
+    uint32_t m_UpdateTick; // number of fixed-timestep updates run so far
+    uint64_t m_SkippedUpdates; // updates dropped because the loop fell too far behind
 
     const char *const m_Classname = u8"ostrich::Main"; // for exception reporting
 
@@ -116,7 +260,23 @@ private:
     Console m_Console;
     ConsolePrinter m_ConsolePrinter;
 
+    Tracer m_Tracer;
+    std::string m_TraceFilename; // empty if not tracing
+
+    JobSystem m_JobSystem; // subsystems reach it through JobSystem::getActive()
+
+    FrameProfiler m_Profiler;
+    FramePacer m_Pacer;
+    std::atomic<bool> m_ProfileRequested; // set by OST_SYSTEMMSG_PROFILE, which may arrive on the simulation thread
+
+    bool m_isThreaded;
+    std::atomic<bool> m_isSimulationDone;
+    std::exception_ptr m_SimulationError; // thrown on the simulation thread; rethrown by RunThreaded() after the join
+    TripleBuffer<SceneSnapshot> m_SceneSnapshots; // simulation thread publishes, render thread acquires
+
     EventQueue m_EventQueue;
+    EventDispatcher m_Dispatcher;
+    std::vector<Message> m_UpdateBatch; // messages popped for the current update; keeps its capacity
 
     // game dependent - lives in the game's folder
     ms::StateMachine m_GameState;
@@ -0,0 +1,103 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "scenedata.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+/////////////////////////////////////////////////
+// Rearrange one array into the given order, going through a scratch array and swapping it in
+// The old array becomes the new scratch, so both keep their capacity
+template <typename T>
+void Permute(std::vector<T> &values, const std::vector<uint32_t> &order, std::vector<T> &scratch) {
+    scratch.resize(values.size());
+    for (std::size_t i = 0; i < order.size(); i++) {
+        scratch[i] = values[order[i]];
+    }
+    values.swap(scratch);
+}
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::SceneData::ClearSprites() noexcept {
+    m_XPositions.clear();
+    m_YPositions.clear();
+    m_Widths.clear();
+    m_Heights.clear();
+    m_TextureIds.clear();
+    m_TexLefts.clear();
+    m_TexTops.clear();
+    m_TexRights.clear();
+    m_TexBottoms.clear();
+    m_LayerKeys.clear();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::SceneData::ReserveSprites(std::size_t count) {
+    m_XPositions.reserve(count);
+    m_YPositions.reserve(count);
+    m_Widths.reserve(count);
+    m_Heights.reserve(count);
+    m_TextureIds.reserve(count);
+    m_TexLefts.reserve(count);
+    m_TexTops.reserve(count);
+    m_TexRights.reserve(count);
+    m_TexBottoms.reserve(count);
+    m_LayerKeys.reserve(count);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+std::size_t ostrich::SceneData::AddSprite(float xpos, float ypos, float width, float height,
+    ostrich::TextureId texture, uint32_t layer) {
+    return this->AddSprite(xpos, ypos, width, height, texture, { 0.0f, 0.0f, 1.0f, 1.0f }, layer);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+std::size_t ostrich::SceneData::AddSprite(float xpos, float ypos, float width, float height,
+    ostrich::TextureId texture, const ostrich::TextureRect &rect, uint32_t layer) {
+    m_XPositions.push_back(xpos);
+    m_YPositions.push_back(ypos);
+    m_Widths.push_back(width);
+    m_Heights.push_back(height);
+    m_TextureIds.push_back(texture);
+    m_TexLefts.push_back(rect.m_Left);
+    m_TexTops.push_back(rect.m_Top);
+    m_TexRights.push_back(rect.m_Right);
+    m_TexBottoms.push_back(rect.m_Bottom);
+    m_LayerKeys.push_back(layer);
+    return m_TextureIds.size() - 1;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::SceneData::SortByLayer() {
+    if (std::is_sorted(m_LayerKeys.begin(), m_LayerKeys.end()))
+        return;
+
+    m_SortOrder.resize(m_LayerKeys.size());
+    std::iota(m_SortOrder.begin(), m_SortOrder.end(), 0);
+    std::stable_sort(m_SortOrder.begin(), m_SortOrder.end(),
+        [this](uint32_t left, uint32_t right) { return (m_LayerKeys[left] < m_LayerKeys[right]); });
+
+    Permute(m_XPositions, m_SortOrder, m_SortFloats);
+    Permute(m_YPositions, m_SortOrder, m_SortFloats);
+    Permute(m_Widths, m_SortOrder, m_SortFloats);
+    Permute(m_Heights, m_SortOrder, m_SortFloats);
+    Permute(m_TextureIds, m_SortOrder, m_SortKeys);
+    Permute(m_TexLefts, m_SortOrder, m_SortFloats);
+    Permute(m_TexTops, m_SortOrder, m_SortFloats);
+    Permute(m_TexRights, m_SortOrder, m_SortFloats);
+    Permute(m_TexBottoms, m_SortOrder, m_SortFloats);
+    Permute(m_LayerKeys, m_SortOrder, m_SortKeys);
+}
@@ -13,17 +13,38 @@ Probably need some standard data structure for text as well.
 
 The data should be in a Canary-standard format and translated by the renderer.
 I am hoping any optimization can be done in the collection of scene data so there's less renderer-specific code.
+
+Entities reach the renderer as a render list of sprites, stored as a structure of arrays: one contiguous array
+each for positions, sizes, texture IDs, texture rectangles and layer keys. A renderer walks the arrays linearly (or copies them
+straight into GPU buffers) instead of chasing one heap node per entity. The game clears and refills the list
+every update; the arrays keep their capacity, so a steady scene doesn't allocate.
+A sprite draws the whole of its texture unless it's given a TextureRect, which is how sprites packed into a
+TextureAtlas share one texture (and one draw call).
+
+The map is a TileMap, drawn underneath the sprites. Unlike the render list it isn't rebuilt every update:
+the game edits the tiles that change and the renderer re-uploads only those rows.
 ==========================================
 */
 
 #ifndef OSTRICH_SCENEDATA_H_
 #define OSTRICH_SCENEDATA_H_
 
-#include <list>
-#include "i_entity.h"
+#include <cstdint>
+#include <vector>
+#include "tilemap.h"
+#include "../common/ost_common.h"
 
 namespace ostrich {
 
+/////////////////////////////////////////////////
+// The part of a texture a sprite shows, in texture coordinates from 0 to 1 (top left is 0, 0)
+struct TextureRect {
+    float m_Left;
+    float m_Top;
+    float m_Right;
+    float m_Bottom;
+};
+
 /////////////////////////////////////////////////
 //
 class SceneData {
@@ -32,22 +53,21 @@ public:
     /////////////////////////////////////////////////
     // Constructor is effectively default. No doubt I will need new constructors or data setters over time.
     // Destructor can do nothing because all data is either simple or has its own destructors
-    // Copy/move constructors/operators are deleted for performance reasons (this may have to change)
+    // Copy/move constructors/operators are default; the threaded game loop publishes copies of it to the renderer
+    // (copying into an existing SceneData reuses its arrays)
     SceneData() noexcept :
         m_ClearColorRed(0.0f), m_ClearColorGreen(0.0f), m_ClearColorBlue(0.0f), m_ClearColorAlpha(1.0f) {}
     virtual ~SceneData() {}
-    SceneData(SceneData &&) = delete;
-    SceneData(const SceneData &) = delete;
-    SceneData &operator=(SceneData &&) = delete;
-    SceneData &operator=(const SceneData &) = delete;
+    SceneData(SceneData &&) = default;
+    SceneData(const SceneData &) = default;
+    SceneData &operator=(SceneData &&) = default;
+    SceneData &operator=(const SceneData &) = default;
 
     /////////////////////////////////////////////////
     // set the screen clear color
     //
     // in:
-    //      source - a UTF-8 encoded C++ string
-    // out:
-    //      destination - a UTF-16 encoded C++ string; original contents are destroyed
+    //      red, green, blue, alpha - color components, from 0 to 1
     // returns:
     //      void
     void setClearColor(float red, float green, float blue, float alpha) noexcept
@@ -55,6 +75,56 @@ public:
         m_ClearColorRed = red; m_ClearColorGreen = green; m_ClearColorBlue = blue; m_ClearColorAlpha = alpha;
     }
 
+    /////////////////////////////////////////////////
+    // Empty the render list, keeping its memory for the next update
+    // The clear color is left alone
+    //
+    // returns:
+    //      void
+    void ClearSprites() noexcept;
+
+    /////////////////////////////////////////////////
+    // Make room for a number of sprites, so filling the list doesn't reallocate part way through
+    //
+    // in:
+    //      count - the number of sprites expected
+    // returns:
+    //      void
+    void ReserveSprites(std::size_t count);
+
+    /////////////////////////////////////////////////
+    // Add a sprite to the render list
+    //
+    // in:
+    //      xpos, ypos - top left corner, in screen pixels
+    //      width, height - size in screen pixels
+    //      texture - the texture to draw it with
+    //      layer - draw order key; lower layers are drawn first (see SortByLayer())
+    // returns:
+    //      the sprite's index in the arrays
+    std::size_t AddSprite(float xpos, float ypos, float width, float height, TextureId texture, uint32_t layer);
+
+    /////////////////////////////////////////////////
+    // Add a sprite that shows part of its texture, like an image in an atlas
+    //
+    // in:
+    //      xpos, ypos - top left corner, in screen pixels
+    //      width, height - size in screen pixels
+    //      texture - the texture to draw it with
+    //      rect - the part of the texture to show
+    //      layer - draw order key; lower layers are drawn first (see SortByLayer())
+    // returns:
+    //      the sprite's index in the arrays
+    std::size_t AddSprite(float xpos, float ypos, float width, float height, TextureId texture, const TextureRect &rect, uint32_t layer);
+
+    /////////////////////////////////////////////////
+    // Reorder the render list by layer key, keeping the order sprites were added within a layer
+    // Does nothing if the list is already in order (which is usual when the game adds sprites layer by layer)
+    //
+    // returns:
+    //      void
+    void SortByLayer();
+
     /////////////////////////////////////////////////
     // accessor methods
     /////////////////////////////////////////////////
@@ -63,7 +133,23 @@ public:
     float getClearColorGreen() const noexcept { return m_ClearColorGreen; }
     float getClearColorBlue() const noexcept { return m_ClearColorBlue; }
     float getClearColorAlpha() const noexcept { return m_ClearColorAlpha; }
-    const std::list<IEntity> *GetEntityList() { return &m_EntityList; }
+
+    // the render list; every array has getSpriteCount() elements, and index i in each describes the same sprite
+    std::size_t getSpriteCount() const noexcept { return m_TextureIds.size(); }
+    const float *getXPositions() const noexcept { return m_XPositions.data(); }
+    const float *getYPositions() const noexcept { return m_YPositions.data(); }
+    const float *getWidths() const noexcept { return m_Widths.data(); }
+    const float *getHeights() const noexcept { return m_Heights.data(); }
+    const TextureId *getTextureIds() const noexcept { return m_TextureIds.data(); }
+    const float *getTexLefts() const noexcept { return m_TexLefts.data(); }
+    const float *getTexTops() const noexcept { return m_TexTops.data(); }
+    const float *getTexRights() const noexcept { return m_TexRights.data(); }
+    const float *getTexBottoms() const noexcept { return m_TexBottoms.data(); }
+    const uint32_t *getLayerKeys() const noexcept { return m_LayerKeys.data(); }
+
+    // the map, drawn before any sprites; empty (0x0) unless the game sets one up
+    const TileMap &getTileMap() const noexcept { return m_TileMap; }
+    TileMap &getTileMap() noexcept { return m_TileMap; }
 
 private:
 
@@ -72,9 +158,25 @@ private:
     float m_ClearColorBlue;
     float m_ClearColorAlpha;
 
-    std::list<IEntity> m_EntityList;
+    std::vector<float> m_XPositions;
+    std::vector<float> m_YPositions;
+    std::vector<float> m_Widths;
+    std::vector<float> m_Heights;
+    std::vector<TextureId> m_TextureIds;
+    std::vector<float> m_TexLefts;
+    std::vector<float> m_TexTops;
+    std::vector<float> m_TexRights;
+    std::vector<float> m_TexBottoms;
+    std::vector<uint32_t> m_LayerKeys;
+
+    TileMap m_TileMap;
+
+    // scratch space for SortByLayer(), kept so sorting doesn't allocate either
+    std::vector<uint32_t> m_SortOrder;
+    std::vector<float> m_SortFloats;
+    std::vector<uint32_t> m_SortKeys;
 };
 
 } // namespace ostrich
 
-#endif /* OSTRICH_SCENEDATA_H_ */
\ No newline at end of file
+#endif /* OSTRICH_SCENEDATA_H_ */
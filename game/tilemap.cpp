@@ -0,0 +1,64 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "tilemap.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+// handed out by Resize(), so no two layouts anywhere share a revision
+std::atomic<uint32_t> g_NextLayoutRevision = 1;
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::TileMap::TileMap() noexcept :
+    m_Columns(0), m_Rows(0), m_XPos(0.0f), m_YPos(0.0f), m_TileWidth(0.0f), m_TileHeight(0.0f),
+    m_Tileset(0), m_TilesetColumns(1), m_TilesetRows(1), m_LayoutRevision(0), m_Revision(0) {
+
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::TileMap::Resize(int32_t columns, int32_t rows) {
+    m_Columns = std::max(columns, 0);
+    m_Rows = std::max(rows, 0);
+    if ((m_Columns == 0) || (m_Rows == 0)) {
+        m_Columns = 0;
+        m_Rows = 0;
+    }
+
+    std::size_t count = static_cast<std::size_t>(m_Columns) * static_cast<std::size_t>(m_Rows);
+    m_Tiles.assign(count, EMPTY_TILE);
+    m_RowRevisions.assign(static_cast<std::size_t>(m_Rows), 0);
+    m_Revision = 0;
+    m_LayoutRevision = g_NextLayoutRevision.fetch_add(1, std::memory_order_relaxed);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::TileMap::setTile(int32_t column, int32_t row, uint16_t tile) noexcept {
+    if ((column < 0) || (column >= m_Columns) || (row < 0) || (row >= m_Rows))
+        return;
+
+    uint16_t &current = m_Tiles[static_cast<std::size_t>(row) * static_cast<std::size_t>(m_Columns) + static_cast<std::size_t>(column)];
+    if (current != tile) {
+        current = tile;
+        m_RowRevisions[static_cast<std::size_t>(row)] = ++m_Revision;
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+uint16_t ostrich::TileMap::getTile(int32_t column, int32_t row) const noexcept {
+    if ((column < 0) || (column >= m_Columns) || (row < 0) || (row >= m_Rows))
+        return EMPTY_TILE;
+
+    return m_Tiles[static_cast<std::size_t>(row) * static_cast<std::size_t>(m_Columns) + static_cast<std::size_t>(column)];
+}
@@ -0,0 +1,189 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Tile map
+
+A uniform grid of tiles, each one a 16-bit index into a tileset: a texture divided into equal cells,
+numbered left to right, top to bottom. Renderers draw the whole grid in one call, so boards
+(and other grid games) don't have to go through the sprite list one square at a time.
+
+Renderers keep their own copy of the grid on the GPU and only re-upload rows that changed.
+Changes are tracked with revision numbers rather than a list of edits: every row records the revision
+it was last changed at, and a renderer compares that against what it last uploaded. A copy of the map
+(like the scene snapshots the threaded loop hands over) carries its revisions with it, so a renderer that
+never sees some versions still catches every change.
+==========================================
+*/
+
+#ifndef OSTRICH_TILEMAP_H_
+#define OSTRICH_TILEMAP_H_
+
+#include <cstdint>
+#include <vector>
+#include "../common/ost_common.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+// Identifies a texture to the renderer; 0 means untextured
+using TextureId = uint32_t;
+
+/////////////////////////////////////////////////
+//
+class TileMap {
+public:
+
+    // a tile with this index isn't drawn
+    static constexpr uint16_t EMPTY_TILE = 0xFFFF;
+
+    /////////////////////////////////////////////////
+    // Constructor creates an empty (0x0) map
+    // Destructor is default
+    // Copy/move constructors/operators are default; scene snapshots copy the map, revisions included
+    TileMap() noexcept;
+    ~TileMap() = default;
+    TileMap(TileMap &&) = default;
+    TileMap(const TileMap &) = default;
+    TileMap &operator=(TileMap &&) = default;
+    TileMap &operator=(const TileMap &) = default;
+
+    /////////////////////////////////////////////////
+    // Change the size of the grid; every tile becomes EMPTY_TILE
+    // Renderers re-upload the whole map after this
+    //
+    // in:
+    //      columns, rows - the new size in tiles
+    // returns:
+    //      void
+    void Resize(int32_t columns, int32_t rows);
+
+    /////////////////////////////////////////////////
+    // Set one tile, marking its row changed if the index is different
+    // Out of range coordinates are ignored
+    //
+    // in:
+    //      column, row - the tile
+    //      tile - tileset index, or EMPTY_TILE
+    // returns:
+    //      void
+    void setTile(int32_t column, int32_t row, uint16_t tile) noexcept;
+
+    /////////////////////////////////////////////////
+    // Get one tile
+    //
+    // in:
+    //      column, row - the tile
+    // returns:
+    //      the tileset index; EMPTY_TILE if out of range
+    uint16_t getTile(int32_t column, int32_t row) const noexcept;
+
+    /////////////////////////////////////////////////
+    // Set where the map is drawn and how big each tile is
+    //
+    // in:
+    //      xpos, ypos - top left corner of the map, in screen pixels
+    //      tilewidth, tileheight - size of one tile on screen, in pixels
+    // returns:
+    //      void
+    void setPlacement(float xpos, float ypos, float tilewidth, float tileheight) noexcept {
+        m_XPos = xpos; m_YPos = ypos; m_TileWidth = tilewidth; m_TileHeight = tileheight;
+    }
+
+    /////////////////////////////////////////////////
+    // Set the tileset texture and how it's divided into cells
+    //
+    // in:
+    //      texture - the tileset
+    //      columns, rows - number of cells across and down the texture
+    // returns:
+    //      void
+    void setTileset(TextureId texture, int32_t columns, int32_t rows) noexcept {
+        m_Tileset = texture; m_TilesetColumns = columns; m_TilesetRows = rows;
+    }
+
+    /////////////////////////////////////////////////
+    // For renderers: compare the map with a record of what was last uploaded, bring the record up to date,
+    // and report what has to be sent again
+    //
+    // in:
+    //      layoutrevision - the layout revision last uploaded (0 for nothing yet)
+    //      rowrevisions - the row revisions last uploaded
+    //      upload - called as upload(firstrow, rowcount) for each run of rows that changed
+    // out:
+    //      layoutrevision, rowrevisions - now match the map
+    // returns:
+    //      true if the layout changed, so the whole map has to be uploaded (upload isn't called)
+    template <typename Upload>
+    bool FindChanges(uint32_t &layoutrevision, std::vector<uint32_t> &rowrevisions, Upload &&upload) const;
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    bool isEmpty() const noexcept { return m_Tiles.empty(); }
+    int32_t getColumns() const noexcept { return m_Columns; }
+    int32_t getRows() const noexcept { return m_Rows; }
+    const uint16_t *getTiles() const noexcept { return m_Tiles.data(); }  // row by row, m_Columns per row
+
+    float getXPos() const noexcept { return m_XPos; }
+    float getYPos() const noexcept { return m_YPos; }
+    float getTileWidth() const noexcept { return m_TileWidth; }
+    float getTileHeight() const noexcept { return m_TileHeight; }
+
+    TextureId getTileset() const noexcept { return m_Tileset; }
+    int32_t getTilesetColumns() const noexcept { return m_TilesetColumns; }
+    int32_t getTilesetRows() const noexcept { return m_TilesetRows; }
+
+    uint32_t getLayoutRevision() const noexcept { return m_LayoutRevision; }
+
+private:
+
+    int32_t m_Columns;
+    int32_t m_Rows;
+    std::vector<uint16_t> m_Tiles;
+
+    float m_XPos;
+    float m_YPos;
+    float m_TileWidth;
+    float m_TileHeight;
+
+    TextureId m_Tileset;
+    int32_t m_TilesetColumns;
+    int32_t m_TilesetRows;
+
+    uint32_t m_LayoutRevision;              // unique across all maps, so a renderer can't mistake one map for another
+    uint32_t m_Revision;                    // bumped by every change
+    std::vector<uint32_t> m_RowRevisions;   // m_Revision when each row last changed
+};
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+template <typename Upload>
+bool TileMap::FindChanges(uint32_t &layoutrevision, std::vector<uint32_t> &rowrevisions, Upload &&upload) const {
+    if ((layoutrevision != m_LayoutRevision) || (rowrevisions.size() != m_RowRevisions.size())) {
+        layoutrevision = m_LayoutRevision;
+        rowrevisions = m_RowRevisions;
+        return true;
+    }
+
+    int32_t row = 0;
+    while (row < m_Rows) {
+        if (rowrevisions[static_cast<std::size_t>(row)] == m_RowRevisions[static_cast<std::size_t>(row)]) {
+            row++;
+            continue;
+        }
+
+        int32_t first = row;
+        while ((row < m_Rows) && (rowrevisions[static_cast<std::size_t>(row)] != m_RowRevisions[static_cast<std::size_t>(row)])) {
+            rowrevisions[static_cast<std::size_t>(row)] = m_RowRevisions[static_cast<std::size_t>(row)];
+            row++;
+        }
+        upload(first, row - first);
+    }
+    return false;
+}
+
+} // namespace ostrich
+
+#endif /* OSTRICH_TILEMAP_H_ */
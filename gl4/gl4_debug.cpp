@@ -31,16 +31,37 @@ void ostrich::GL4Renderer::DebugMessageCallback(GLenum source, GLenum type, GLui
     GLenum severity, GLsizei length, const GLchar *message, const void *userParam) {
     OST_UNUSED_PARAMETER(userParam);
 
+    constexpr ostrich::LogCategory category = ostrich::LogCategory::LOG_RENDERER;
+
     if (type == GL_DEBUG_TYPE_MARKER) {
-        ms_DebugPrinter.DebugMessage(u8"OpenGL Debug Message: Marker >%<", { (const char *)(message) });
+        OST_LOG_TRACE(ms_DebugPrinter, category, OST_FORMAT(u8"OpenGL Debug Message: Marker >%<"), (const char *)(message));
     }
     else if (type == GL_DEBUG_TYPE_PUSH_GROUP) {
-        ms_DebugPrinter.DebugMessage(u8"OpenGL Debug Message: Push Group >%<", { (const char *)(message) });
+        OST_LOG_TRACE(ms_DebugPrinter, category, OST_FORMAT(u8"OpenGL Debug Message: Push Group >%<"), (const char *)(message));
     }
     else if (type == GL_DEBUG_TYPE_POP_GROUP) {
-        ms_DebugPrinter.DebugMessage(u8"OpenGL Debug Message: Pop Group >%<", { (const char *)(message) });
+        OST_LOG_TRACE(ms_DebugPrinter, category, OST_FORMAT(u8"OpenGL Debug Message: Pop Group >%<"), (const char *)(message));
     }
     else {
+        ostrich::LogLevel level = ostrich::LogLevel::LOG_DEBUG;
+        switch (severity) {
+            case GL_DEBUG_SEVERITY_HIGH:
+                level = ostrich::LogLevel::LOG_ERROR;
+                break;
+            case GL_DEBUG_SEVERITY_MEDIUM:
+                level = ostrich::LogLevel::LOG_WARNING;
+                break;
+            case GL_DEBUG_SEVERITY_NOTIFICATION:
+                level = ostrich::LogLevel::LOG_TRACE;
+                break;
+            default:
+                break;
+        }
+
+        // the driver sends a lot of notifications; don't build the string just to throw it away
+        if (!ostrich::log::isCompiledIn(level) || !ms_DebugPrinter.isLogEnabled(level, category)) {
+            return;
+        }
 
         std::string msg(u8"OpenGL Debug Message: Source=>");
 
@@ -94,7 +115,9 @@ void ostrich::GL4Renderer::DebugMessageCallback(GLenum source, GLenum type, GLui
                 break;
         }
 
-        msg.append(u8"< ID=>%< Severity=>");
+        msg.append(u8"< ID=>");
+        msg.append(std::to_string(id));
+        msg.append(u8"< Severity=>");
 
         switch (severity) {
             case GL_DEBUG_SEVERITY_HIGH:
@@ -122,6 +145,6 @@ void ostrich::GL4Renderer::DebugMessageCallback(GLenum source, GLenum type, GLui
             msg.append(u8"<");
         }
 
-        ms_DebugPrinter.DebugMessage(msg, { std::to_string(id) });
+        ms_DebugPrinter.LogMessage(level, category, msg);
     }
 }
\ No newline at end of file
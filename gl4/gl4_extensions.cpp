@@ -7,6 +7,25 @@ Copyright(c) 2020-2021 Ostrich Labs
 #include "gl4_extensions.h"
 #include "../game/errorcodes.h"
 
+namespace {
+
+/////////////////////////////////////////////////
+// Look up one function pointer
+//
+// in:
+//      name - full name of the OpenGL function
+// out:
+//      proc - the function pointer, or nullptr
+// returns:
+//      true if the function was found
+template <typename T>
+bool LoadProc(T &proc, const char *name) {
+    proc = reinterpret_cast<T>(ostrich::glGetProcAddress(name));
+    return (proc != nullptr);
+}
+
+} // anonymous namespace
+
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 int ostrich::GL4Extensions::Load(ostrich::ConsolePrinter consoleprinter) {
@@ -38,6 +57,46 @@ int ostrich::GL4Extensions::LoadCore(ostrich::ConsolePrinter consoleprinter) {
         return OST_ERROR_GL4COREGETPROCADDR;
     }
 
+    // everything the sprite batcher, tile map renderer and texture streaming need
+    bool loaded =
+        LoadProc(m_glActiveTexture, "glActiveTexture") &&
+        LoadProc(m_glGenBuffers, "glGenBuffers") &&
+        LoadProc(m_glDeleteBuffers, "glDeleteBuffers") &&
+        LoadProc(m_glBindBuffer, "glBindBuffer") &&
+        LoadProc(m_glBufferData, "glBufferData") &&
+        LoadProc(m_glUnmapBuffer, "glUnmapBuffer") &&
+        LoadProc(m_glCreateShader, "glCreateShader") &&
+        LoadProc(m_glShaderSource, "glShaderSource") &&
+        LoadProc(m_glCompileShader, "glCompileShader") &&
+        LoadProc(m_glGetShaderiv, "glGetShaderiv") &&
+        LoadProc(m_glGetShaderInfoLog, "glGetShaderInfoLog") &&
+        LoadProc(m_glDeleteShader, "glDeleteShader") &&
+        LoadProc(m_glCreateProgram, "glCreateProgram") &&
+        LoadProc(m_glAttachShader, "glAttachShader") &&
+        LoadProc(m_glLinkProgram, "glLinkProgram") &&
+        LoadProc(m_glGetProgramiv, "glGetProgramiv") &&
+        LoadProc(m_glGetProgramInfoLog, "glGetProgramInfoLog") &&
+        LoadProc(m_glDeleteProgram, "glDeleteProgram") &&
+        LoadProc(m_glUseProgram, "glUseProgram") &&
+        LoadProc(m_glGetUniformLocation, "glGetUniformLocation") &&
+        LoadProc(m_glUniform1i, "glUniform1i") &&
+        LoadProc(m_glUniform2i, "glUniform2i") &&
+        LoadProc(m_glUniform2f, "glUniform2f") &&
+        LoadProc(m_glEnableVertexAttribArray, "glEnableVertexAttribArray") &&
+        LoadProc(m_glVertexAttribPointer, "glVertexAttribPointer") &&
+        LoadProc(m_glMapBufferRange, "glMapBufferRange") &&
+        LoadProc(m_glGenVertexArrays, "glGenVertexArrays") &&
+        LoadProc(m_glDeleteVertexArrays, "glDeleteVertexArrays") &&
+        LoadProc(m_glBindVertexArray, "glBindVertexArray") &&
+        LoadProc(m_glDrawElementsBaseVertex, "glDrawElementsBaseVertex") &&
+        LoadProc(m_glDrawArraysInstanced, "glDrawArraysInstanced") &&
+        LoadProc(m_glFenceSync, "glFenceSync") &&
+        LoadProc(m_glClientWaitSync, "glClientWaitSync") &&
+        LoadProc(m_glDeleteSync, "glDeleteSync");
+    if (!loaded) {
+        return OST_ERROR_GL4COREGETPROCADDR;
+    }
+
     return OST_ERROR_OK;
 }
 
@@ -53,9 +112,9 @@ int ostrich::GL4Extensions::LoadExtensions(ostrich::ConsolePrinter consoleprinte
         extlist.append(ext);
         extlist += ost_char::g_NewLine;
     }
-    consoleprinter.DebugMessage(u8"Supported extensions: %", { extlist });
+    OST_LOG_DEBUG(consoleprinter, ostrich::LogCategory::LOG_RENDERER, OST_FORMAT(u8"Supported extensions: %"), extlist);
 
-    if (extlist.find("GL_KHR_debug")) {
+    if (extlist.find("GL_KHR_debug") != std::string::npos) {
         m_glDebugMessageControl = (PFNGLDEBUGMESSAGECONTROLPROC)ostrich::glGetProcAddress("glDebugMessageControl");
         m_glDebugMessageInsert = (PFNGLDEBUGMESSAGEINSERTPROC)ostrich::glGetProcAddress("glDebugMessageInsert");
         m_glDebugMessageCallback = (PFNGLDEBUGMESSAGECALLBACKPROC)ostrich::glGetProcAddress("glDebugMessageCallback");
@@ -81,26 +140,36 @@ int ostrich::GL4Extensions::LoadExtensions(ostrich::ConsolePrinter consoleprinte
         }
     }
 
-    if (extlist.find("GL_EXT_texture_compression_s3tc")) {
+    if (extlist.find("GL_EXT_texture_compression_s3tc") != std::string::npos) {
         m_EXT_texture_compression_s3tc = true;
         consoleprinter.WriteMessage("OpenGL Extension Supported: GL_EXT_texture_compression_s3tc");
     }
 
-    if (extlist.find("GL_ARB_direct_state_access")) {
+    if (extlist.find("GL_ARB_direct_state_access") != std::string::npos) {
         m_glCreateTextures = (PFNGLCREATETEXTURESPROC)ostrich::glGetProcAddress("glCreateTextures");
         m_glTextureParameteri = (PFNGLTEXTUREPARAMETERIPROC)ostrich::glGetProcAddress("glTextureParameteri");
         m_glTextureStorage2D = (PFNGLTEXTURESTORAGE2DPROC)ostrich::glGetProcAddress("glTextureStorage2D");
         m_glTextureSubImage2D = (PFNGLTEXTURESUBIMAGE2DPROC)ostrich::glGetProcAddress("glTextureSubImage2D");
+        m_glCompressedTextureSubImage2D = (PFNGLCOMPRESSEDTEXTURESUBIMAGE2DPROC)ostrich::glGetProcAddress("glCompressedTextureSubImage2D");
         m_glGenerateTextureMipmap = (PFNGLGENERATETEXTUREMIPMAPPROC)ostrich::glGetProcAddress("glGenerateTextureMipmap");
         if (m_glCreateTextures != nullptr &&
             m_glTextureParameteri != nullptr &&
             m_glTextureStorage2D != nullptr &&
             m_glTextureSubImage2D != nullptr &&
+            m_glCompressedTextureSubImage2D != nullptr &&
             m_glGenerateTextureMipmap != nullptr) {
             m_ARB_direct_state_access = true;
             consoleprinter.WriteMessage("OpenGL Extension Supported: GL_ARB_direct_state_access");
         }
     }
 
+    if (extlist.find("GL_ARB_buffer_storage") != std::string::npos) {
+        m_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)ostrich::glGetProcAddress("glBufferStorage");
+        if (m_glBufferStorage != nullptr) {
+            m_ARB_buffer_storage = true;
+            consoleprinter.WriteMessage("OpenGL Extension Supported: GL_ARB_buffer_storage");
+        }
+    }
+
     return OST_ERROR_OK;
 }
@@ -49,12 +49,23 @@ public:
     // Data is all either simple or copyable, so copy/move constructors/operators are default
     GL4Extensions() noexcept :
         m_glCompressedTexImage2D(nullptr), m_glGetStringi(nullptr), m_glGenerateMipmap(nullptr),
+        m_glActiveTexture(nullptr), m_glGenBuffers(nullptr), m_glDeleteBuffers(nullptr), m_glBindBuffer(nullptr),
+        m_glBufferData(nullptr), m_glUnmapBuffer(nullptr), m_glCreateShader(nullptr), m_glShaderSource(nullptr),
+        m_glCompileShader(nullptr), m_glGetShaderiv(nullptr), m_glGetShaderInfoLog(nullptr), m_glDeleteShader(nullptr),
+        m_glCreateProgram(nullptr), m_glAttachShader(nullptr), m_glLinkProgram(nullptr), m_glGetProgramiv(nullptr),
+        m_glGetProgramInfoLog(nullptr), m_glDeleteProgram(nullptr), m_glUseProgram(nullptr), m_glGetUniformLocation(nullptr),
+        m_glUniform1i(nullptr), m_glUniform2i(nullptr), m_glUniform2f(nullptr), m_glEnableVertexAttribArray(nullptr), m_glVertexAttribPointer(nullptr),
+        m_glMapBufferRange(nullptr), m_glGenVertexArrays(nullptr), m_glDeleteVertexArrays(nullptr), m_glBindVertexArray(nullptr),
+        m_glDrawElementsBaseVertex(nullptr), m_glDrawArraysInstanced(nullptr),
+        m_glFenceSync(nullptr), m_glClientWaitSync(nullptr), m_glDeleteSync(nullptr),
         m_glDebugMessageControl(nullptr), m_glDebugMessageInsert(nullptr), m_glDebugMessageCallback(nullptr),
         m_glGetDebugMessageLog(nullptr), m_glPushDebugGroup(nullptr), m_glPopDebugGroup(nullptr),
         m_glObjectLabel(nullptr), m_glGetObjectLabel(nullptr), m_glObjectPtrLabel(nullptr), m_glGetObjectPtrLabel(nullptr),
         m_glCreateTextures(nullptr), m_glTextureParameteri(nullptr), m_glTextureStorage2D(nullptr),
-        m_glTextureSubImage2D(nullptr), m_glGenerateTextureMipmap(nullptr),
-        m_KHR_debug(false), m_EXT_texture_compression_s3tc(false), m_ARB_direct_state_access(false) {}
+        m_glTextureSubImage2D(nullptr), m_glCompressedTextureSubImage2D(nullptr), m_glGenerateTextureMipmap(nullptr),
+        m_glBufferStorage(nullptr),
+        m_KHR_debug(false), m_EXT_texture_compression_s3tc(false), m_ARB_direct_state_access(false),
+        m_ARB_buffer_storage(false) {}
     virtual ~GL4Extensions() {}
     GL4Extensions(GL4Extensions &&) = default;
     GL4Extensions(const GL4Extensions &) = default;
@@ -91,6 +102,122 @@ public:
     void glGenerateMipmap(GLenum target)
     { if (this->m_glGenerateMipmap != nullptr) { this->m_glGenerateMipmap(target); } }
 
+    /////////////////////////////////////////////////
+    // 1.3
+    void glActiveTexture(GLenum texture)
+    { if (this->m_glActiveTexture != nullptr) { this->m_glActiveTexture(texture); } }
+
+    /////////////////////////////////////////////////
+    // 1.5 - buffer objects
+    void glGenBuffers(GLsizei n, GLuint *buffers)
+    { if (this->m_glGenBuffers != nullptr) { this->m_glGenBuffers(n, buffers); } }
+
+    void glDeleteBuffers(GLsizei n, const GLuint *buffers)
+    { if (this->m_glDeleteBuffers != nullptr) { this->m_glDeleteBuffers(n, buffers); } }
+
+    void glBindBuffer(GLenum target, GLuint buffer)
+    { if (this->m_glBindBuffer != nullptr) { this->m_glBindBuffer(target, buffer); } }
+
+    void glBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
+    { if (this->m_glBufferData != nullptr) { this->m_glBufferData(target, size, data, usage); } }
+
+    GLboolean glUnmapBuffer(GLenum target)
+    { return ((this->m_glUnmapBuffer != nullptr) ? this->m_glUnmapBuffer(target) : GL_FALSE); }
+
+    /////////////////////////////////////////////////
+    // 2.0 - shaders and vertex attributes
+    GLuint glCreateShader(GLenum type)
+    { return ((this->m_glCreateShader != nullptr) ? this->m_glCreateShader(type) : 0); }
+
+    void glShaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length)
+    { if (this->m_glShaderSource != nullptr) { this->m_glShaderSource(shader, count, string, length); } }
+
+    void glCompileShader(GLuint shader)
+    { if (this->m_glCompileShader != nullptr) { this->m_glCompileShader(shader); } }
+
+    void glGetShaderiv(GLuint shader, GLenum pname, GLint *params)
+    { if (this->m_glGetShaderiv != nullptr) { this->m_glGetShaderiv(shader, pname, params); } }
+
+    void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+    { if (this->m_glGetShaderInfoLog != nullptr) { this->m_glGetShaderInfoLog(shader, bufSize, length, infoLog); } }
+
+    void glDeleteShader(GLuint shader)
+    { if (this->m_glDeleteShader != nullptr) { this->m_glDeleteShader(shader); } }
+
+    GLuint glCreateProgram()
+    { return ((this->m_glCreateProgram != nullptr) ? this->m_glCreateProgram() : 0); }
+
+    void glAttachShader(GLuint program, GLuint shader)
+    { if (this->m_glAttachShader != nullptr) { this->m_glAttachShader(program, shader); } }
+
+    void glLinkProgram(GLuint program)
+    { if (this->m_glLinkProgram != nullptr) { this->m_glLinkProgram(program); } }
+
+    void glGetProgramiv(GLuint program, GLenum pname, GLint *params)
+    { if (this->m_glGetProgramiv != nullptr) { this->m_glGetProgramiv(program, pname, params); } }
+
+    void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+    { if (this->m_glGetProgramInfoLog != nullptr) { this->m_glGetProgramInfoLog(program, bufSize, length, infoLog); } }
+
+    void glDeleteProgram(GLuint program)
+    { if (this->m_glDeleteProgram != nullptr) { this->m_glDeleteProgram(program); } }
+
+    void glUseProgram(GLuint program)
+    { if (this->m_glUseProgram != nullptr) { this->m_glUseProgram(program); } }
+
+    GLint glGetUniformLocation(GLuint program, const GLchar *name)
+    { return ((this->m_glGetUniformLocation != nullptr) ? this->m_glGetUniformLocation(program, name) : -1); }
+
+    void glUniform1i(GLint location, GLint v0)
+    { if (this->m_glUniform1i != nullptr) { this->m_glUniform1i(location, v0); } }
+
+    void glUniform2i(GLint location, GLint v0, GLint v1)
+    { if (this->m_glUniform2i != nullptr) { this->m_glUniform2i(location, v0, v1); } }
+
+    void glUniform2f(GLint location, GLfloat v0, GLfloat v1)
+    { if (this->m_glUniform2f != nullptr) { this->m_glUniform2f(location, v0, v1); } }
+
+    void glEnableVertexAttribArray(GLuint index)
+    { if (this->m_glEnableVertexAttribArray != nullptr) { this->m_glEnableVertexAttribArray(index); } }
+
+    void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer)
+    { if (this->m_glVertexAttribPointer != nullptr) { this->m_glVertexAttribPointer(index, size, type, normalized, stride, pointer); } }
+
+    /////////////////////////////////////////////////
+    // 3.0 - GL_ARB_map_buffer_range, GL_ARB_vertex_array_object
+    void *glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+    { return ((this->m_glMapBufferRange != nullptr) ? this->m_glMapBufferRange(target, offset, length, access) : nullptr); }
+
+    void glGenVertexArrays(GLsizei n, GLuint *arrays)
+    { if (this->m_glGenVertexArrays != nullptr) { this->m_glGenVertexArrays(n, arrays); } }
+
+    void glDeleteVertexArrays(GLsizei n, const GLuint *arrays)
+    { if (this->m_glDeleteVertexArrays != nullptr) { this->m_glDeleteVertexArrays(n, arrays); } }
+
+    void glBindVertexArray(GLuint array)
+    { if (this->m_glBindVertexArray != nullptr) { this->m_glBindVertexArray(array); } }
+
+    /////////////////////////////////////////////////
+    // 3.1 - GL_ARB_draw_instanced
+    void glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount)
+    { if (this->m_glDrawArraysInstanced != nullptr) { this->m_glDrawArraysInstanced(mode, first, count, instancecount); } }
+
+    /////////////////////////////////////////////////
+    // 3.2 - GL_ARB_sync
+    GLsync glFenceSync(GLenum condition, GLbitfield flags)
+    { return ((this->m_glFenceSync != nullptr) ? this->m_glFenceSync(condition, flags) : nullptr); }
+
+    GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+    { return ((this->m_glClientWaitSync != nullptr) ? this->m_glClientWaitSync(sync, flags, timeout) : GL_WAIT_FAILED); }
+
+    void glDeleteSync(GLsync sync)
+    { if (this->m_glDeleteSync != nullptr) { this->m_glDeleteSync(sync); } }
+
+    /////////////////////////////////////////////////
+    // 3.2 - GL_ARB_draw_elements_base_vertex
+    void glDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void *indices, GLint basevertex)
+    { if (this->m_glDrawElementsBaseVertex != nullptr) { this->m_glDrawElementsBaseVertex(mode, count, type, indices, basevertex); } }
+
     /////////////////////////////////////////////////
     // OpenGL extensions
     // For some, checking for their presence is enough
@@ -159,9 +286,22 @@ public:
     void glTextureSubImage2D(GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels)
     { if (this->m_glTextureSubImage2D != nullptr) { this->m_glTextureSubImage2D(texture, level, xoffset, yoffset, width, height, format, type, pixels); } }
 
+    void glCompressedTextureSubImage2D(GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void *data)
+    { if (this->m_glCompressedTextureSubImage2D != nullptr) { this->m_glCompressedTextureSubImage2D(texture, level, xoffset, yoffset, width, height, format, imageSize, data); } }
+
     void glGenerateTextureMipmap(GLuint texture)
     { if (this->m_glGenerateTextureMipmap != nullptr) { this->m_glGenerateTextureMipmap(texture); } }
 
+    /////////////////////////////////////////////////
+    // ARB_buffer_storage (core in 4.4)
+    // Needed for buffers that stay mapped while the GPU reads them
+    /////////////////////////////////////////////////
+
+    bool BufferStorageSupported() const noexcept { return m_ARB_buffer_storage; }
+
+    void glBufferStorage(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags)
+    { if (this->m_glBufferStorage != nullptr) { this->m_glBufferStorage(target, size, data, flags); } }
+
 private:
 
     /////////////////////////////////////////////////
@@ -187,6 +327,40 @@ private:
     PFNGLCOMPRESSEDTEXIMAGE2DPROC m_glCompressedTexImage2D;
     PFNGLGETSTRINGIPROC m_glGetStringi;
     PFNGLGENERATEMIPMAPPROC m_glGenerateMipmap;
+    PFNGLACTIVETEXTUREPROC m_glActiveTexture;
+    PFNGLGENBUFFERSPROC m_glGenBuffers;
+    PFNGLDELETEBUFFERSPROC m_glDeleteBuffers;
+    PFNGLBINDBUFFERPROC m_glBindBuffer;
+    PFNGLBUFFERDATAPROC m_glBufferData;
+    PFNGLUNMAPBUFFERPROC m_glUnmapBuffer;
+    PFNGLCREATESHADERPROC m_glCreateShader;
+    PFNGLSHADERSOURCEPROC m_glShaderSource;
+    PFNGLCOMPILESHADERPROC m_glCompileShader;
+    PFNGLGETSHADERIVPROC m_glGetShaderiv;
+    PFNGLGETSHADERINFOLOGPROC m_glGetShaderInfoLog;
+    PFNGLDELETESHADERPROC m_glDeleteShader;
+    PFNGLCREATEPROGRAMPROC m_glCreateProgram;
+    PFNGLATTACHSHADERPROC m_glAttachShader;
+    PFNGLLINKPROGRAMPROC m_glLinkProgram;
+    PFNGLGETPROGRAMIVPROC m_glGetProgramiv;
+    PFNGLGETPROGRAMINFOLOGPROC m_glGetProgramInfoLog;
+    PFNGLDELETEPROGRAMPROC m_glDeleteProgram;
+    PFNGLUSEPROGRAMPROC m_glUseProgram;
+    PFNGLGETUNIFORMLOCATIONPROC m_glGetUniformLocation;
+    PFNGLUNIFORM1IPROC m_glUniform1i;
+    PFNGLUNIFORM2IPROC m_glUniform2i;
+    PFNGLUNIFORM2FPROC m_glUniform2f;
+    PFNGLENABLEVERTEXATTRIBARRAYPROC m_glEnableVertexAttribArray;
+    PFNGLVERTEXATTRIBPOINTERPROC m_glVertexAttribPointer;
+    PFNGLMAPBUFFERRANGEPROC m_glMapBufferRange;
+    PFNGLGENVERTEXARRAYSPROC m_glGenVertexArrays;
+    PFNGLDELETEVERTEXARRAYSPROC m_glDeleteVertexArrays;
+    PFNGLBINDVERTEXARRAYPROC m_glBindVertexArray;
+    PFNGLDRAWELEMENTSBASEVERTEXPROC m_glDrawElementsBaseVertex;
+    PFNGLDRAWARRAYSINSTANCEDPROC m_glDrawArraysInstanced;
+    PFNGLFENCESYNCPROC m_glFenceSync;
+    PFNGLCLIENTWAITSYNCPROC m_glClientWaitSync;
+    PFNGLDELETESYNCPROC m_glDeleteSync;
 
     PFNGLDEBUGMESSAGECONTROLPROC m_glDebugMessageControl;
     PFNGLDEBUGMESSAGEINSERTPROC m_glDebugMessageInsert;
@@ -203,11 +377,15 @@ private:
     PFNGLTEXTUREPARAMETERIPROC m_glTextureParameteri;
     PFNGLTEXTURESTORAGE2DPROC m_glTextureStorage2D;
     PFNGLTEXTURESUBIMAGE2DPROC m_glTextureSubImage2D;
+    PFNGLCOMPRESSEDTEXTURESUBIMAGE2DPROC m_glCompressedTextureSubImage2D;
     PFNGLGENERATETEXTUREMIPMAPPROC m_glGenerateTextureMipmap;
 
+    PFNGLBUFFERSTORAGEPROC m_glBufferStorage;
+
     bool m_KHR_debug;
     bool m_EXT_texture_compression_s3tc;
     bool m_ARB_direct_state_access;
+    bool m_ARB_buffer_storage;
 };
 
 } // namespace ostrich
@@ -34,7 +34,7 @@ int ostrich::GL4Renderer::Initialize(ostrich::ConsolePrinter conprinter) {
 
     int result = this->CheckCaps();
     if (result != OST_ERROR_OK) {
-        m_ConsolePrinter.WriteMessage(u8"Last GL Error: %", { std::to_string(::glGetError()) });
+        m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Last GL Error: %"), ::glGetError());
         return result;
     }
 
@@ -53,6 +53,24 @@ int ostrich::GL4Renderer::Initialize(ostrich::ConsolePrinter conprinter) {
         this->InitDebugExtension(m_Ext, m_ConsolePrinter);
     }
 
+    result = m_TextureManager.Initialize(m_Ext, m_ConsolePrinter);
+    if (result != OST_ERROR_OK) {
+        return result;
+    }
+
+    result = m_SpriteBatcher.Initialize(m_Ext, m_TextureManager, m_ConsolePrinter);
+    if (result != OST_ERROR_OK) {
+        m_TextureManager.Destroy();
+        return result;
+    }
+
+    result = m_TileMapRenderer.Initialize(m_Ext, m_ConsolePrinter);
+    if (result != OST_ERROR_OK) {
+        m_SpriteBatcher.Destroy();
+        m_TextureManager.Destroy();
+        return result;
+    }
+
     ::glClearColor(1.0f, 0.0f, 0.0f, 1.0f);
 
     m_isActive = true;
@@ -64,6 +82,9 @@ int ostrich::GL4Renderer::Initialize(ostrich::ConsolePrinter conprinter) {
 /////////////////////////////////////////////////
 int ostrich::GL4Renderer::Destroy() {
     if (this->isActive()) {
+        m_TileMapRenderer.Destroy();
+        m_SpriteBatcher.Destroy();
+        m_TextureManager.Destroy();
         m_isActive = false;
         m_DebugContext = false;
     }
@@ -72,8 +93,8 @@ int ostrich::GL4Renderer::Destroy() {
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-void ostrich::GL4Renderer::RenderScene(const SceneData *scenedata, int32_t extrapolation) {
-    OST_UNUSED_PARAMETER(extrapolation);
+void ostrich::GL4Renderer::RenderScene(const SceneData *scenedata, double alpha) {
+    OST_UNUSED_PARAMETER(alpha);
     if (this->isActive()) {
         if (scenedata == nullptr) {
             throw ostrich::Exception(u8"SceneData pointer is null");
@@ -83,6 +104,12 @@ void ostrich::GL4Renderer::RenderScene(const SceneData *scenedata, int32_t extra
 
         ::glViewport(0, 0, ostrich::g_ScreenWidth, ostrich::g_ScreenHeight);
         ::glClear(GL_COLOR_BUFFER_BIT);
+
+        const TileMap &tilemap = scenedata->getTileMap();
+        m_TileMapRenderer.Draw(tilemap, m_SpriteBatcher.ResolveTexture(tilemap.getTileset()),
+            ostrich::g_ScreenWidth, ostrich::g_ScreenHeight);
+        m_SpriteBatcher.Draw(*scenedata, ostrich::g_ScreenWidth, ostrich::g_ScreenHeight);
+        m_TextureManager.EndFrame();
     }
 }
 
@@ -95,26 +122,26 @@ int ostrich::GL4Renderer::CheckCaps() {
     if (glstring == nullptr) {
         return OST_ERROR_GL4GETSTRING;
     }
-    m_ConsolePrinter.WriteMessage(u8"OpenGL Renderer: %", { glstring });
+    m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"OpenGL Renderer: %"), glstring);
 
     glstring = (const char *)::glGetString(GL_VENDOR);
     if (glstring == nullptr) {
         return OST_ERROR_GL4GETSTRING;
     }
-    m_ConsolePrinter.WriteMessage(u8"OpenGL Vendor: %", { glstring });
+    m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"OpenGL Vendor: %"), glstring);
 
     glstring = (const char *)::glGetString(GL_VERSION);
     if (glstring == nullptr) {
         return OST_ERROR_GL4GETSTRING;
     }
-    m_ConsolePrinter.WriteMessage(u8"OpenGL Version: %", { glstring });
+    m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"OpenGL Version: %"), glstring);
 
     glstring = (const char *)::glGetString(GL_SHADING_LANGUAGE_VERSION);
     if (glstring == nullptr) {
         return OST_ERROR_GL4GETSTRING;
     }
     char glshadermajorversion = glstring[0];
-    m_ConsolePrinter.WriteMessage(u8"OpenGL Shading Language Version: %", { glstring });
+    m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"OpenGL Shading Language Version: %"), glstring);
 
     // check GL versions
     GLint major = 0;
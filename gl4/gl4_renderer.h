@@ -18,7 +18,10 @@ OpenGL 4.0 interface
 #include <GL/gl.h>
 #include "gl/glext.h"       // taken from https://github.com/KhronosGroup/OpenGL-Registry
 #include "gl4_extensions.h"
+#include "gl4_spritebatcher.h"
 #include "gl4_texture.h"
+#include "gl4_texturemanager.h"
+#include "gl4_tilemaprenderer.h"
 #include "../game/i_renderer.h"
 
 namespace ostrich {
@@ -70,11 +73,39 @@ public:
     // Given passed scene data, draw to the screen
     //
     // in:
-    //      scenedata - a pointer to the scene data (think right now it's just screen clear color and an entity list)
-    //      extrapolation - how far into the next frame we are, in milliseconds (lag/msperframe)
+    //      scenedata - a pointer to the scene data: the clear color, the tile map and the sprite render list
+    //      alpha - how far this frame is between the last update and the next, from 0 to 1 (for interpolating)
     // returns:
     //      void
-    void RenderScene(const SceneData *scenedata, int32_t extrapolation) override;
+    void RenderScene(const SceneData *scenedata, double alpha) override;
+
+    /////////////////////////////////////////////////
+    // Get the sprite batcher's counters for the last frame (sprites, batches, draw calls, vertices)
+    //
+    // returns:
+    //      the last frame's counters
+    const GL4SpriteBatcher::Stats &getSpriteStats() const noexcept { return m_SpriteBatcher.getStats(); }
+
+    /////////////////////////////////////////////////
+    // Get the tile map renderer's counters for the last frame (tiles drawn, rows uploaded)
+    //
+    // returns:
+    //      the last frame's counters
+    const GL4TileMapRenderer::Stats &getTileMapStats() const noexcept { return m_TileMapRenderer.getStats(); }
+
+    /////////////////////////////////////////////////
+    // Get the texture manager, to load the textures a scene refers to by TextureId
+    //
+    // returns:
+    //      the texture manager; only usable while the renderer is active
+    GL4TextureManager &getTextureManager() noexcept { return m_TextureManager; }
+
+    /////////////////////////////////////////////////
+    // Get the texture manager's counters (hits, misses, reloads, evictions, resident bytes)
+    //
+    // returns:
+    //      the counters as of the last frame
+    const GL4TextureManager::Stats &getTextureStats() const noexcept { return m_TextureManager.getStats(); }
 
 private:
 
@@ -93,6 +124,9 @@ private:
     ConsolePrinter m_ConsolePrinter;
 
     GL4Extensions m_Ext;
+    GL4TextureManager m_TextureManager;
+    GL4SpriteBatcher m_SpriteBatcher;
+    GL4TileMapRenderer m_TileMapRenderer;
 
     /////////////////////////////////////////////////
     // for use with debug extensions
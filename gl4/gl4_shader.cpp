@@ -0,0 +1,107 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "gl4_shader.h"
+
+#include <iterator>
+#include <vector>
+#include "../common/filesystem.h"
+#include "../game/errorcodes.h"
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int ostrich::GL4Shader::Load(ostrich::GL4Extensions &ext, ostrich::ConsolePrinter &consoleprinter,
+    std::string_view vertexfile, std::string_view fragmentfile) {
+    this->Destroy(ext);
+
+    std::string vertexsource, fragmentsource;
+    if (!ReadSource(vertexfile, vertexsource)) {
+        consoleprinter.WriteMessage(OST_FORMAT(u8"Unable to read shader %"), vertexfile);
+        return OST_ERROR_GL4SHADERLOAD;
+    }
+    if (!ReadSource(fragmentfile, fragmentsource)) {
+        consoleprinter.WriteMessage(OST_FORMAT(u8"Unable to read shader %"), fragmentfile);
+        return OST_ERROR_GL4SHADERLOAD;
+    }
+
+    GLuint vertex = Compile(ext, consoleprinter, GL_VERTEX_SHADER, vertexfile, vertexsource);
+    GLuint fragment = Compile(ext, consoleprinter, GL_FRAGMENT_SHADER, fragmentfile, fragmentsource);
+    if ((vertex == 0) || (fragment == 0)) {
+        ext.glDeleteShader(vertex);
+        ext.glDeleteShader(fragment);
+        return OST_ERROR_GL4SHADERCOMPILE;
+    }
+
+    GLuint program = ext.glCreateProgram();
+    ext.glAttachShader(program, vertex);
+    ext.glAttachShader(program, fragment);
+    ext.glLinkProgram(program);
+
+    // the program keeps what it needs; the shader objects go once it's linked
+    ext.glDeleteShader(vertex);
+    ext.glDeleteShader(fragment);
+
+    GLint linked = GL_FALSE;
+    ext.glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) {
+        GLint loglength = 0;
+        ext.glGetProgramiv(program, GL_INFO_LOG_LENGTH, &loglength);
+        std::vector<GLchar> log(static_cast<std::size_t>(loglength) + 1, 0);
+        ext.glGetProgramInfoLog(program, static_cast<GLsizei>(log.size()), nullptr, log.data());
+        consoleprinter.WriteMessage(OST_FORMAT(u8"Unable to link % and %: %"), vertexfile, fragmentfile, log.data());
+        ext.glDeleteProgram(program);
+        return OST_ERROR_GL4SHADERLINK;
+    }
+
+    m_Program = program;
+    return OST_ERROR_OK;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4Shader::Destroy(ostrich::GL4Extensions &ext) {
+    if (m_Program != 0) {
+        ext.glDeleteProgram(m_Program);
+        m_Program = 0;
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::GL4Shader::ReadSource(std::string_view filename, std::string &source) {
+    ostrich::File file;
+    if (!file.Open(filename, ostrich::FileMode::OPEN_READONLY))
+        return false;
+
+    std::fstream &handle = file.getFStream();
+    source.assign(std::istreambuf_iterator<char>(handle), std::istreambuf_iterator<char>());
+    return !handle.bad();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+GLuint ostrich::GL4Shader::Compile(ostrich::GL4Extensions &ext, ostrich::ConsolePrinter &consoleprinter,
+    GLenum type, std::string_view filename, const std::string &source) {
+    GLuint shader = ext.glCreateShader(type);
+    const GLchar *text = source.c_str();
+    GLint length = static_cast<GLint>(source.size());
+    ext.glShaderSource(shader, 1, &text, &length);
+    ext.glCompileShader(shader);
+
+    GLint compiled = GL_FALSE;
+    ext.glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled != GL_TRUE) {
+        GLint loglength = 0;
+        ext.glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &loglength);
+        std::vector<GLchar> log(static_cast<std::size_t>(loglength) + 1, 0);
+        ext.glGetShaderInfoLog(shader, static_cast<GLsizei>(log.size()), nullptr, log.data());
+        consoleprinter.WriteMessage(OST_FORMAT(u8"Unable to compile %: %"), filename, log.data());
+        ext.glDeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
@@ -0,0 +1,102 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Helper class to build a GL shader program from a vertex and fragment shader source file
+==========================================
+*/
+
+#ifndef OSTRICH_GL4_SHADER_H
+#define OSTRICH_GL4_SHADER_H
+
+#include "../common/ost_common.h"
+
+#if (OST_WINDOWS == 1)
+#   include <Windows.h> // required for gl.h
+#endif
+
+#include <GL/gl.h>
+#include <string>
+#include <string_view>
+#include "gl4_extensions.h"
+#include "../common/console.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+// Owns one linked GL program
+class GL4Shader {
+public:
+
+    /////////////////////////////////////////////////
+    // Constructor creates an empty object; use Load() to build a program
+    // Destructor does not delete the program, as the GL context may already be gone; call Destroy()
+    // Copy/move constructors/operators are deleted to prevent deleting the same program twice
+    GL4Shader() noexcept : m_Program(0) {}
+    virtual ~GL4Shader() {}
+    GL4Shader(GL4Shader &&) = delete;
+    GL4Shader(const GL4Shader &) = delete;
+    GL4Shader &operator=(GL4Shader &&) = delete;
+    GL4Shader &operator=(const GL4Shader &) = delete;
+
+    /////////////////////////////////////////////////
+    // Read, compile and link a vertex and fragment shader
+    // Compile and link logs are written to the console on failure
+    //
+    // in:
+    //      ext - GL extension object with pre-loaded functions
+    //      consoleprinter - an initialized ConsolePrinter for logging
+    //      vertexfile - vertex shader source file
+    //      fragmentfile - fragment shader source file
+    // returns:
+    //      An error code (OST_ERROR_OK (0) is the only successful code)
+    int Load(GL4Extensions &ext, ConsolePrinter &consoleprinter, std::string_view vertexfile, std::string_view fragmentfile);
+
+    /////////////////////////////////////////////////
+    // Delete the program
+    //
+    // in:
+    //      ext - GL extension object with pre-loaded functions
+    // returns:
+    //      void
+    void Destroy(GL4Extensions &ext);
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    bool isValid() const noexcept { return (m_Program != 0); }
+    GLuint getProgram() const noexcept { return m_Program; }
+
+private:
+
+    /////////////////////////////////////////////////
+    // Read a whole shader source file
+    //
+    // in:
+    //      filename - the file to read
+    // out:
+    //      source - the file's contents
+    // returns:
+    //      true if the file was read
+    static bool ReadSource(std::string_view filename, std::string &source);
+
+    /////////////////////////////////////////////////
+    // Compile one shader stage
+    //
+    // in:
+    //      ext - GL extension object with pre-loaded functions
+    //      consoleprinter - for the compile log
+    //      type - GL_VERTEX_SHADER or GL_FRAGMENT_SHADER
+    //      filename - source file, for the log
+    //      source - the shader source
+    // returns:
+    //      the shader object, or 0 if it didn't compile
+    static GLuint Compile(GL4Extensions &ext, ConsolePrinter &consoleprinter, GLenum type, std::string_view filename, const std::string &source);
+
+    GLuint m_Program;
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_GL4_SHADER_H */
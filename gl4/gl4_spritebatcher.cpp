@@ -0,0 +1,244 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "gl4_spritebatcher.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include "../common/trace.h"
+#include "../game/errorcodes.h"
+
+namespace {
+
+constexpr char g_SpriteVertexShader[] = u8"shaders/gl4/sprite.vert";
+constexpr char g_SpriteFragmentShader[] = u8"shaders/gl4/sprite.frag";
+
+constexpr uint32_t g_VerticesPerSprite = 4;
+constexpr uint32_t g_IndicesPerSprite = 6;
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::GL4SpriteBatcher::GL4SpriteBatcher() noexcept :
+    m_Ext(nullptr), m_TextureManager(nullptr), m_ScreenSizeLocation(-1), m_TextureLocation(-1),
+    m_VertexArray(0), m_VertexBuffer(0), m_IndexBuffer(0), m_WhiteTexture(0), m_RingHead(0), m_Stats() {
+
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int ostrich::GL4SpriteBatcher::Initialize(ostrich::GL4Extensions &ext, ostrich::GL4TextureManager &textures, ostrich::ConsolePrinter consoleprinter) {
+    this->Destroy();
+    m_TextureManager = &textures;
+    m_ConsolePrinter = consoleprinter;
+
+    int result = m_Shader.Load(ext, m_ConsolePrinter, g_SpriteVertexShader, g_SpriteFragmentShader);
+    if (result != OST_ERROR_OK)
+        return result;
+    m_ScreenSizeLocation = ext.glGetUniformLocation(m_Shader.getProgram(), u8"uScreenSize");
+    m_TextureLocation = ext.glGetUniformLocation(m_Shader.getProgram(), u8"uTexture");
+
+    ext.glGenVertexArrays(1, &m_VertexArray);
+    ext.glGenBuffers(1, &m_VertexBuffer);
+    ext.glGenBuffers(1, &m_IndexBuffer);
+    if ((m_VertexArray == 0) || (m_VertexBuffer == 0) || (m_IndexBuffer == 0)) {
+        m_Ext = &ext;
+        this->Destroy();
+        return OST_ERROR_GL4BUFFER;
+    }
+
+    ext.glBindVertexArray(m_VertexArray);
+
+    ext.glBindBuffer(GL_ARRAY_BUFFER, m_VertexBuffer);
+    ext.glBufferData(GL_ARRAY_BUFFER, RING_SPRITES * g_VerticesPerSprite * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+    ext.glEnableVertexAttribArray(0);
+    ext.glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<const void *>(offsetof(Vertex, m_X)));
+    ext.glEnableVertexAttribArray(1);
+    ext.glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<const void *>(offsetof(Vertex, m_U)));
+
+    // two triangles per quad, the same for every quad; draws offset into the ring with a base vertex
+    std::vector<uint16_t> indices(RING_SPRITES * g_IndicesPerSprite);
+    for (uint32_t i = 0; i < RING_SPRITES; i++) {
+        uint16_t first = static_cast<uint16_t>(i * g_VerticesPerSprite);
+        uint16_t *quad = &indices[i * g_IndicesPerSprite];
+        quad[0] = first; quad[1] = first + 1; quad[2] = first + 2;
+        quad[3] = first + 2; quad[4] = first + 3; quad[5] = first;
+    }
+    ext.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBuffer);
+    ext.glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16_t), indices.data(), GL_STATIC_DRAW);
+
+    ext.glBindVertexArray(0);
+    ext.glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // untextured sprites sample this
+    const uint8_t white[4] = { 0xFF, 0xFF, 0xFF, 0xFF };
+    ::glGenTextures(1, &m_WhiteTexture);
+    ::glBindTexture(GL_TEXTURE_2D, m_WhiteTexture);
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    ::glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+    ::glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_RingHead = 0;
+    m_Ext = &ext;
+    return OST_ERROR_OK;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4SpriteBatcher::Destroy() {
+    if (m_Ext == nullptr)
+        return;
+
+    if (m_WhiteTexture != 0) {
+        ::glDeleteTextures(1, &m_WhiteTexture);
+        m_WhiteTexture = 0;
+    }
+    if (m_VertexArray != 0) {
+        m_Ext->glDeleteVertexArrays(1, &m_VertexArray);
+        m_VertexArray = 0;
+    }
+    if (m_VertexBuffer != 0) {
+        m_Ext->glDeleteBuffers(1, &m_VertexBuffer);
+        m_VertexBuffer = 0;
+    }
+    if (m_IndexBuffer != 0) {
+        m_Ext->glDeleteBuffers(1, &m_IndexBuffer);
+        m_IndexBuffer = 0;
+    }
+    m_Shader.Destroy(*m_Ext);
+    m_TextureManager = nullptr;
+    m_Ext = nullptr;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4SpriteBatcher::Draw(const ostrich::SceneData &scenedata, int32_t screenwidth, int32_t screenheight) {
+    m_Stats = Stats();
+    uint32_t count = static_cast<uint32_t>(scenedata.getSpriteCount());
+    if (!this->isActive() || (count == 0))
+        return;
+
+    OST_TRACE_SCOPE("GL4SpriteBatcher::Draw");
+    this->SortSprites(scenedata);
+
+    GL4Extensions &ext = *m_Ext;
+    ext.glUseProgram(m_Shader.getProgram());
+    ext.glUniform2f(m_ScreenSizeLocation, static_cast<GLfloat>(screenwidth), static_cast<GLfloat>(screenheight));
+    ext.glUniform1i(m_TextureLocation, 0);
+    ext.glActiveTexture(GL_TEXTURE0);
+    ext.glBindVertexArray(m_VertexArray);
+    ext.glBindBuffer(GL_ARRAY_BUFFER, m_VertexBuffer);
+    ::glEnable(GL_BLEND);
+    ::glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    const float *xpos = scenedata.getXPositions();
+    const float *ypos = scenedata.getYPositions();
+    const float *widths = scenedata.getWidths();
+    const float *heights = scenedata.getHeights();
+    const TextureId *textures = scenedata.getTextureIds();
+    const float *texlefts = scenedata.getTexLefts();
+    const float *textops = scenedata.getTexTops();
+    const float *texrights = scenedata.getTexRights();
+    const float *texbottoms = scenedata.getTexBottoms();
+
+    bool first = true;
+    TextureId boundtexture = 0;
+    uint32_t done = 0;
+    while (done < count) {
+        uint32_t chunk = std::min(count - done, RING_SPRITES);
+        if ((m_RingHead + chunk) > RING_SPRITES) {
+            ext.glBufferData(GL_ARRAY_BUFFER, RING_SPRITES * g_VerticesPerSprite * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+            m_RingHead = 0;
+            m_Stats.m_Orphans++;
+        }
+
+        // nothing the GPU might still be reading is in this range, so there's nothing to synchronize with
+        auto *vertices = static_cast<Vertex *>(ext.glMapBufferRange(GL_ARRAY_BUFFER,
+            m_RingHead * g_VerticesPerSprite * sizeof(Vertex), chunk * g_VerticesPerSprite * sizeof(Vertex),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+        if (vertices == nullptr) {
+            OST_LOG_WARNING(m_ConsolePrinter, ostrich::LogCategory::LOG_RENDERER,
+                OST_FORMAT(u8"Unable to map the sprite vertex buffer, GL error %"), ::glGetError());
+            break;
+        }
+        for (uint32_t i = 0; i < chunk; i++) {
+            uint32_t sprite = m_Order[done + i];
+            float left = xpos[sprite], top = ypos[sprite];
+            float right = left + widths[sprite], bottom = top + heights[sprite];
+            float u0 = texlefts[sprite], v0 = textops[sprite], u1 = texrights[sprite], v1 = texbottoms[sprite];
+            Vertex *quad = &vertices[i * g_VerticesPerSprite];
+            quad[0] = { left, top, u0, v0 };
+            quad[1] = { right, top, u1, v0 };
+            quad[2] = { right, bottom, u1, v1 };
+            quad[3] = { left, bottom, u0, v1 };
+        }
+        ext.glUnmapBuffer(GL_ARRAY_BUFFER);
+
+        // one draw per run of the same texture
+        uint32_t runstart = 0;
+        for (uint32_t i = 1; i <= chunk; i++) {
+            TextureId runtexture = textures[m_Order[done + runstart]];
+            if ((i < chunk) && (textures[m_Order[done + i]] == runtexture))
+                continue;
+
+            if (first || (runtexture != boundtexture)) {
+                ::glBindTexture(GL_TEXTURE_2D, this->ResolveTexture(runtexture));
+                boundtexture = runtexture;
+                first = false;
+                m_Stats.m_Batches++;
+            }
+            uint32_t sprites = i - runstart;
+            ext.glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(sprites * g_IndicesPerSprite), GL_UNSIGNED_SHORT,
+                nullptr, static_cast<GLint>((m_RingHead + runstart) * g_VerticesPerSprite));
+            m_Stats.m_DrawCalls++;
+            m_Stats.m_Vertices += sprites * g_VerticesPerSprite;
+            m_Stats.m_Sprites += sprites;
+            runstart = i;
+        }
+
+        m_RingHead += chunk;
+        done += chunk;
+    }
+
+    ext.glBindVertexArray(0);
+    ext.glBindBuffer(GL_ARRAY_BUFFER, 0);
+    ext.glUseProgram(0);
+    ::glBindTexture(GL_TEXTURE_2D, 0);
+
+    OST_TRACE_COUNTER("Sprite draw calls", m_Stats.m_DrawCalls);
+    OST_TRACE_COUNTER("Sprite batches", m_Stats.m_Batches);
+    OST_TRACE_COUNTER("Sprite vertices", m_Stats.m_Vertices);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4SpriteBatcher::SortSprites(const ostrich::SceneData &scenedata) {
+    std::size_t count = scenedata.getSpriteCount();
+    const uint32_t *layers = scenedata.getLayerKeys();
+    const TextureId *textures = scenedata.getTextureIds();
+
+    m_SortKeys.resize(count);
+    for (std::size_t i = 0; i < count; i++) {
+        m_SortKeys[i] = (static_cast<uint64_t>(layers[i]) << 32) | static_cast<uint64_t>(textures[i]);
+    }
+
+    m_Order.resize(count);
+    std::iota(m_Order.begin(), m_Order.end(), 0);
+    if (!std::is_sorted(m_SortKeys.begin(), m_SortKeys.end())) {
+        std::stable_sort(m_Order.begin(), m_Order.end(),
+            [this](uint32_t left, uint32_t right) { return (m_SortKeys[left] < m_SortKeys[right]); });
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+GLuint ostrich::GL4SpriteBatcher::ResolveTexture(ostrich::TextureId id) {
+    GLuint texture = ((m_TextureManager != nullptr) ? m_TextureManager->Resolve(id) : 0);
+    return ((texture != 0) ? texture : m_WhiteTexture);
+}
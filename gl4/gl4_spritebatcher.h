@@ -0,0 +1,158 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Sprite batcher for the OpenGL 4 renderer
+
+Draws a SceneData render list as textured quads with as few draw calls as possible:
+sprites are ordered by layer, then texture, and each run of sprites sharing a texture is one draw.
+
+Vertices stream through one buffer used as a ring. Each frame's quads are written through an unsynchronized
+mapping just past the previous frame's, so the driver never has to wait for the GPU to finish with them;
+when the ring is full the buffer is orphaned (re-specified with no data) and writing starts over at the front.
+Indices never change, so they live in a static buffer and each draw picks its quads with a base vertex.
+
+Within a layer, sprites with different textures may be drawn in either order; put anything that has to
+overlap in a particular order on different layers.
+==========================================
+*/
+
+#ifndef OSTRICH_GL4_SPRITEBATCHER_H
+#define OSTRICH_GL4_SPRITEBATCHER_H
+
+#include "../common/ost_common.h"
+
+#if (OST_WINDOWS == 1)
+#   include <Windows.h> // required for gl.h
+#endif
+
+#include <GL/gl.h>
+#include <cstdint>
+#include <vector>
+#include "gl4_extensions.h"
+#include "gl4_shader.h"
+#include "gl4_texturemanager.h"
+#include "../common/console.h"
+#include "../game/scenedata.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+//
+class GL4SpriteBatcher {
+public:
+
+    /////////////////////////////////////////////////
+    // Counters for the last Draw()
+    struct Stats {
+        uint32_t m_Sprites;
+        uint32_t m_Batches;     // runs of sprites sharing a texture
+        uint32_t m_DrawCalls;   // more than m_Batches if a run had to be split at the end of the ring
+        uint32_t m_Vertices;
+        uint32_t m_Orphans;     // times the vertex buffer was orphaned
+    };
+
+    // the vertex ring holds this many quads; a frame with more is drawn in pieces
+    // 4 vertices per quad and 16-bit indices means it can't go past 16384
+    static constexpr uint32_t RING_SPRITES = 16384;
+
+    /////////////////////////////////////////////////
+    // Constructor creates an empty object; use Initialize() once there's a GL context
+    // Destructor does not release GL objects, as the GL context may already be gone; call Destroy()
+    // Copy/move constructors/operators are deleted to prevent deleting the same GL objects twice
+    GL4SpriteBatcher() noexcept;
+    virtual ~GL4SpriteBatcher() {}
+    GL4SpriteBatcher(GL4SpriteBatcher &&) = delete;
+    GL4SpriteBatcher(const GL4SpriteBatcher &) = delete;
+    GL4SpriteBatcher &operator=(GL4SpriteBatcher &&) = delete;
+    GL4SpriteBatcher &operator=(const GL4SpriteBatcher &) = delete;
+
+    /////////////////////////////////////////////////
+    // Build the sprite shader and create the buffers
+    //
+    // in:
+    //      ext - GL extension object with pre-loaded functions; must outlive the batcher
+    //      textures - the texture manager that scene TextureIds come from; must outlive the batcher
+    //      consoleprinter - an initialized ConsolePrinter for logging
+    // returns:
+    //      An error code (OST_ERROR_OK (0) is the only successful code)
+    int Initialize(GL4Extensions &ext, GL4TextureManager &textures, ConsolePrinter consoleprinter);
+
+    /////////////////////////////////////////////////
+    // Release the shader, buffers and the placeholder texture
+    //
+    // returns:
+    //      void
+    void Destroy();
+
+    /////////////////////////////////////////////////
+    // Find the GL texture for a scene texture ID, marking it used this frame
+    // Sprites with an unknown ID (or 0) are drawn with a plain white texture
+    //
+    // in:
+    //      id - the ID used in SceneData
+    // returns:
+    //      the manager's texture, or the white placeholder
+    GLuint ResolveTexture(TextureId id);
+
+    /////////////////////////////////////////////////
+    // Draw every sprite in a scene
+    //
+    // in:
+    //      scenedata - the scene
+    //      screenwidth, screenheight - the viewport size, which sprite positions are relative to
+    // returns:
+    //      void
+    void Draw(const SceneData &scenedata, int32_t screenwidth, int32_t screenheight);
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    bool isActive() const noexcept { return (m_Ext != nullptr); }
+    const Stats &getStats() const noexcept { return m_Stats; }
+
+private:
+
+    /////////////////////////////////////////////////
+    // What the vertex buffer holds: position in screen pixels and texture coordinates
+    struct Vertex {
+        float m_X;
+        float m_Y;
+        float m_U;
+        float m_V;
+    };
+
+    /////////////////////////////////////////////////
+    // Fill m_Order with the scene's sprite indices in draw order (layer, then texture, then as added)
+    //
+    // in:
+    //      scenedata - the scene
+    // returns:
+    //      void
+    void SortSprites(const SceneData &scenedata);
+
+    GL4Extensions *m_Ext;   // nullptr until initialized
+    GL4TextureManager *m_TextureManager;
+    ConsolePrinter m_ConsolePrinter;
+
+    GL4Shader m_Shader;
+    GLint m_ScreenSizeLocation;
+    GLint m_TextureLocation;
+
+    GLuint m_VertexArray;
+    GLuint m_VertexBuffer;
+    GLuint m_IndexBuffer;
+    GLuint m_WhiteTexture;
+    uint32_t m_RingHead;    // first unwritten quad in the vertex ring
+
+    // kept between frames so sorting doesn't allocate
+    std::vector<uint64_t> m_SortKeys;
+    std::vector<uint32_t> m_Order;
+
+    Stats m_Stats;
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_GL4_SPRITEBATCHER_H */
@@ -11,9 +11,33 @@ Copyright (c) 2020-2021 Ostrich Labs
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 ostrich::GL4Texture::~GL4Texture() {
-    if (m_Texture != 0) {
-        ::glDeleteTextures(1, &m_Texture);
+    this->UnbindTexture();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::GL4Texture::GL4Texture(ostrich::GL4Texture &&other) noexcept :
+    m_UniqueID(other.m_UniqueID), m_Texture(other.m_Texture), m_Width(other.m_Width), m_Height(other.m_Height),
+    m_SizeBytes(other.m_SizeBytes), m_PixelFormat(other.m_PixelFormat) {
+    other.m_Texture = 0;
+    other.m_SizeBytes = 0;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::GL4Texture &ostrich::GL4Texture::operator=(ostrich::GL4Texture &&other) noexcept {
+    if (this != &other) {
+        this->UnbindTexture();
+        m_UniqueID = other.m_UniqueID;
+        m_Texture = other.m_Texture;
+        m_Width = other.m_Width;
+        m_Height = other.m_Height;
+        m_SizeBytes = other.m_SizeBytes;
+        m_PixelFormat = other.m_PixelFormat;
+        other.m_Texture = 0;
+        other.m_SizeBytes = 0;
     }
+    return *this;
 }
 
 /////////////////////////////////////////////////
@@ -22,6 +46,13 @@ ostrich::GL4Texture ostrich::GL4Texture::CreateTexture(GL4Extensions &ext, const
     if (!image.isValid())
         return ostrich::GL4Texture();
 
+    // without S3TC the blocks are expanded on the CPU: slower to load and 4-8 times the memory, but it still draws
+    if (image.isCompressed() && !ext.supportsS3TCCompression()) {
+        ostrich::GL4Texture texture = ostrich::GL4Texture::CreateTexture(ext, ostrich::Image::Decompress(image));
+        texture.m_UniqueID = ostrich::utility::HashString(image.getFilename());
+        return texture;
+    }
+
     GLint internalformat = 0;
     GLenum pixelformat = 0;
     if (!ostrich::GL4Texture::GetGLFormats(image.getPixelFormat(), internalformat, pixelformat)) {
@@ -36,34 +67,116 @@ ostrich::GL4Texture ostrich::GL4Texture::CreateTexture(GL4Extensions &ext, const
         tex = ostrich::GL4Texture::CreateTextureCore(ext, image, internalformat, pixelformat);
     }
 
-    return ostrich::GL4Texture(ostrich::utility::HashString(image.getFilename()), tex);
+    if (tex == 0)
+        return ostrich::GL4Texture();
+
+    return ostrich::GL4Texture(ostrich::utility::HashString(image.getFilename()), tex, image.getWidth(), image.getHeight(),
+        ostrich::GL4Texture::TextureBytes(image, internalformat), pixelformat);
 }
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-void ostrich::GL4Texture::UnbindTexture() {
+ostrich::GL4Texture ostrich::GL4Texture::CreateEmpty(GL4Extensions &ext, const ostrich::Image &image) {
+    if (!image.isValid() || image.isCompressed() || (image.getMipCount() > 1))
+        return ostrich::GL4Texture();
+
+    GLint internalformat = 0;
+    GLenum pixelformat = 0;
+    if (!ostrich::GL4Texture::GetGLFormats(image.getPixelFormat(), internalformat, pixelformat)) {
+        return ostrich::GL4Texture();
+    }
+
+    GLuint tex = 0;
+    if (ext.DirectStateAccessSupported()) {
+        ext.glCreateTextures(GL_TEXTURE_2D, 1, &tex);
+        ext.glTextureParameteri(tex, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        ext.glTextureParameteri(tex, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        ext.glTextureParameteri(tex, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        ext.glTextureParameteri(tex, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        ext.glTextureStorage2D(tex, 1, (internalformat == GL_RGBA) ? GL_RGBA8 : GL_RGB8, image.getWidth(), image.getHeight());
+    }
+    else {
+        ::glGenTextures(1, &tex);
+        ::glBindTexture(GL_TEXTURE_2D, tex);
+        ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        ::glTexImage2D(GL_TEXTURE_2D, 0, internalformat, image.getWidth(), image.getHeight(), 0, pixelformat, GL_UNSIGNED_BYTE, nullptr);
+        ::glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    if (tex == 0)
+        return ostrich::GL4Texture();
+
+    return ostrich::GL4Texture(ostrich::utility::HashString(image.getFilename()), tex, image.getWidth(), image.getHeight(),
+        ostrich::GL4Texture::TextureBytes(image, internalformat), pixelformat);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4Texture::UploadRows(GL4Extensions &ext, int32_t firstrow, int32_t rowcount, const void *pixels) {
+    if ((m_Texture == 0) || (rowcount <= 0))
+        return;
+
+    if (ext.DirectStateAccessSupported()) {
+        ext.glTextureSubImage2D(m_Texture, 0, 0, firstrow, m_Width, rowcount, m_PixelFormat, GL_UNSIGNED_BYTE, pixels);
+    }
+    else {
+        ::glBindTexture(GL_TEXTURE_2D, m_Texture);
+        ::glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstrow, m_Width, rowcount, m_PixelFormat, GL_UNSIGNED_BYTE, pixels);
+        ::glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
 
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4Texture::UnbindTexture() {
+    if (m_Texture != 0) {
+        ::glDeleteTextures(1, &m_Texture);
+        m_Texture = 0;
+        m_SizeBytes = 0;
+    }
 }
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 GLuint ostrich::GL4Texture::CreateTextureCore(GL4Extensions &ext, const ostrich::Image &image, GLint GLinternalformat, GLenum GLpixelformat) {
     GLuint tex = 0;
+    int32_t levels = image.getMipCount();
 
     ::glGenTextures(1, &tex);
     ::glBindTexture(GL_TEXTURE_2D, tex);
 
-    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (levels > 1) ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST);
     ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    // a chain cut short of 1x1 is still complete as long as GL knows where it stops
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
 
     auto imgdataptr = image.getData().lock();
     auto *imgdata = imgdataptr.get();
 
-    ::glTexImage2D(GL_TEXTURE_2D, 0, GLinternalformat, image.getWidth(), image.getHeight(), 0, GLpixelformat, GL_UNSIGNED_BYTE, imgdata);
-    ext.glGenerateMipmap(GL_TEXTURE_2D);
-    
+    // rows are tightly packed, which small levels of RGB break at the default alignment of 4
+    GLint alignment = 4;
+    ::glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // every level the file has goes up as it is; nothing is generated here
+    for (int32_t i = 0; i < levels; i++) {
+        ostrich::Image::MipLevel level = image.getMipLevel(i);
+        if (image.isCompressed()) {
+            ext.glCompressedTexImage2D(GL_TEXTURE_2D, i, static_cast<GLenum>(GLinternalformat), level.m_Width, level.m_Height, 0,
+                level.m_Size, imgdata + level.m_Offset);
+        }
+        else {
+            ::glTexImage2D(GL_TEXTURE_2D, i, GLinternalformat, level.m_Width, level.m_Height, 0, GLpixelformat, GL_UNSIGNED_BYTE,
+                imgdata + level.m_Offset);
+        }
+    }
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
     ::glBindTexture(GL_TEXTURE_2D, 0);
 
     return tex;
@@ -73,10 +186,11 @@ GLuint ostrich::GL4Texture::CreateTextureCore(GL4Extensions &ext, const ostrich:
 /////////////////////////////////////////////////
 GLuint ostrich::GL4Texture::CreateTextureObject(GL4Extensions &ext, const ostrich::Image &image, GLint GLinternalformat, GLenum GLpixelformat) {
     GLuint tex = 0;
+    int32_t levels = image.getMipCount();
 
     ext.glCreateTextures(GL_TEXTURE_2D, 1, &tex);
 
-    ext.glTextureParameteri(tex, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    ext.glTextureParameteri(tex, GL_TEXTURE_MIN_FILTER, (levels > 1) ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST);
     ext.glTextureParameteri(tex, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     ext.glTextureParameteri(tex, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     ext.glTextureParameteri(tex, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -84,9 +198,30 @@ GLuint ostrich::GL4Texture::CreateTextureObject(GL4Extensions &ext, const ostric
     auto imgdataptr = image.getData().lock();
     auto *imgdata = imgdataptr.get();
 
-    ext.glTextureStorage2D(tex, 1, GLinternalformat, image.getWidth(), image.getHeight());
-    ext.glTextureSubImage2D(tex, 0, 0, 0, image.getWidth(), image.getHeight(), GLpixelformat, GL_UNSIGNED_BYTE, imgdata);
-    ext.glGenerateTextureMipmap(tex);
+    // immutable storage only takes sized formats
+    GLenum storageformat = static_cast<GLenum>(GLinternalformat);
+    if (GLinternalformat == GL_RGBA)
+        storageformat = GL_RGBA8;
+    else if (GLinternalformat == GL_RGB)
+        storageformat = GL_RGB8;
+
+    // rows are tightly packed, which small levels of RGB break at the default alignment of 4
+    GLint alignment = 4;
+    ::glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // storage for exactly the levels the image has, each filled from its own place in the data
+    ext.glTextureStorage2D(tex, levels, storageformat, image.getWidth(), image.getHeight());
+    for (int32_t i = 0; i < levels; i++) {
+        ostrich::Image::MipLevel level = image.getMipLevel(i);
+        if (image.isCompressed()) {
+            ext.glCompressedTextureSubImage2D(tex, i, 0, 0, level.m_Width, level.m_Height, storageformat, level.m_Size, imgdata + level.m_Offset);
+        }
+        else {
+            ext.glTextureSubImage2D(tex, i, 0, 0, level.m_Width, level.m_Height, GLpixelformat, GL_UNSIGNED_BYTE, imgdata + level.m_Offset);
+        }
+    }
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
 
     return tex;
 }
@@ -144,4 +279,19 @@ bool ostrich::GL4Texture::GetGLFormats(ostrich::PixelFormat ostformat, GLint &GL
     }
     
     return true;
+}
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+std::size_t ostrich::GL4Texture::TextureBytes(const ostrich::Image &image, GLint GLinternalformat) {
+    // compressed data goes to the GPU as it is; otherwise it's expanded to whole bytes per texel
+    std::size_t texelbytes = (GLinternalformat == GL_RGBA) ? 4 : 3;
+    std::size_t bytes = 0;
+    for (int32_t i = 0; i < image.getMipCount(); i++) {
+        ostrich::Image::MipLevel level = image.getMipLevel(i);
+        if (image.isCompressed())
+            bytes += static_cast<std::size_t>(level.m_Size);
+        else
+            bytes += static_cast<std::size_t>(level.m_Width) * static_cast<std::size_t>(level.m_Height) * texelbytes;
+    }
+    return bytes;
 }
\ No newline at end of file
@@ -4,6 +4,13 @@ Copyright (c) 2020-2021 Ostrich Labs
 
 Helper structure to map a bound GL texture to a file name.
 
+A texture is either uploaded whole by CreateTexture(), or created empty and filled in a band of rows at a time
+(CreateEmpty(), UploadRows()) so a big upload can be spread over several frames.
+
+Mipmaps come from the image (a DDS with a mip chain, baked by tools/mipbake) and are uploaded level by level into
+storage sized for exactly those levels. None are generated at load: an image without a chain gets one level and
+plain nearest filtering, which never samples a mip anyway.
+
 Going to use std::hash of the filename as the ID until there's problems. Then I'll figure something else out.
 ==========================================
 */
@@ -26,23 +33,26 @@ namespace ostrich {
 
 /////////////////////////////////////////////////
 // Manage a texture loaded into GL
-// Currently just handles 2D textures with no mipmaps
+// Currently just handles 2D textures, with the image's mipmaps if it has any
 class GL4Texture {
 public:
 
     /////////////////////////////////////////////////
     // Constructors are all private; use the static factory methods to create GL4Textures
     // Destructor is explicitly defined
-    // Copy/move constructors/operators are deleted to prevent deleting the same texture twice
+    // Copy constructor/operator are deleted to prevent deleting the same texture twice
+    // Move constructor/operator hand the texture over, leaving the moved-from object empty, so textures can be kept in containers
     virtual ~GL4Texture();
-    GL4Texture(GL4Texture &&) = delete;
+    GL4Texture(GL4Texture &&other) noexcept;
     GL4Texture(const GL4Texture &) = delete;
-    GL4Texture &operator=(GL4Texture &&) = delete;
+    GL4Texture &operator=(GL4Texture &&other) noexcept;
     GL4Texture &operator=(const GL4Texture &) = delete;
 
     /////////////////////////////////////////////////
     // Load image data into OpenGL
     // Will use ARB_direct_state_access if available
+    // DXT images are uploaded compressed, or expanded on the CPU first if S3TC isn't supported
+    // Every mip level in the image is uploaded; textures with more than one sample the nearest level
     //
     // in:
     //      ext - GL extension object with pre-loaded functions
@@ -52,10 +62,36 @@ public:
     //      on failure, a default-constructed object (reference glGetError())
     static GL4Texture CreateTexture(GL4Extensions &ext, const ostrich::Image &image);
 
+    /////////////////////////////////////////////////
+    // Create a texture the size and format of an image without uploading any pixels, to fill in later with
+    // UploadRows() (texture streaming spreads this over several frames)
+    // Only uncompressed images with one level
+    //
+    // in:
+    //      ext - GL extension object with pre-loaded functions
+    //      image - constructed Image object; only its size, format and file name are used
+    // returns:
+    //      on success, a GL4Texture with a valid GL texture ID and undefined contents
+    //      on failure (or for a compressed image), a default-constructed object
+    static GL4Texture CreateEmpty(GL4Extensions &ext, const ostrich::Image &image);
+
+    /////////////////////////////////////////////////
+    // Upload a band of rows into a texture made by CreateEmpty()
+    //
+    // in:
+    //      ext - GL extension object with pre-loaded functions
+    //      firstrow - the first row to replace
+    //      rowcount - number of rows
+    //      pixels - tightly packed rows in the image's format; with a buffer bound to GL_PIXEL_UNPACK_BUFFER,
+    //               an offset into that buffer instead
+    // returns:
+    //      void
+    void UploadRows(GL4Extensions &ext, int32_t firstrow, int32_t rowcount, const void *pixels);
+
     /////////////////////////////////////////////////
     // Force GL to unbind the texture
     // This is a permanent operation; there is no mechanism for re-loading a texture after this is complete
-    // Maybe this is a bad idea, but we'll cross that bridge when we get to it
+    // (GL4TextureManager re-creates evicted textures from their source instead)
     //
     // returns:
     //      void
@@ -64,18 +100,23 @@ public:
     /////////////////////////////////////////////////
     // accessor methods
     /////////////////////////////////////////////////
+    bool isValid() const noexcept { return (m_Texture != 0); }
     std::size_t getUniqueID() const noexcept { return m_UniqueID; }
     GLuint getTexObject() const noexcept { return m_Texture; }
+    int32_t getWidth() const noexcept { return m_Width; }
+    int32_t getHeight() const noexcept { return m_Height; }
+    std::size_t getSizeBytes() const noexcept { return m_SizeBytes; }   // video memory the pixels take, every mip level included
 
 private:
 
     /////////////////////////////////////////////////
     // Default constructor, when no data is available
-    GL4Texture() noexcept : m_UniqueID(0), m_Texture(0) {}
+    GL4Texture() noexcept : m_UniqueID(0), m_Texture(0), m_Width(0), m_Height(0), m_SizeBytes(0), m_PixelFormat(0) {}
 
     /////////////////////////////////////////////////
     // Creates an object with provided data
-    GL4Texture(std::size_t uid, GLuint tex) noexcept : m_UniqueID(uid), m_Texture(tex) {}
+    GL4Texture(std::size_t uid, GLuint tex, int32_t width, int32_t height, std::size_t sizebytes, GLenum pixelformat) noexcept :
+        m_UniqueID(uid), m_Texture(tex), m_Width(width), m_Height(height), m_SizeBytes(sizebytes), m_PixelFormat(pixelformat) {}
 
     /////////////////////////////////////////////////
     // Helper function to create a GL texture using core GL functions
@@ -113,8 +154,22 @@ private:
     //      true if two formats were found
     static bool GetGLFormats(ostrich::PixelFormat ostformat, GLint &GLinternalformat, GLenum &GLpixelformat);
 
+    /////////////////////////////////////////////////
+    // Work out how much video memory an image's pixels take as a texture, every mip level included
+    //
+    // in:
+    //      image - constructed Image object with valid data
+    //      GLinternalformat - the format it's stored in
+    // returns:
+    //      the size in bytes
+    static std::size_t TextureBytes(const ostrich::Image &image, GLint GLinternalformat);
+
     std::size_t m_UniqueID;
     GLuint m_Texture;
+    int32_t m_Width;
+    int32_t m_Height;
+    std::size_t m_SizeBytes;
+    GLenum m_PixelFormat;   // of the data it was created from, for UploadRows()
 };
 
 } // namespace ostrich
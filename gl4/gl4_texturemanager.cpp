@@ -0,0 +1,420 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "gl4_texturemanager.h"
+
+#include <cstring>
+#include "../common/trace.h"
+#include "../common/utility.h"
+#include "../game/errorcodes.h"
+
+namespace {
+
+/////////////////////////////////////////////////
+// Check whether two images hold exactly the same pixels
+//
+// in:
+//      left, right - valid images
+// returns:
+//      true if the format, size and data all match
+bool SamePixels(const ostrich::Image &left, const ostrich::Image &right) {
+    if ((left.getPixelFormat() != right.getPixelFormat()) || (left.getWidth() != right.getWidth()) ||
+        (left.getHeight() != right.getHeight()) || (left.getDataSize() != right.getDataSize()))
+        return false;
+
+    auto leftdata = left.getData().lock();
+    auto rightdata = right.getData().lock();
+    if ((leftdata == nullptr) || (rightdata == nullptr))
+        return (leftdata == rightdata);
+    return (std::memcmp(leftdata.get(), rightdata.get(), static_cast<std::size_t>(left.getDataSize())) == 0);
+}
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::GL4TextureManager::GL4TextureManager() noexcept :
+    m_Ext(nullptr), m_NextId(1), m_Budget(DEFAULT_BUDGET), m_Frame(0), m_Stats() {
+
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int ostrich::GL4TextureManager::Initialize(ostrich::GL4Extensions &ext, ostrich::ConsolePrinter consoleprinter, std::size_t budgetbytes) {
+    this->Destroy();
+    m_ConsolePrinter = consoleprinter;
+    m_NextId = 1;
+    m_Budget = budgetbytes;
+    m_Frame = 0;
+    m_Stats = Stats();
+    m_Ext = &ext;
+
+    // not fatal; Stream() just loads synchronously without it
+    int result = m_Streamer.Initialize(ext, m_ConsolePrinter);
+    if (result != OST_ERROR_OK) {
+        OST_LOG_WARNING(m_ConsolePrinter, ostrich::LogCategory::LOG_RENDERER,
+            OST_FORMAT(u8"Couldn't start texture streaming (error %); textures will load synchronously"), result);
+    }
+    return OST_ERROR_OK;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4TextureManager::Destroy() {
+    if (m_Ext == nullptr)
+        return;
+
+    m_Streamer.Destroy();
+    m_Streams.clear();
+    m_Finished.clear();
+
+    // GL4Texture deletes its own texture object
+    m_LRU.clear();
+    m_Entries.clear();
+    m_Keys.clear();
+    m_Stats.m_ResidentBytes = 0;
+    m_Stats.m_ResidentCount = 0;
+    m_Stats.m_TextureCount = 0;
+    m_Ext = nullptr;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::TextureId ostrich::GL4TextureManager::Acquire(std::string_view filename) {
+    if (!this->isActive() || filename.empty())
+        return 0;
+
+    std::size_t key = ostrich::utility::HashString(filename);
+    TextureId id = this->FindExisting(key, filename, nullptr);
+    if (id != 0)
+        return id;
+
+    // the Image points at this string's characters, so it has to outlive the upload
+    std::string path(filename);
+    Image image = ostrich::Image::LoadFile(path.c_str());
+    if (!image.isValid()) {
+        OST_LOG_WARNING(m_ConsolePrinter, ostrich::LogCategory::LOG_RENDERER,
+            OST_FORMAT(u8"Couldn't load texture %"), path);
+        return 0;
+    }
+    return this->AddEntry(key, path, image);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::TextureId ostrich::GL4TextureManager::Stream(std::string_view filename) {
+    if (!this->isActive() || filename.empty())
+        return 0;
+    if (!m_Streamer.isActive())
+        return this->Acquire(filename);
+
+    std::size_t key = ostrich::utility::HashString(filename);
+    TextureId id = this->FindExisting(key, filename, nullptr);
+    if (id != 0)
+        return id;
+
+    id = m_NextId++;
+    Entry &entry = m_Entries[id];
+    entry.m_Key = key;
+    entry.m_Filename = filename;
+    entry.m_References = 1;
+    entry.m_LastUsed = m_Frame;
+    this->BeginStream(id, entry);
+
+    m_Keys.emplace(key, id);
+    m_Stats.m_Misses++;
+    return id;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::TextureId ostrich::GL4TextureManager::Acquire(const ostrich::Image &image) {
+    if (!this->isActive() || !image.isValid())
+        return 0;
+
+    std::string_view filename = image.getFilename();
+    if (!filename.empty()) {
+        std::size_t key = ostrich::utility::HashString(filename);
+        TextureId id = this->FindExisting(key, filename, nullptr);
+        return ((id != 0) ? id : this->AddEntry(key, filename, image));
+    }
+
+    auto data = image.getData().lock();
+    std::size_t key = ostrich::utility::HashBytes(data.get(), static_cast<std::size_t>(image.getDataSize()));
+    TextureId id = this->FindExisting(key, filename, &image);
+    return ((id != 0) ? id : this->AddEntry(key, filename, image));
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::GL4TextureManager::AcquireAtlas(const ostrich::TextureAtlas &atlas, std::vector<ostrich::TextureId> &pages) {
+    pages.clear();
+    bool loaded = true;
+    for (std::size_t page = 0; page < atlas.getPageCount(); page++) {
+        TextureId id = 0;
+        if (!atlas.getPageFilename(page).empty())
+            id = this->Acquire(std::string_view(atlas.getPageFilename(page)));
+        else if (atlas.getPage(page) != nullptr)
+            id = this->Acquire(*atlas.getPage(page));
+        pages.push_back(id);
+        loaded = loaded && (id != 0);
+    }
+    return loaded;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4TextureManager::Release(ostrich::TextureId id) {
+    auto found = m_Entries.find(id);
+    if ((found == m_Entries.end()) || (found->second.m_References == 0))
+        return;
+
+    Entry &entry = found->second;
+    entry.m_References--;
+
+    // an evicted (or still streaming) texture nobody wants any more has nothing left worth keeping
+    if ((entry.m_References == 0) && !entry.m_Texture.has_value())
+        this->Forget(id);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+GLuint ostrich::GL4TextureManager::Resolve(ostrich::TextureId id) {
+    if (id == 0)
+        return 0;
+
+    auto found = m_Entries.find(id);
+    if (found == m_Entries.end())
+        return 0;
+
+    // the caller draws a placeholder until it's back
+    Entry &entry = found->second;
+    if ((entry.m_Ticket != 0) || entry.m_Failed)
+        return 0;
+
+    if (!entry.m_Texture.has_value()) {
+        if (!entry.m_Filename.empty() && m_Streamer.isActive()) {
+            if (this->BeginStream(id, entry))
+                m_Stats.m_Reloads++;
+            return 0;
+        }
+        // MakeResident() has already logged it; as with a failed stream, the placeholder stays until the file is asked for again
+        if (!this->MakeResident(id, entry)) {
+            entry.m_Failed = true;
+            return 0;
+        }
+        m_Stats.m_Reloads++;
+    }
+    else {
+        m_LRU.splice(m_LRU.begin(), m_LRU, entry.m_LRUPosition);
+        entry.m_LastUsed = m_Frame;
+    }
+    return entry.m_Texture->getTexObject();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4TextureManager::EndFrame() {
+    if (!this->isActive())
+        return;
+
+    this->CollectStreams();
+
+    // the back of the list was drawn longest ago; once it reaches this frame's textures, nothing else can go
+    while ((m_Stats.m_ResidentBytes > m_Budget) && !m_LRU.empty()) {
+        TextureId oldest = m_LRU.back();
+        if (m_Entries.at(oldest).m_LastUsed >= m_Frame)
+            break;
+        this->Evict(oldest);
+        m_Stats.m_Evictions++;
+    }
+
+    m_Stats.m_ResidentCount = static_cast<uint32_t>(m_LRU.size());
+    m_Stats.m_TextureCount = static_cast<uint32_t>(m_Entries.size());
+    OST_TRACE_COUNTER("Texture resident bytes", m_Stats.m_ResidentBytes);
+    OST_TRACE_COUNTER("Texture evictions", m_Stats.m_Evictions);
+    m_Frame++;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::TextureId ostrich::GL4TextureManager::FindExisting(std::size_t key, std::string_view filename, const ostrich::Image *image) {
+    // different files (or pixels) can hash alike, so every entry under the key is compared until one really matches
+    TextureId id = 0;
+    auto range = m_Keys.equal_range(key);
+    for (auto foundkey = range.first; foundkey != range.second; ++foundkey) {
+        const Entry &candidate = m_Entries.at(foundkey->second);
+        if ((candidate.m_Filename == filename) &&
+            ((image == nullptr) || (candidate.m_Source.has_value() && SamePixels(*candidate.m_Source, *image)))) {
+            id = foundkey->second;
+            break;
+        }
+    }
+    if (id == 0)
+        return 0;
+
+    Entry &entry = m_Entries.at(id);
+    if (entry.m_Texture.has_value()) {
+        m_LRU.splice(m_LRU.begin(), m_LRU, entry.m_LRUPosition);
+        entry.m_LastUsed = m_Frame;
+        m_Stats.m_Hits++;
+    }
+    else if (entry.m_Ticket != 0) {
+        // already on its way
+        m_Stats.m_Hits++;
+    }
+    else if (!entry.m_Filename.empty() && m_Streamer.isActive()) {
+        if (!this->BeginStream(id, entry))
+            return 0;
+        m_Stats.m_Misses++;
+    }
+    else {
+        // evicted, but still known; bring it back rather than adding a duplicate
+        if (!this->MakeResident(id, entry))
+            return 0;
+        m_Stats.m_Misses++;
+    }
+    entry.m_References++;
+    return id;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::TextureId ostrich::GL4TextureManager::AddEntry(std::size_t key, std::string_view filename, const ostrich::Image &image) {
+    TextureId id = m_NextId;
+    Entry &entry = m_Entries[id];
+    entry.m_Key = key;
+    entry.m_Filename = filename;
+    if (filename.empty())
+        entry.m_Source.emplace(image);
+    entry.m_References = 1;
+    entry.m_LastUsed = m_Frame;
+
+    if (!this->MakeResident(id, entry, &image)) {
+        m_Entries.erase(id);
+        return 0;
+    }
+
+    m_Keys.emplace(key, id);
+    m_Stats.m_Misses++;
+    m_NextId++;
+    return id;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::GL4TextureManager::MakeResident(ostrich::TextureId id, Entry &entry, const ostrich::Image *image) {
+    OST_TRACE_SCOPE("GL4TextureManager::MakeResident");
+
+    // a reloaded file has to stay in scope until it's uploaded
+    std::optional<Image> loaded;
+    if (image == nullptr) {
+        if (entry.m_Source.has_value()) {
+            image = &(*entry.m_Source);
+        }
+        else {
+            loaded.emplace(ostrich::Image::LoadFile(entry.m_Filename.c_str()));
+            image = &(*loaded);
+        }
+    }
+
+    if (image != nullptr)
+        entry.m_Texture.emplace(GL4Texture::CreateTexture(*m_Ext, *image));
+    if (!entry.m_Texture.has_value() || !entry.m_Texture->isValid()) {
+        entry.m_Texture.reset();
+        OST_LOG_WARNING(m_ConsolePrinter, ostrich::LogCategory::LOG_RENDERER,
+            OST_FORMAT(u8"Couldn't create texture %"), (entry.m_Filename.empty() ? std::string(u8"from memory") : entry.m_Filename));
+        return false;
+    }
+
+    entry.m_Failed = false;
+    m_Stats.m_ResidentBytes += entry.m_Texture->getSizeBytes();
+    m_LRU.push_front(id);
+    entry.m_LRUPosition = m_LRU.begin();
+    entry.m_LastUsed = m_Frame;
+    return true;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::GL4TextureManager::BeginStream(ostrich::TextureId id, Entry &entry) {
+    entry.m_Ticket = m_Streamer.Request(entry.m_Filename);
+    if (entry.m_Ticket == 0)
+        return false;
+
+    entry.m_Failed = false;
+    m_Streams[entry.m_Ticket] = id;
+    return true;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4TextureManager::CollectStreams() {
+    m_Streamer.Update(m_Finished);
+    for (auto &result : m_Finished) {
+        auto stream = m_Streams.find(result.m_Ticket);
+        if (stream == m_Streams.end())
+            continue;
+        auto found = m_Entries.find(stream->second);
+        TextureId id = stream->second;
+        m_Streams.erase(stream);
+        if (found == m_Entries.end())
+            continue;
+
+        // the streamer has already logged a failure; the placeholder stays until something asks for the file again
+        Entry &entry = found->second;
+        entry.m_Ticket = 0;
+        if (!result.m_Texture.has_value()) {
+            entry.m_Failed = true;
+            continue;
+        }
+
+        entry.m_Texture = std::move(result.m_Texture);
+        m_Stats.m_ResidentBytes += entry.m_Texture->getSizeBytes();
+        m_LRU.push_front(id);
+        entry.m_LRUPosition = m_LRU.begin();
+        entry.m_LastUsed = m_Frame;
+    }
+    m_Finished.clear();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4TextureManager::Forget(ostrich::TextureId id) {
+    auto found = m_Entries.find(id);
+    if (found == m_Entries.end())
+        return;
+
+    Entry &entry = found->second;
+    if (entry.m_Ticket != 0) {
+        m_Streamer.Cancel(entry.m_Ticket);
+        m_Streams.erase(entry.m_Ticket);
+    }
+    auto range = m_Keys.equal_range(entry.m_Key);
+    for (auto key = range.first; key != range.second; ++key) {
+        if (key->second == id) {
+            m_Keys.erase(key);
+            break;
+        }
+    }
+    m_Entries.erase(found);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4TextureManager::Evict(ostrich::TextureId id) {
+    auto found = m_Entries.find(id);
+    if ((found == m_Entries.end()) || !found->second.m_Texture.has_value())
+        return;
+
+    Entry &entry = found->second;
+    m_Stats.m_ResidentBytes -= entry.m_Texture->getSizeBytes();
+    m_LRU.erase(entry.m_LRUPosition);
+    entry.m_Texture.reset();
+
+    if (entry.m_References == 0)
+        this->Forget(id);
+}
@@ -0,0 +1,316 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Texture manager for the OpenGL 4 renderer
+
+Owns every GL4Texture and hands out TextureIds for SceneData to refer to them by.
+
+Asking for the same image twice gives the same ID and no second upload: files are matched by the hash of their path
+(GL4Texture's unique ID), and images handed in from memory by the hash of their pixels. Two that hash alike are told
+apart by comparing the paths (or pixels) themselves, and each keeps its own ID. IDs are reference counted;
+Acquire() adds a reference and Release() drops one.
+
+Textures are kept under a video memory budget. At the end of each frame, if the resident textures add up to more than
+the budget, the least recently drawn ones are evicted until they fit. Evicting a texture nobody holds a reference to
+forgets it completely; evicting one that's still referenced only frees its video memory, and it's re-created from its
+file (or the pixels it was made from) the next time it's drawn. Textures drawn in the current frame are never evicted,
+so a frame that needs more than the budget goes over it rather than thrashing.
+
+Stream() is Acquire() without the wait: the file is loaded and uploaded over the next few frames by a
+GL4TextureStreamer, and until it's done Resolve() gives 0, so the sprite batcher draws its white placeholder instead.
+Once the streamer is running, evicted files come back the same way rather than stalling the frame that draws them.
+==========================================
+*/
+
+#ifndef OSTRICH_GL4_TEXTUREMANAGER_H
+#define OSTRICH_GL4_TEXTUREMANAGER_H
+
+#include "../common/ost_common.h"
+
+#if (OST_WINDOWS == 1)
+#   include <Windows.h> // required for gl.h
+#endif
+
+#include <GL/gl.h>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "gl4_extensions.h"
+#include "gl4_texture.h"
+#include "gl4_texturestreamer.h"
+#include "../common/console.h"
+#include "../common/image.h"
+#include "../common/textureatlas.h"
+#include "../game/tilemap.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+//
+class GL4TextureManager {
+public:
+
+    /////////////////////////////////////////////////
+    // Counters since Initialize(), plus what's resident right now
+    struct Stats {
+        uint64_t m_Hits;            // Acquire() found the texture already resident
+        uint64_t m_Misses;          // Acquire() had to upload it
+        uint64_t m_Reloads;         // an evicted texture had to be re-created to be drawn
+        uint64_t m_Evictions;
+        std::size_t m_ResidentBytes;
+        uint32_t m_ResidentCount;
+        uint32_t m_TextureCount;    // resident or not
+
+        /////////////////////////////////////////////////
+        // The share of requests served without an upload: hits / (hits + misses + reloads)
+        //
+        // returns:
+        //      from 0 to 1; 0 if there haven't been any requests
+        double getHitRate() const noexcept {
+            uint64_t requests = m_Hits + m_Misses + m_Reloads;
+            return ((requests != 0) ? (static_cast<double>(m_Hits) / static_cast<double>(requests)) : 0.0);
+        }
+    };
+
+    static constexpr std::size_t DEFAULT_BUDGET = 256 * 1024 * 1024;
+
+    /////////////////////////////////////////////////
+    // Constructor creates an empty object; use Initialize() once there's a GL context
+    // Destructor does not release textures, as the GL context may already be gone; call Destroy()
+    // Copy/move constructors/operators are deleted to prevent deleting the same textures twice
+    GL4TextureManager() noexcept;
+    virtual ~GL4TextureManager() {}
+    GL4TextureManager(GL4TextureManager &&) = delete;
+    GL4TextureManager(const GL4TextureManager &) = delete;
+    GL4TextureManager &operator=(GL4TextureManager &&) = delete;
+    GL4TextureManager &operator=(const GL4TextureManager &) = delete;
+
+    /////////////////////////////////////////////////
+    // Get ready to load textures
+    //
+    // in:
+    //      ext - GL extension object with pre-loaded functions; must outlive the manager
+    //      consoleprinter - an initialized ConsolePrinter for logging
+    //      budgetbytes - how much video memory resident textures should stay under
+    // returns:
+    //      An error code (OST_ERROR_OK (0) is the only successful code)
+    int Initialize(GL4Extensions &ext, ConsolePrinter consoleprinter, std::size_t budgetbytes = DEFAULT_BUDGET);
+
+    /////////////////////////////////////////////////
+    // Delete every texture, referenced or not; IDs handed out before this are no longer valid
+    //
+    // returns:
+    //      void
+    void Destroy();
+
+    /////////////////////////////////////////////////
+    // Get a texture from an image file (TGA, DDS or PNG, by extension), loading it if it isn't already
+    // Adds a reference; call Release() when done with it
+    //
+    // in:
+    //      filename - path to the image
+    // returns:
+    //      the texture's ID; 0 if the image couldn't be loaded
+    TextureId Acquire(std::string_view filename);
+
+    /////////////////////////////////////////////////
+    // Get a texture from an image file without waiting for it; it's drawn as a placeholder until it's uploaded
+    // Adds a reference; call Release() when done with it
+    // Without a streamer (if it couldn't be created) this is the same as Acquire()
+    //
+    // in:
+    //      filename - path to the image
+    // returns:
+    //      the texture's ID; 0 only if the filename is empty (a file that can't be loaded shows up in the log, and its
+    //      ID keeps drawing the placeholder)
+    TextureId Stream(std::string_view filename);
+
+    /////////////////////////////////////////////////
+    // Get a texture from an image already in memory, uploading it if the same pixels aren't already
+    // Adds a reference; call Release() when done with it
+    // An image with a filename is treated as that file and re-loaded from it after eviction; otherwise the manager
+    // keeps a copy of the Image (sharing its pixels) to re-create the texture from
+    //
+    // in:
+    //      image - a valid image
+    // returns:
+    //      the texture's ID; 0 if the image couldn't be uploaded
+    TextureId Acquire(const Image &image);
+
+    /////////////////////////////////////////////////
+    // Get a texture for every page of an atlas: from the page's file if it has one, otherwise from its pixels
+    // Adds a reference to each page; Release() them when done
+    //
+    // in:
+    //      atlas - a built or loaded atlas
+    // out:
+    //      pages - one ID per page, in page order; 0 for a page that couldn't be loaded
+    // returns:
+    //      true if every page was loaded
+    bool AcquireAtlas(const TextureAtlas &atlas, std::vector<TextureId> &pages);
+
+    /////////////////////////////////////////////////
+    // Drop a reference added by Acquire()
+    // A texture with no references stays cached until the budget forces it out
+    //
+    // in:
+    //      id - the texture
+    // returns:
+    //      void
+    void Release(TextureId id);
+
+    /////////////////////////////////////////////////
+    // Get the GL texture to draw with, marking it used this frame
+    // Re-creates the texture if it was evicted; files are streamed back in if the streamer is running
+    // A texture that couldn't be re-created isn't tried again until Acquire() or Stream() asks for its file
+    //
+    // in:
+    //      id - the texture
+    // returns:
+    //      the GL texture object; 0 if the ID is unknown, the texture is still streaming, or it couldn't be re-created
+    GLuint Resolve(TextureId id);
+
+    /////////////////////////////////////////////////
+    // Finish the frame: take in whatever finished streaming, then evict least recently used textures until the
+    // resident ones fit the budget
+    //
+    // returns:
+    //      void
+    void EndFrame();
+
+    /////////////////////////////////////////////////
+    // Change the budget; takes effect at the next EndFrame()
+    //
+    // in:
+    //      budgetbytes - how much video memory resident textures should stay under
+    // returns:
+    //      void
+    void setBudget(std::size_t budgetbytes) noexcept { m_Budget = budgetbytes; }
+
+    /////////////////////////////////////////////////
+    // Change how many bytes of streamed textures are uploaded per frame
+    //
+    // in:
+    //      framebytes - in bytes
+    // returns:
+    //      void
+    void setStreamBudget(std::size_t framebytes) noexcept { m_Streamer.setFrameBudget(framebytes); }
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    bool isActive() const noexcept { return (m_Ext != nullptr); }
+    std::size_t getBudget() const noexcept { return m_Budget; }
+    const Stats &getStats() const noexcept { return m_Stats; }
+    const GL4TextureStreamer::Stats &getStreamStats() const noexcept { return m_Streamer.getStats(); }
+
+private:
+
+    /////////////////////////////////////////////////
+    // Everything the manager knows about one texture
+    struct Entry {
+        std::size_t m_Key;                  // hash of the path, or of the pixels for images from memory
+        std::string m_Filename;             // empty for images from memory
+        std::optional<Image> m_Source;      // kept for images without a file, to re-create them
+        std::optional<GL4Texture> m_Texture; // empty while evicted
+        GL4TextureStreamer::Ticket m_Ticket; // non-zero while streaming
+        bool m_Failed;                      // the file couldn't be reloaded; don't keep asking
+        uint32_t m_References;
+        uint64_t m_LastUsed;                // frame it was last drawn (or loaded)
+        std::list<TextureId>::iterator m_LRUPosition;   // only meaningful while resident
+    };
+
+    /////////////////////////////////////////////////
+    // Find a known texture by key, adding a reference and making it resident
+    //
+    // in:
+    //      key - hash of the path or pixels
+    //      filename - the path, to rule out a hash collision; empty for images from memory
+    //      image - for images from memory, the pixels to rule out a hash collision; otherwise nullptr
+    // returns:
+    //      the texture's ID; 0 if it isn't known
+    TextureId FindExisting(std::size_t key, std::string_view filename, const Image *image);
+
+    /////////////////////////////////////////////////
+    // Register a new texture and upload it
+    //
+    // in:
+    //      key - hash of the path or pixels
+    //      filename - the path; empty for images from memory
+    //      image - the image to upload; kept if there's no filename
+    // returns:
+    //      the new texture's ID; 0 if it couldn't be uploaded
+    TextureId AddEntry(std::size_t key, std::string_view filename, const Image &image);
+
+    /////////////////////////////////////////////////
+    // Upload an entry's texture and put it at the front of the LRU list
+    //
+    // in:
+    //      id - the entry's ID
+    //      entry - the entry
+    //      image - the image, if the caller already has it; otherwise it comes from the entry's file or kept image
+    // returns:
+    //      true if the texture was created
+    bool MakeResident(TextureId id, Entry &entry, const Image *image = nullptr);
+
+    /////////////////////////////////////////////////
+    // Have the streamer (re)load an entry's file
+    //
+    // in:
+    //      id - the entry's ID
+    //      entry - the entry; must have a filename
+    // returns:
+    //      true if the request went in
+    bool BeginStream(TextureId id, Entry &entry);
+
+    /////////////////////////////////////////////////
+    // Take in everything the streamer finished this frame
+    //
+    // returns:
+    //      void
+    void CollectStreams();
+
+    /////////////////////////////////////////////////
+    // Forget an entry that's neither resident nor referenced
+    //
+    // in:
+    //      id - the entry's ID
+    // returns:
+    //      void
+    void Forget(TextureId id);
+
+    /////////////////////////////////////////////////
+    // Free an entry's texture, and forget the entry too if nothing references it
+    //
+    // in:
+    //      id - the entry's ID
+    // returns:
+    //      void
+    void Evict(TextureId id);
+
+    GL4Extensions *m_Ext;   // nullptr until initialized
+    ConsolePrinter m_ConsolePrinter;
+
+    std::unordered_map<TextureId, Entry> m_Entries;
+    std::unordered_multimap<std::size_t, TextureId> m_Keys;   // more than one ID under a key when hashes collide
+    std::list<TextureId> m_LRU;     // resident textures, most recently used first
+    TextureId m_NextId;
+
+    GL4TextureStreamer m_Streamer;
+    std::unordered_map<GL4TextureStreamer::Ticket, TextureId> m_Streams;
+    std::vector<GL4TextureStreamer::Result> m_Finished;    // kept between frames to reuse its memory
+
+    std::size_t m_Budget;
+    uint64_t m_Frame;
+    Stats m_Stats;
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_GL4_TEXTUREMANAGER_H */
@@ -0,0 +1,333 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "gl4_texturestreamer.h"
+
+#include <algorithm>
+#include <cstring>
+#include "../common/trace.h"
+#include "../game/errorcodes.h"
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::GL4TextureStreamer::GL4TextureStreamer() noexcept :
+    m_Ext(nullptr), m_Buffer(0), m_Mapped(nullptr), m_Size(0), m_Head(0), m_Tail(0), m_NextTicket(1),
+    m_FrameBudget(DEFAULT_FRAME_BUDGET), m_Stats() {
+
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int ostrich::GL4TextureStreamer::Initialize(ostrich::GL4Extensions &ext, ostrich::ConsolePrinter consoleprinter,
+    std::size_t stagingbytes, std::size_t framebudget) {
+    this->Destroy();
+    m_ConsolePrinter = consoleprinter;
+    m_FrameBudget = framebudget;
+    m_Stats = Stats();
+
+    ext.glGenBuffers(1, &m_Buffer);
+    if ((m_Buffer == 0) || (stagingbytes == 0))
+        return OST_ERROR_GL4BUFFER;
+
+    ext.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Buffer);
+    if (ext.BufferStorageSupported()) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        ext.glBufferStorage(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(stagingbytes), nullptr, flags);
+        m_Mapped = static_cast<uint8_t *>(ext.glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(stagingbytes), flags));
+    }
+    else {
+        ext.glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(stagingbytes), nullptr, GL_STREAM_DRAW);
+    }
+    ext.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (ext.BufferStorageSupported() && (m_Mapped == nullptr)) {
+        ext.glDeleteBuffers(1, &m_Buffer);
+        m_Buffer = 0;
+        return OST_ERROR_GL4BUFFER;
+    }
+
+    m_Size = stagingbytes;
+    m_Head = 0;
+    m_Tail = 0;
+    m_Ext = &ext;
+    return OST_ERROR_OK;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4TextureStreamer::Destroy() {
+    // loader jobs write into the requests, so they have to be finished before anything goes
+    if (!m_Loads.isDone()) {
+        ostrich::JobSystem *jobs = ostrich::JobSystem::getActive();
+        if (jobs != nullptr)
+            jobs->Wait(m_Loads);
+    }
+    m_Pending.clear();
+
+    if (m_Ext == nullptr)
+        return;
+
+    for (auto &fence : m_Fences) {
+        m_Ext->glDeleteSync(fence.m_Sync);
+    }
+    m_Fences.clear();
+
+    if (m_Buffer != 0) {
+        if (m_Mapped != nullptr) {
+            m_Ext->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Buffer);
+            m_Ext->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            m_Ext->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            m_Mapped = nullptr;
+        }
+        m_Ext->glDeleteBuffers(1, &m_Buffer);
+        m_Buffer = 0;
+    }
+    m_Size = 0;
+    m_Stats.m_Pending = 0;
+    m_Ext = nullptr;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::GL4TextureStreamer::Ticket ostrich::GL4TextureStreamer::Request(std::string_view filename) {
+    if (!this->isActive())
+        return 0;
+
+    auto pending = std::make_unique<Pending>();
+    pending->m_Ticket = m_NextTicket++;
+    pending->m_Filename = filename;
+    pending->m_Loaded.store(false, std::memory_order_relaxed);
+    pending->m_Cancelled = false;
+    pending->m_NextRow = 0;
+
+    Pending *load = pending.get();
+    auto job = [load]() {
+        load->m_Image.emplace(ostrich::Image::LoadFile(load->m_Filename.c_str()));
+        load->m_Loaded.store(true, std::memory_order_release);
+    };
+
+    Ticket ticket = pending->m_Ticket;
+    m_Pending.push_back(std::move(pending));
+    ostrich::JobSystem *jobs = ostrich::JobSystem::getActive();
+    if (jobs != nullptr)
+        jobs->Submit(std::move(job), &m_Loads);
+    else
+        job();
+
+    m_Stats.m_Requests++;
+    m_Stats.m_Pending = static_cast<uint32_t>(m_Pending.size());
+    return ticket;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4TextureStreamer::Cancel(ostrich::GL4TextureStreamer::Ticket ticket) {
+    auto found = std::find_if(m_Pending.begin(), m_Pending.end(), [ticket](const std::unique_ptr<Pending> &pending) {
+        return (pending->m_Ticket == ticket);
+    });
+    if (found == m_Pending.end())
+        return;
+
+    // a loader job still has hold of it; Update() drops it once the job is done
+    if (!(*found)->m_Loaded.load(std::memory_order_acquire)) {
+        (*found)->m_Cancelled = true;
+        return;
+    }
+    m_Pending.erase(found);
+    m_Stats.m_Pending = static_cast<uint32_t>(m_Pending.size());
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4TextureStreamer::Update(std::vector<ostrich::GL4TextureStreamer::Result> &finished) {
+    OST_TRACE_SCOPE("GL4TextureStreamer::Update");
+    m_Stats.m_FrameBytes = 0;
+    if (!this->isActive())
+        return;
+
+    this->Retire();
+    if (m_Pending.empty())
+        return;
+
+    uint64_t headstart = m_Head;
+    std::size_t budget = m_FrameBudget;
+    bool stop = false;
+
+    // rows in the staging ring are tightly packed
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    m_Ext->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Buffer);
+
+    for (auto next = m_Pending.begin(); (next != m_Pending.end()) && !stop;) {
+        Pending &pending = **next;
+        if (!pending.m_Loaded.load(std::memory_order_acquire)) {
+            ++next;
+            continue;
+        }
+        if (pending.m_Cancelled) {
+            next = m_Pending.erase(next);
+            continue;
+        }
+
+        const Image &image = *pending.m_Image;
+        bool failed = !image.isValid();
+        bool done = false;
+        if (!failed && (image.isCompressed() || (image.getMipCount() > 1))) {
+            std::size_t bytes = static_cast<std::size_t>(image.getDataSize());
+            if ((bytes > budget) && (m_Stats.m_FrameBytes > 0))
+                break;
+            m_Ext->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            pending.m_Texture.emplace(GL4Texture::CreateTexture(*m_Ext, image));
+            m_Ext->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Buffer);
+            failed = !pending.m_Texture->isValid();
+            budget -= std::min(bytes, budget);
+            m_Stats.m_FrameBytes += bytes;
+            m_Stats.m_BytesUploaded += bytes;
+            m_Stats.m_Uploads++;
+            done = true;
+        }
+        else if (!failed) {
+            if (!pending.m_Texture.has_value())
+                pending.m_Texture.emplace(GL4Texture::CreateEmpty(*m_Ext, image));
+            int64_t expected = static_cast<int64_t>(image.getWidth()) * image.getHeight() * ostrich::Image::BytesPerPixel(image.getPixelFormat());
+            failed = (!pending.m_Texture->isValid() || (image.getDataSize() < expected));
+
+            while (!failed && (pending.m_NextRow < image.getHeight())) {
+                std::size_t bytes = this->UploadBand(pending, budget, (m_Stats.m_FrameBytes == 0));
+                if (bytes == 0) {
+                    // out of budget, or out of ring space until the GPU catches up
+                    std::size_t rowbytes = static_cast<std::size_t>(image.getWidth()) * static_cast<std::size_t>(ostrich::Image::BytesPerPixel(image.getPixelFormat()));
+                    if ((budget >= rowbytes) || (m_Stats.m_FrameBytes == 0))
+                        m_Stats.m_Stalls++;
+                    stop = true;
+                    break;
+                }
+                budget -= std::min(bytes, budget);
+                m_Stats.m_FrameBytes += bytes;
+            }
+            if (!failed && (pending.m_NextRow >= image.getHeight()))
+                done = true;
+        }
+
+        if (failed) {
+            OST_LOG_WARNING(m_ConsolePrinter, ostrich::LogCategory::LOG_RENDERER,
+                OST_FORMAT(u8"Couldn't stream texture %"), pending.m_Filename);
+            finished.push_back({ pending.m_Ticket, std::nullopt });
+            m_Stats.m_Failed++;
+            next = m_Pending.erase(next);
+        }
+        else if (done) {
+            finished.push_back({ pending.m_Ticket, std::move(pending.m_Texture) });
+            m_Stats.m_Completed++;
+            next = m_Pending.erase(next);
+        }
+        else {
+            ++next;
+        }
+    }
+
+    m_Ext->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // the GPU may read this frame's bands any time until the fence
+    if (m_Head != headstart) {
+        GLsync sync = m_Ext->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        if (sync != nullptr) {
+            m_Fences.push_back({ sync, m_Head });
+        }
+        else {
+            ::glFinish();
+            m_Tail = m_Head;
+        }
+    }
+
+    m_Stats.m_Pending = static_cast<uint32_t>(m_Pending.size());
+    OST_TRACE_COUNTER("Texture streaming bytes", m_Stats.m_FrameBytes);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+std::size_t ostrich::GL4TextureStreamer::UploadBand(Pending &pending, std::size_t budget, bool force) {
+    const Image &image = *pending.m_Image;
+    std::size_t rowbytes = static_cast<std::size_t>(image.getWidth()) * static_cast<std::size_t>(ostrich::Image::BytesPerPixel(image.getPixelFormat()));
+    int32_t rows = static_cast<int32_t>(std::min(static_cast<std::size_t>(image.getHeight() - pending.m_NextRow), budget / rowbytes));
+    if (rows == 0) {
+        if (!force)
+            return 0;
+        rows = 1;
+    }
+
+    auto data = image.getData().lock();
+    const uint8_t *source = data.get() + (static_cast<std::size_t>(pending.m_NextRow) * rowbytes);
+
+    if (rowbytes > m_Size) {
+        // a row bigger than the whole ring can only go straight from memory
+        m_Ext->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        pending.m_Texture->UploadRows(*m_Ext, pending.m_NextRow, 1, source);
+        m_Ext->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Buffer);
+        rows = 1;
+    }
+    else {
+        std::size_t offset = 0;
+        rows = this->Allocate(rowbytes, rows, offset);
+        if (rows == 0)
+            return 0;
+
+        std::size_t bytes = static_cast<std::size_t>(rows) * rowbytes;
+        if (m_Mapped != nullptr) {
+            std::memcpy(m_Mapped + offset, source, bytes);
+        }
+        else {
+            // nothing else in this range is in flight (the fences said so), so there's nothing to wait for
+            void *staging = m_Ext->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes),
+                GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+            if (staging == nullptr)
+                return 0;
+            std::memcpy(staging, source, bytes);
+            m_Ext->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+        pending.m_Texture->UploadRows(*m_Ext, pending.m_NextRow, rows, reinterpret_cast<const void *>(offset));
+        m_Head += bytes;
+    }
+
+    std::size_t uploaded = static_cast<std::size_t>(rows) * rowbytes;
+    pending.m_NextRow += rows;
+    m_Stats.m_Uploads++;
+    m_Stats.m_BytesUploaded += uploaded;
+    return uploaded;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int32_t ostrich::GL4TextureStreamer::Allocate(std::size_t rowbytes, int32_t maxrows, std::size_t &offset) {
+    std::size_t free = m_Size - static_cast<std::size_t>(m_Head - m_Tail);
+    std::size_t position = static_cast<std::size_t>(m_Head % m_Size);
+    std::size_t contiguous = std::min(free, m_Size - position);
+    if (contiguous < rowbytes) {
+        // no room before the end; skip what's left there if the front has space
+        std::size_t skip = m_Size - position;
+        if (free < (skip + rowbytes))
+            return 0;
+        m_Head += skip;
+        position = 0;
+        contiguous = free - skip;
+    }
+
+    offset = position;
+    return static_cast<int32_t>(std::min(static_cast<std::size_t>(maxrows), contiguous / rowbytes));
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4TextureStreamer::Retire() {
+    while (!m_Fences.empty()) {
+        GLenum status = m_Ext->glClientWaitSync(m_Fences.front().m_Sync, 0, 0);
+        if ((status != GL_ALREADY_SIGNALED) && (status != GL_CONDITION_SATISFIED))
+            break;
+        m_Tail = m_Fences.front().m_Head;
+        m_Ext->glDeleteSync(m_Fences.front().m_Sync);
+        m_Fences.pop_front();
+    }
+}
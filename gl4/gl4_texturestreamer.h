@@ -0,0 +1,230 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Texture streamer for the OpenGL 4 renderer
+
+Loads image files in the background and uploads them a few rows at a time, so a big texture costs a little of
+several frames instead of a stall in one.
+
+Request() hands the file to the job system, which reads and decodes it on a worker thread (or right away, if there
+isn't a job system). Update() runs once a frame on the render thread: it copies rows of decoded images into a
+staging pixel buffer and uploads them from there, stopping once the frame's byte budget is spent. Finished textures
+come back from Update() with the ticket Request() gave out.
+
+The staging buffer is a ring. With ARB_buffer_storage it's mapped once and stays mapped (persistent and coherent);
+without it, each band of rows maps just its own range, unsynchronized. Either way the GPU may still be reading an
+earlier band, so every Update() that staged anything ends with a fence, and ring space is only reused once the fence
+after it has signalled. A full ring ends the frame's uploads early (a stall, in the stats) rather than waiting.
+
+Compressed images, and images with a mip chain, are uploaded whole in one go; their levels don't split into rows.
+==========================================
+*/
+
+#ifndef OSTRICH_GL4_TEXTURESTREAMER_H
+#define OSTRICH_GL4_TEXTURESTREAMER_H
+
+#include "../common/ost_common.h"
+
+#if (OST_WINDOWS == 1)
+#   include <Windows.h> // required for gl.h
+#endif
+
+#include <GL/gl.h>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "gl4_extensions.h"
+#include "gl4_texture.h"
+#include "../common/console.h"
+#include "../common/image.h"
+#include "../common/jobsystem.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+//
+class GL4TextureStreamer {
+public:
+
+    /////////////////////////////////////////////////
+    // Identifies one Request(); 0 is never handed out
+    using Ticket = uint64_t;
+
+    /////////////////////////////////////////////////
+    // A request that's been dealt with
+    struct Result {
+        Ticket m_Ticket;
+        std::optional<GL4Texture> m_Texture;    // empty if the file couldn't be loaded or uploaded
+    };
+
+    /////////////////////////////////////////////////
+    // Counters since Initialize(), plus the last Update()
+    struct Stats {
+        uint64_t m_Requests;
+        uint64_t m_Completed;
+        uint64_t m_Failed;
+        uint64_t m_Uploads;         // bands of rows (or whole images) sent to the GPU
+        uint64_t m_BytesUploaded;
+        uint64_t m_Stalls;          // Update()s cut short by a full staging ring
+        std::size_t m_FrameBytes;   // uploaded by the last Update()
+        uint32_t m_Pending;         // requested and not yet returned
+    };
+
+    static constexpr std::size_t DEFAULT_STAGING_BYTES = 16 * 1024 * 1024;
+    static constexpr std::size_t DEFAULT_FRAME_BUDGET = 2 * 1024 * 1024;
+
+    /////////////////////////////////////////////////
+    // Constructor creates an empty object; use Initialize() once there's a GL context
+    // Destructor does not release the staging buffer, as the GL context may already be gone; call Destroy()
+    // Copy/move constructors/operators are deleted; loader jobs hold pointers into this
+    GL4TextureStreamer() noexcept;
+    virtual ~GL4TextureStreamer() {}
+    GL4TextureStreamer(GL4TextureStreamer &&) = delete;
+    GL4TextureStreamer(const GL4TextureStreamer &) = delete;
+    GL4TextureStreamer &operator=(GL4TextureStreamer &&) = delete;
+    GL4TextureStreamer &operator=(const GL4TextureStreamer &) = delete;
+
+    /////////////////////////////////////////////////
+    // Create the staging buffer
+    //
+    // in:
+    //      ext - GL extension object with pre-loaded functions; must outlive the streamer
+    //      consoleprinter - an initialized ConsolePrinter for logging
+    //      stagingbytes - size of the staging ring
+    //      framebudget - how many bytes Update() uploads per frame, at most
+    // returns:
+    //      An error code (OST_ERROR_OK (0) is the only successful code)
+    int Initialize(GL4Extensions &ext, ConsolePrinter consoleprinter, std::size_t stagingbytes = DEFAULT_STAGING_BYTES,
+        std::size_t framebudget = DEFAULT_FRAME_BUDGET);
+
+    /////////////////////////////////////////////////
+    // Wait for loads in progress, then drop every request and free the staging buffer
+    //
+    // returns:
+    //      void
+    void Destroy();
+
+    /////////////////////////////////////////////////
+    // Start loading an image file (TGA, DDS or PNG, by extension)
+    //
+    // in:
+    //      filename - path to the image
+    // returns:
+    //      the ticket its Result will carry; 0 if the streamer isn't initialized
+    Ticket Request(std::string_view filename);
+
+    /////////////////////////////////////////////////
+    // Give up on a request; it won't come back from Update()
+    //
+    // in:
+    //      ticket - from Request()
+    // returns:
+    //      void
+    void Cancel(Ticket ticket);
+
+    /////////////////////////////////////////////////
+    // Upload as much as the frame budget allows, oldest request first; call once a frame on the render thread
+    //
+    // out:
+    //      finished - requests that completed or failed are appended
+    // returns:
+    //      void
+    void Update(std::vector<Result> &finished);
+
+    /////////////////////////////////////////////////
+    // Change how many bytes Update() uploads per frame
+    // At least one row (or one whole image) still goes up each frame, however small this is
+    //
+    // in:
+    //      framebudget - in bytes
+    // returns:
+    //      void
+    void setFrameBudget(std::size_t framebudget) noexcept { m_FrameBudget = framebudget; }
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    bool isActive() const noexcept { return (m_Ext != nullptr); }
+    bool isPersistent() const noexcept { return (m_Mapped != nullptr); }
+    std::size_t getFrameBudget() const noexcept { return m_FrameBudget; }
+    const Stats &getStats() const noexcept { return m_Stats; }
+
+private:
+
+    /////////////////////////////////////////////////
+    // One request, from Request() until it's returned or cancelled
+    // Kept by pointer, so the loader job's pointer stays good while the list changes
+    struct Pending {
+        Ticket m_Ticket;
+        std::string m_Filename;         // the Image points at these characters
+        std::optional<Image> m_Image;   // written by the loader job; only read once m_Loaded is set
+        std::atomic<bool> m_Loaded;
+        bool m_Cancelled;
+        std::optional<GL4Texture> m_Texture;    // created once the first rows go up
+        int32_t m_NextRow;
+    };
+
+    /////////////////////////////////////////////////
+    // The end of ring space used up to a fence
+    struct Fence {
+        GLsync m_Sync;
+        uint64_t m_Head;
+    };
+
+    /////////////////////////////////////////////////
+    // Upload the next band of rows for a request
+    //
+    // in:
+    //      pending - a loaded request with a valid, uncompressed, single level image and a texture
+    //      budget - bytes left this frame
+    //      force - upload a row even if the budget is spent
+    // returns:
+    //      bytes uploaded; 0 if there was no ring space (or budget)
+    std::size_t UploadBand(Pending &pending, std::size_t budget, bool force);
+
+    /////////////////////////////////////////////////
+    // Find space for a band in the staging ring, skipping to the front if it won't fit before the end
+    //
+    // in:
+    //      rowbytes - size of one row
+    //      maxrows - most rows wanted
+    // out:
+    //      offset - where to put them in the buffer
+    // returns:
+    //      how many rows fit; 0 if not even one does yet
+    int32_t Allocate(std::size_t rowbytes, int32_t maxrows, std::size_t &offset);
+
+    /////////////////////////////////////////////////
+    // Free ring space behind every fence that has signalled
+    //
+    // returns:
+    //      void
+    void Retire();
+
+    GL4Extensions *m_Ext;   // nullptr until initialized
+    ConsolePrinter m_ConsolePrinter;
+
+    GLuint m_Buffer;
+    uint8_t *m_Mapped;      // the whole ring while it's persistently mapped; otherwise nullptr
+    std::size_t m_Size;
+    uint64_t m_Head;        // bytes ever staged; the ring offset is this modulo m_Size
+    uint64_t m_Tail;        // bytes the GPU is known to be done with
+    std::deque<Fence> m_Fences;
+
+    std::deque<std::unique_ptr<Pending>> m_Pending;
+    JobCounter m_Loads;
+    Ticket m_NextTicket;
+    std::size_t m_FrameBudget;
+    Stats m_Stats;
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_GL4_TEXTURESTREAMER_H */
@@ -0,0 +1,186 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "gl4_tilemaprenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include "../common/trace.h"
+#include "../game/errorcodes.h"
+
+namespace {
+
+constexpr char g_TileMapVertexShader[] = u8"shaders/gl4/tilemap.vert";
+constexpr char g_TileMapFragmentShader[] = u8"shaders/gl4/sprite.frag";
+
+/////////////////////////////////////////////////
+// Work out which tiles along one axis of the map are on screen
+//
+// in:
+//      mappos - where the map starts, in screen pixels
+//      tilesize - size of a tile, in screen pixels
+//      screensize - size of the screen
+//      count - number of tiles along this axis
+// out:
+//      first, last - the visible tiles are first up to (not including) last; first >= last if none are
+// returns:
+//      void
+void VisibleTiles(float mappos, float tilesize, int32_t screensize, int32_t count, int32_t &first, int32_t &last) {
+    first = static_cast<int32_t>(std::max(std::floor(-mappos / tilesize), 0.0f));
+    last = static_cast<int32_t>(std::min(std::ceil((static_cast<float>(screensize) - mappos) / tilesize), static_cast<float>(count)));
+}
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::GL4TileMapRenderer::GL4TileMapRenderer() noexcept :
+    m_Ext(nullptr), m_TilesLocation(-1), m_TilesetLocation(-1), m_ScreenSizeLocation(-1), m_OriginLocation(-1),
+    m_TileSizeLocation(-1), m_TilesetGridLocation(-1), m_FirstTileLocation(-1), m_VisibleColumnsLocation(-1),
+    m_VertexArray(0), m_MapTexture(0), m_MaxTextureSize(0), m_LayoutRevision(0), m_Stats() {
+
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int ostrich::GL4TileMapRenderer::Initialize(ostrich::GL4Extensions &ext, ostrich::ConsolePrinter consoleprinter) {
+    this->Destroy();
+    m_ConsolePrinter = consoleprinter;
+
+    int result = m_Shader.Load(ext, m_ConsolePrinter, g_TileMapVertexShader, g_TileMapFragmentShader);
+    if (result != OST_ERROR_OK)
+        return result;
+    GLuint program = m_Shader.getProgram();
+    m_TilesLocation = ext.glGetUniformLocation(program, u8"uTiles");
+    m_TilesetLocation = ext.glGetUniformLocation(program, u8"uTexture");
+    m_ScreenSizeLocation = ext.glGetUniformLocation(program, u8"uScreenSize");
+    m_OriginLocation = ext.glGetUniformLocation(program, u8"uOrigin");
+    m_TileSizeLocation = ext.glGetUniformLocation(program, u8"uTileSize");
+    m_TilesetGridLocation = ext.glGetUniformLocation(program, u8"uTilesetGrid");
+    m_FirstTileLocation = ext.glGetUniformLocation(program, u8"uFirstTile");
+    m_VisibleColumnsLocation = ext.glGetUniformLocation(program, u8"uVisibleColumns");
+
+    ext.glGenVertexArrays(1, &m_VertexArray);
+    ::glGenTextures(1, &m_MapTexture);
+    if ((m_VertexArray == 0) || (m_MapTexture == 0)) {
+        m_Ext = &ext;
+        this->Destroy();
+        return OST_ERROR_GL4BUFFER;
+    }
+
+    // integer textures can't be filtered; the shader fetches exact texels anyway
+    ::glBindTexture(GL_TEXTURE_2D, m_MapTexture);
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    ::glBindTexture(GL_TEXTURE_2D, 0);
+    ::glGetIntegerv(GL_MAX_TEXTURE_SIZE, &m_MaxTextureSize);
+
+    m_LayoutRevision = 0;
+    m_RowRevisions.clear();
+    m_Ext = &ext;
+    return OST_ERROR_OK;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4TileMapRenderer::Destroy() {
+    if (m_Ext == nullptr)
+        return;
+
+    if (m_VertexArray != 0) {
+        m_Ext->glDeleteVertexArrays(1, &m_VertexArray);
+        m_VertexArray = 0;
+    }
+    if (m_MapTexture != 0) {
+        ::glDeleteTextures(1, &m_MapTexture);
+        m_MapTexture = 0;
+    }
+    m_Shader.Destroy(*m_Ext);
+    m_LayoutRevision = 0;
+    m_RowRevisions.clear();
+    m_Ext = nullptr;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4TileMapRenderer::Draw(const ostrich::TileMap &tilemap, GLuint tileset, int32_t screenwidth, int32_t screenheight) {
+    m_Stats = Stats();
+    if (!this->isActive() || tilemap.isEmpty() || (tilemap.getTileWidth() <= 0.0f) || (tilemap.getTileHeight() <= 0.0f))
+        return;
+
+    if ((tilemap.getColumns() > m_MaxTextureSize) || (tilemap.getRows() > m_MaxTextureSize)) {
+        if (tilemap.getLayoutRevision() != m_LayoutRevision) {
+            OST_LOG_WARNING(m_ConsolePrinter, ostrich::LogCategory::LOG_RENDERER,
+                OST_FORMAT(u8"Tile map is % by %, but the largest texture is %"), tilemap.getColumns(), tilemap.getRows(), m_MaxTextureSize);
+        }
+        tilemap.FindChanges(m_LayoutRevision, m_RowRevisions, [](int32_t, int32_t) {});
+        return;
+    }
+
+    OST_TRACE_SCOPE("GL4TileMapRenderer::Draw");
+    GL4Extensions &ext = *m_Ext;
+    ext.glActiveTexture(GL_TEXTURE1);
+    ::glBindTexture(GL_TEXTURE_2D, m_MapTexture);
+    this->Upload(tilemap);
+
+    int32_t firstcolumn = 0, lastcolumn = 0, firstrow = 0, lastrow = 0;
+    VisibleTiles(tilemap.getXPos(), tilemap.getTileWidth(), screenwidth, tilemap.getColumns(), firstcolumn, lastcolumn);
+    VisibleTiles(tilemap.getYPos(), tilemap.getTileHeight(), screenheight, tilemap.getRows(), firstrow, lastrow);
+    if ((firstcolumn < lastcolumn) && (firstrow < lastrow)) {
+        ext.glUseProgram(m_Shader.getProgram());
+        ext.glUniform1i(m_TilesLocation, 1);
+        ext.glUniform1i(m_TilesetLocation, 0);
+        ext.glUniform2f(m_ScreenSizeLocation, static_cast<GLfloat>(screenwidth), static_cast<GLfloat>(screenheight));
+        ext.glUniform2f(m_OriginLocation, tilemap.getXPos(), tilemap.getYPos());
+        ext.glUniform2f(m_TileSizeLocation, tilemap.getTileWidth(), tilemap.getTileHeight());
+        ext.glUniform2f(m_TilesetGridLocation, static_cast<GLfloat>(std::max(tilemap.getTilesetColumns(), 1)),
+            static_cast<GLfloat>(std::max(tilemap.getTilesetRows(), 1)));
+        ext.glUniform2i(m_FirstTileLocation, firstcolumn, firstrow);
+        ext.glUniform1i(m_VisibleColumnsLocation, lastcolumn - firstcolumn);
+        ext.glActiveTexture(GL_TEXTURE0);
+        ::glBindTexture(GL_TEXTURE_2D, tileset);
+        ::glEnable(GL_BLEND);
+        ::glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        uint32_t instances = static_cast<uint32_t>(lastcolumn - firstcolumn) * static_cast<uint32_t>(lastrow - firstrow);
+        ext.glBindVertexArray(m_VertexArray);
+        ext.glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(instances));
+        ext.glBindVertexArray(0);
+        ext.glUseProgram(0);
+        m_Stats.m_Tiles = instances;
+        m_Stats.m_DrawCalls = 1;
+    }
+
+    ext.glActiveTexture(GL_TEXTURE1);
+    ::glBindTexture(GL_TEXTURE_2D, 0);
+    ext.glActiveTexture(GL_TEXTURE0);
+    ::glBindTexture(GL_TEXTURE_2D, 0);
+
+    OST_TRACE_COUNTER("Tile map tiles", m_Stats.m_Tiles);
+    OST_TRACE_COUNTER("Tile map rows uploaded", m_Stats.m_RowsUploaded);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GL4TileMapRenderer::Upload(const ostrich::TileMap &tilemap) {
+    int32_t columns = tilemap.getColumns(), rows = tilemap.getRows();
+    const uint16_t *tiles = tilemap.getTiles();
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+
+    bool relayout = tilemap.FindChanges(m_LayoutRevision, m_RowRevisions, [&](int32_t first, int32_t count) {
+        ::glTexSubImage2D(GL_TEXTURE_2D, 0, 0, first, columns, count, GL_RED_INTEGER, GL_UNSIGNED_SHORT,
+            tiles + (static_cast<std::size_t>(first) * static_cast<std::size_t>(columns)));
+        m_Stats.m_RowsUploaded += static_cast<uint32_t>(count);
+        m_Stats.m_Uploads++;
+    });
+    if (relayout) {
+        ::glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, columns, rows, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, tiles);
+        m_Stats.m_RowsUploaded = static_cast<uint32_t>(rows);
+        m_Stats.m_Uploads = 1;
+    }
+
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
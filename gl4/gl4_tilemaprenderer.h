@@ -0,0 +1,134 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Tile map renderer for the OpenGL 4 renderer
+
+Draws a scene's TileMap with a single instanced draw. The map lives on the GPU as a data texture with one 16-bit
+texel per tile (the tile's tileset index), so a 1000x1000 map is 2MB. Each instance is one 4 vertex quad; the
+instances cover just the block of tiles on screen, and the vertex shader works out which tile it is from its
+instance number and looks the index up in the texture.
+
+The texture is updated one run of changed rows at a time (see TileMap for how changes are tracked),
+so a board where one square changes costs one small upload rather than re-sending every tile.
+==========================================
+*/
+
+#ifndef OSTRICH_GL4_TILEMAPRENDERER_H
+#define OSTRICH_GL4_TILEMAPRENDERER_H
+
+#include "../common/ost_common.h"
+
+#if (OST_WINDOWS == 1)
+#   include <Windows.h> // required for gl.h
+#endif
+
+#include <GL/gl.h>
+#include <cstdint>
+#include <vector>
+#include "gl4_extensions.h"
+#include "gl4_shader.h"
+#include "../common/console.h"
+#include "../game/tilemap.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+//
+class GL4TileMapRenderer {
+public:
+
+    /////////////////////////////////////////////////
+    // Counters for the last Draw()
+    struct Stats {
+        uint32_t m_Tiles;           // instances drawn, empty tiles included
+        uint32_t m_DrawCalls;
+        uint32_t m_RowsUploaded;
+        uint32_t m_Uploads;         // texture updates; one per run of changed rows
+    };
+
+    /////////////////////////////////////////////////
+    // Constructor creates an empty object; use Initialize() once there's a GL context
+    // Destructor does not release GL objects, as the GL context may already be gone; call Destroy()
+    // Copy/move constructors/operators are deleted to prevent deleting the same GL objects twice
+    GL4TileMapRenderer() noexcept;
+    virtual ~GL4TileMapRenderer() {}
+    GL4TileMapRenderer(GL4TileMapRenderer &&) = delete;
+    GL4TileMapRenderer(const GL4TileMapRenderer &) = delete;
+    GL4TileMapRenderer &operator=(GL4TileMapRenderer &&) = delete;
+    GL4TileMapRenderer &operator=(const GL4TileMapRenderer &) = delete;
+
+    /////////////////////////////////////////////////
+    // Build the tile map shader and create the map texture
+    //
+    // in:
+    //      ext - GL extension object with pre-loaded functions; must outlive the renderer
+    //      consoleprinter - an initialized ConsolePrinter for logging
+    // returns:
+    //      An error code (OST_ERROR_OK (0) is the only successful code)
+    int Initialize(GL4Extensions &ext, ConsolePrinter consoleprinter);
+
+    /////////////////////////////////////////////////
+    // Release the shader, vertex array and map texture
+    //
+    // returns:
+    //      void
+    void Destroy();
+
+    /////////////////////////////////////////////////
+    // Bring the GPU copy of the map up to date and draw it
+    //
+    // in:
+    //      tilemap - the map; nothing is drawn if it's empty
+    //      tileset - the GL texture for tilemap.getTileset()
+    //      screenwidth, screenheight - the viewport size, which the map's placement is relative to
+    // returns:
+    //      void
+    void Draw(const TileMap &tilemap, GLuint tileset, int32_t screenwidth, int32_t screenheight);
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    bool isActive() const noexcept { return (m_Ext != nullptr); }
+    const Stats &getStats() const noexcept { return m_Stats; }
+
+private:
+
+    /////////////////////////////////////////////////
+    // Re-upload the whole map if its layout changed, otherwise each run of rows that changed since the last upload
+    // Expects the map texture to be bound
+    //
+    // in:
+    //      tilemap - the map
+    // returns:
+    //      void
+    void Upload(const TileMap &tilemap);
+
+    GL4Extensions *m_Ext;   // nullptr until initialized
+    ConsolePrinter m_ConsolePrinter;
+
+    GL4Shader m_Shader;
+    GLint m_TilesLocation;
+    GLint m_TilesetLocation;
+    GLint m_ScreenSizeLocation;
+    GLint m_OriginLocation;
+    GLint m_TileSizeLocation;
+    GLint m_TilesetGridLocation;
+    GLint m_FirstTileLocation;
+    GLint m_VisibleColumnsLocation;
+
+    GLuint m_VertexArray;   // has no attributes, but core profile won't draw without one
+    GLuint m_MapTexture;
+    GLint m_MaxTextureSize;     // maps with more rows or columns than this aren't drawn
+
+    // what the map texture holds
+    uint32_t m_LayoutRevision;
+    std::vector<uint32_t> m_RowRevisions;
+
+    Stats m_Stats;
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_GL4_TILEMAPRENDERER_H */
@@ -5,13 +5,15 @@ Copyright (c) 2020-2021 Ostrich Labs
 */
 
 #include "gles2_renderer.h"
+#include <memory>
 #include <string_view>
+#include <utility>
 #include "../common/error.h"
 #include "../game/errorcodes.h"
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-ostrich::EGLRenderer::EGLRenderer() noexcept : m_isActive(false) {
+ostrich::EGLRenderer::EGLRenderer() noexcept : m_isActive(false), m_S3TCSupported(false) {
 
 }
 
@@ -35,6 +37,18 @@ int ostrich::EGLRenderer::Initialize(ostrich::ConsolePrinter conprinter) {
     if (result != OST_ERROR_OK)
         return result;
 
+    result = m_TileMapRenderer.Initialize(m_ConsolePrinter);
+    if (result != OST_ERROR_OK)
+        return result;
+
+    std::unique_ptr<uint8_t[]> white(new uint8_t[4] { 0xFF, 0xFF, 0xFF, 0xFF });
+    ostrich::Image whiteimage = ostrich::Image::FromPixels(ostrich::PixelFormat::FORMAT_RGBA, 1, 1, std::move(white));
+    m_WhiteTexture = ostrich::GLES2Texture::CreateTexture(whiteimage, m_S3TCSupported);
+    if (!m_WhiteTexture.isValid()) {
+        m_TileMapRenderer.Destroy();
+        return OST_ERROR_ES2TEXTURE;
+    }
+
     ::glClearColor(1.0f, 0.0f, 0.0f, 1.0f);
 
     m_isActive = true;
@@ -46,6 +60,8 @@ int ostrich::EGLRenderer::Initialize(ostrich::ConsolePrinter conprinter) {
 /////////////////////////////////////////////////
 int ostrich::EGLRenderer::Destroy() {
     if (this->isActive()) {
+        m_WhiteTexture.Destroy();
+        m_TileMapRenderer.Destroy();
     	m_isActive = false;
     }
     return OST_ERROR_OK;
@@ -53,12 +69,13 @@ int ostrich::EGLRenderer::Destroy() {
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
-void ostrich::EGLRenderer::RenderScene(const SceneData *scenedata, int32_t extrapolation) {
+void ostrich::EGLRenderer::RenderScene(const SceneData *scenedata, double alpha) {
+    OST_UNUSED_PARAMETER(alpha);
     if (!this->isActive())
         return;
 
     if (scenedata == nullptr) {
-        m_ConsolePrinter.DebugMessage(u8"Warning: SceneData pointer is null in OpenGL ES 2 renderer");
+        OST_LOG_WARNING(m_ConsolePrinter, ostrich::LogCategory::LOG_RENDERER, u8"Warning: SceneData pointer is null in OpenGL ES 2 renderer");
         throw ostrich::Exception(u8"SceneData pointer is null");
     }
     ::glClearColor(scenedata->getClearColorRed(), scenedata->getClearColorGreen(),
@@ -66,6 +83,8 @@ void ostrich::EGLRenderer::RenderScene(const SceneData *scenedata, int32_t extra
 
     ::glViewport(0, 0, ostrich::g_ScreenWidth, ostrich::g_ScreenHeight);
     ::glClear(GL_COLOR_BUFFER_BIT);
+
+    m_TileMapRenderer.Draw(scenedata->getTileMap(), m_WhiteTexture.getTexObject(), ostrich::g_ScreenWidth, ostrich::g_ScreenHeight);
 }
 
 /////////////////////////////////////////////////
@@ -77,26 +96,26 @@ int ostrich::EGLRenderer::CheckCaps() {
     if (glstring == nullptr) {
         return OST_ERROR_ES2GETSTRING;
     }
-    m_ConsolePrinter.WriteMessage(u8"OpenGL Renderer: %", { glstring });
+    m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"OpenGL Renderer: %"), glstring);
 
     glstring = (const char *)::glGetString(GL_VENDOR);
     if (glstring == nullptr) {
         return OST_ERROR_ES2GETSTRING;
     }
-    m_ConsolePrinter.WriteMessage(u8"OpenGL Vendor: %", { glstring });
+    m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"OpenGL Vendor: %"), glstring);
 
     glstring = (const char *)::glGetString(GL_VERSION);
     if (glstring == nullptr) {
         return OST_ERROR_ES2GETSTRING;
     }
-    m_ConsolePrinter.WriteMessage(u8"OpenGL Version: %", { glstring });
+    m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"OpenGL Version: %"), glstring);
     std::string_view es2version = glstring;
 
     glstring = (const char *)::glGetString(GL_SHADING_LANGUAGE_VERSION);
     if (glstring == nullptr) {
         return OST_ERROR_ES2GETSTRING;
     }
-    m_ConsolePrinter.WriteMessage(u8"OpenGL Shading Language Version: %", { glstring });
+    m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"OpenGL Shading Language Version: %"), glstring);
     std::string_view shadingversion = glstring;
 
     glstring = (const char *)::glGetString(GL_EXTENSIONS);
@@ -104,7 +123,8 @@ int ostrich::EGLRenderer::CheckCaps() {
         m_ConsolePrinter.WriteMessage(u8"No OpenGL extensions supported");
     }
     else {
-        m_ConsolePrinter.WriteMessage(u8"Supported Extensions: %", { glstring });
+        m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Supported Extensions: %"), glstring);
+        m_S3TCSupported = (std::string_view(glstring).find(u8"GL_EXT_texture_compression_s3tc") != std::string_view::npos);
     }
 
     // check GL versions: ES 2 and shading language 1
@@ -18,6 +18,8 @@ OpenGL ES 2.0 interface - primarily for the Raspberry Pi
 #include <EGL/egl.h>
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
+#include "gles2_texture.h"
+#include "gles2_tilemaprenderer.h"
 #include "../game/i_renderer.h"
 
 namespace ostrich {
@@ -39,7 +41,12 @@ public:
     int Initialize(ConsolePrinter conprinter) override;
     int Destroy() override;
 
-    void RenderScene(const SceneData *scenedata, int32_t extrapolation) override;
+    void RenderScene(const SceneData *scenedata, double alpha) override;
+
+    const GLES2TileMapRenderer::Stats &getTileMapStats() const noexcept { return m_TileMapRenderer.getStats(); }
+
+    // whether DXT textures can be uploaded compressed; GLES2Texture::CreateTexture() decodes them on the CPU otherwise
+    bool supportsS3TCCompression() const noexcept { return m_S3TCSupported; }
 
 private:
 
@@ -47,6 +54,10 @@ private:
 
     bool m_isActive;
     ConsolePrinter m_ConsolePrinter;
+
+    GLES2TileMapRenderer m_TileMapRenderer;
+    GLES2Texture m_WhiteTexture;    // there's no texture loading here yet, so every texture is drawn as plain white
+    bool m_S3TCSupported;
 };
 
 } // namespace ostrich
@@ -0,0 +1,106 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "gles2_shader.h"
+
+#include <iterator>
+#include <vector>
+#include "../common/filesystem.h"
+#include "../game/errorcodes.h"
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int ostrich::GLES2Shader::Load(ostrich::ConsolePrinter &consoleprinter, std::string_view vertexfile, std::string_view fragmentfile) {
+    this->Destroy();
+
+    std::string vertexsource, fragmentsource;
+    if (!ReadSource(vertexfile, vertexsource)) {
+        consoleprinter.WriteMessage(OST_FORMAT(u8"Unable to read shader %"), vertexfile);
+        return OST_ERROR_ES2SHADERLOAD;
+    }
+    if (!ReadSource(fragmentfile, fragmentsource)) {
+        consoleprinter.WriteMessage(OST_FORMAT(u8"Unable to read shader %"), fragmentfile);
+        return OST_ERROR_ES2SHADERLOAD;
+    }
+
+    GLuint vertex = Compile(consoleprinter, GL_VERTEX_SHADER, vertexfile, vertexsource);
+    GLuint fragment = Compile(consoleprinter, GL_FRAGMENT_SHADER, fragmentfile, fragmentsource);
+    if ((vertex == 0) || (fragment == 0)) {
+        ::glDeleteShader(vertex);
+        ::glDeleteShader(fragment);
+        return OST_ERROR_ES2SHADERCOMPILE;
+    }
+
+    GLuint program = ::glCreateProgram();
+    ::glAttachShader(program, vertex);
+    ::glAttachShader(program, fragment);
+    ::glLinkProgram(program);
+
+    // the program keeps what it needs; the shader objects go once it's linked
+    ::glDeleteShader(vertex);
+    ::glDeleteShader(fragment);
+
+    GLint linked = GL_FALSE;
+    ::glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) {
+        GLint loglength = 0;
+        ::glGetProgramiv(program, GL_INFO_LOG_LENGTH, &loglength);
+        std::vector<GLchar> log(static_cast<std::size_t>(loglength) + 1, 0);
+        ::glGetProgramInfoLog(program, static_cast<GLsizei>(log.size()), nullptr, log.data());
+        consoleprinter.WriteMessage(OST_FORMAT(u8"Unable to link % and %: %"), vertexfile, fragmentfile, log.data());
+        ::glDeleteProgram(program);
+        return OST_ERROR_ES2SHADERLINK;
+    }
+
+    m_Program = program;
+    return OST_ERROR_OK;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GLES2Shader::Destroy() {
+    if (m_Program != 0) {
+        ::glDeleteProgram(m_Program);
+        m_Program = 0;
+    }
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::GLES2Shader::ReadSource(std::string_view filename, std::string &source) {
+    ostrich::File file;
+    if (!file.Open(filename, ostrich::FileMode::OPEN_READONLY))
+        return false;
+
+    std::fstream &handle = file.getFStream();
+    source.assign(std::istreambuf_iterator<char>(handle), std::istreambuf_iterator<char>());
+    return !handle.bad();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+GLuint ostrich::GLES2Shader::Compile(ostrich::ConsolePrinter &consoleprinter,
+    GLenum type, std::string_view filename, const std::string &source) {
+    GLuint shader = ::glCreateShader(type);
+    const GLchar *text = source.c_str();
+    GLint length = static_cast<GLint>(source.size());
+    ::glShaderSource(shader, 1, &text, &length);
+    ::glCompileShader(shader);
+
+    GLint compiled = GL_FALSE;
+    ::glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled != GL_TRUE) {
+        GLint loglength = 0;
+        ::glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &loglength);
+        std::vector<GLchar> log(static_cast<std::size_t>(loglength) + 1, 0);
+        ::glGetShaderInfoLog(shader, static_cast<GLsizei>(log.size()), nullptr, log.data());
+        consoleprinter.WriteMessage(OST_FORMAT(u8"Unable to compile %: %"), filename, log.data());
+        ::glDeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
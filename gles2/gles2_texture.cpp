@@ -0,0 +1,151 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "gles2_texture.h"
+
+#include <cstring>
+#include <memory>
+#include <utility>
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::GLES2Texture::GLES2Texture(ostrich::GLES2Texture &&other) noexcept :
+    m_Texture(other.m_Texture), m_Width(other.m_Width), m_Height(other.m_Height), m_Decompressed(other.m_Decompressed) {
+    other.m_Texture = 0;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::GLES2Texture &ostrich::GLES2Texture::operator=(ostrich::GLES2Texture &&other) noexcept {
+    if (this != &other) {
+        this->Destroy();
+        m_Texture = other.m_Texture;
+        m_Width = other.m_Width;
+        m_Height = other.m_Height;
+        m_Decompressed = other.m_Decompressed;
+        other.m_Texture = 0;
+    }
+    return *this;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::GLES2Texture ostrich::GLES2Texture::CreateTexture(const ostrich::Image &image, bool s3tcsupported) {
+    ostrich::GLES2Texture texture;
+    if (!image.isValid())
+        return texture;
+
+    GLenum compressedformat = 0;
+    switch (image.getPixelFormat()) {
+        case ostrich::PixelFormat::FORMAT_DXT1:
+        {
+            compressedformat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+            break;
+        }
+        case ostrich::PixelFormat::FORMAT_DXT3:
+        {
+            compressedformat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+            break;
+        }
+        case ostrich::PixelFormat::FORMAT_DXT5:
+        {
+            compressedformat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    // decode before creating anything, so a bad image doesn't leave a texture behind
+    ostrich::Image decoded = image;
+    if (image.isCompressed() && !s3tcsupported) {
+        decoded = ostrich::Image::Decompress(image);
+        if (!decoded.isValid())
+            return texture;
+        texture.m_Decompressed = true;
+    }
+
+    ::glGenTextures(1, &texture.m_Texture);
+    if (texture.m_Texture == 0)
+        return texture;
+
+    // ES 2 only mipmaps power of two textures, and has no GL_TEXTURE_MAX_LEVEL, so the chain has to reach 1x1
+    int32_t width = decoded.getWidth(), height = decoded.getHeight();
+    bool poweroftwo = (((width & (width - 1)) == 0) && ((height & (height - 1)) == 0));
+    bool fullchain = (decoded.getMipCount() == ostrich::Image::FullMipCount(width, height));
+    int32_t levels = (poweroftwo && fullchain) ? decoded.getMipCount() : 1;
+
+    ::glBindTexture(GL_TEXTURE_2D, texture.m_Texture);
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (levels > 1) ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST);
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    bool uploaded = true;
+    auto data = decoded.getData().lock();
+    for (int32_t i = 0; uploaded && (i < levels); i++) {
+        if (decoded.isCompressed()) {
+            ostrich::Image::MipLevel level = decoded.getMipLevel(i);
+            ::glCompressedTexImage2D(GL_TEXTURE_2D, i, compressedformat, level.m_Width, level.m_Height, 0, level.m_Size, data.get() + level.m_Offset);
+        }
+        else {
+            uploaded = UploadPixels(decoded, i);
+        }
+    }
+    ::glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (!uploaded) {
+        texture.Destroy();
+        return texture;
+    }
+
+    texture.m_Width = image.getWidth();
+    texture.m_Height = image.getHeight();
+    return texture;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GLES2Texture::Destroy() {
+    if (m_Texture != 0) {
+        ::glDeleteTextures(1, &m_Texture);
+        m_Texture = 0;
+    }
+    m_Width = 0;
+    m_Height = 0;
+    m_Decompressed = false;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+bool ostrich::GLES2Texture::UploadPixels(const ostrich::Image &image, int32_t level) {
+    int32_t bytesperpixel = ostrich::Image::BytesPerPixel(image.getPixelFormat());
+    ostrich::Image::MipLevel mip = image.getMipLevel(level);
+    std::size_t size = static_cast<std::size_t>(mip.m_Width) * static_cast<std::size_t>(mip.m_Height) * static_cast<std::size_t>(bytesperpixel);
+    auto data = image.getData().lock();
+    if ((bytesperpixel == 0) || (size == 0) || (data == nullptr) || (static_cast<std::size_t>(image.getDataSize()) < (static_cast<std::size_t>(mip.m_Offset) + size)))
+        return false;
+
+    const uint8_t *pixels = data.get() + mip.m_Offset;
+    std::unique_ptr<uint8_t[]> swapped;
+    if ((image.getPixelFormat() == ostrich::PixelFormat::FORMAT_BGR) || (image.getPixelFormat() == ostrich::PixelFormat::FORMAT_BGRA)) {
+        swapped.reset(new uint8_t[size]);
+        std::memcpy(swapped.get(), pixels, size);
+        for (std::size_t i = 0; i < size; i += static_cast<std::size_t>(bytesperpixel)) {
+            std::swap(swapped[i], swapped[i + 2]);
+        }
+        pixels = swapped.get();
+    }
+
+    // rows are tightly packed, which an odd width of RGB breaks at the default alignment of 4
+    GLenum format = (bytesperpixel == 4) ? GL_RGBA : GL_RGB;
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    ::glTexImage2D(GL_TEXTURE_2D, level, static_cast<GLint>(format), mip.m_Width, mip.m_Height, 0, format, GL_UNSIGNED_BYTE, pixels);
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    return true;
+}
@@ -0,0 +1,105 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Texture for the OpenGL ES 2 renderer
+
+ES 2 is stricter than desktop GL about what it uploads: the internal format has to match the data's format, and
+BGR(A) isn't allowed, so BGR and BGRA images are swapped to RGB and RGBA on the way up.
+
+DXT images go up compressed where the GPU has GL_EXT_texture_compression_s3tc. The Raspberry Pi's doesn't, so there
+they're expanded to RGBA on the CPU first; that costs load time and 4-8 times the memory, but the same DDS files work
+on every renderer.
+
+A DDS mip chain is uploaded level by level when both sides are powers of two and it goes all the way to 1x1.
+ES 2 can't mipmap anything else, so those only get their first level.
+
+Staged: so far the ES 2 renderer only creates its white placeholder with this. Nothing can name a texture file to it
+yet (the game has no way to hand either renderer a tileset), so the DXT upload and its CPU decode fallback have no
+caller until the ES 2 renderer loads textures.
+==========================================
+*/
+
+#ifndef OSTRICH_GLES2_TEXTURE_H
+#define OSTRICH_GLES2_TEXTURE_H
+
+#include "../common/ost_common.h"
+
+#if (OST_RASPI != 1)
+#    error "This module should only be included in Raspberry Pi builds"
+#endif
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <cstdint>
+#include "../common/image.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+// Manage a texture loaded into GL
+// Currently just handles 2D textures, with the image's mipmaps where ES 2 allows them
+class GLES2Texture {
+public:
+
+    /////////////////////////////////////////////////
+    // Constructor creates an empty object; use CreateTexture() to make one with a texture
+    // Destructor deletes the texture, so it must run while the GL context is current
+    // Copy constructor/operator are deleted to prevent deleting the same texture twice
+    // Move constructor/operator hand the texture over, leaving the moved-from object empty
+    GLES2Texture() noexcept : m_Texture(0), m_Width(0), m_Height(0), m_Decompressed(false) {}
+    virtual ~GLES2Texture() { this->Destroy(); }
+    GLES2Texture(GLES2Texture &&other) noexcept;
+    GLES2Texture(const GLES2Texture &) = delete;
+    GLES2Texture &operator=(GLES2Texture &&other) noexcept;
+    GLES2Texture &operator=(const GLES2Texture &) = delete;
+
+    /////////////////////////////////////////////////
+    // Load image data into GL
+    //
+    // in:
+    //      image - constructed Image object with valid data
+    //      s3tcsupported - whether DXT images can be uploaded compressed (see EGLRenderer::supportsS3TCCompression())
+    // returns:
+    //      on success, a GLES2Texture with a valid GL texture ID
+    //      on failure, an empty object (reference glGetError())
+    static GLES2Texture CreateTexture(const Image &image, bool s3tcsupported);
+
+    /////////////////////////////////////////////////
+    // Delete the texture, leaving the object empty
+    //
+    // returns:
+    //      void
+    void Destroy();
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    bool isValid() const noexcept { return (m_Texture != 0); }
+    GLuint getTexObject() const noexcept { return m_Texture; }
+    int32_t getWidth() const noexcept { return m_Width; }
+    int32_t getHeight() const noexcept { return m_Height; }
+    bool isDecompressed() const noexcept { return m_Decompressed; }    // a DXT image that had to be expanded on the CPU
+
+private:
+
+    /////////////////////////////////////////////////
+    // Upload one level of uncompressed pixels to the bound texture, swapping BGR(A) to RGB(A) first
+    //
+    // in:
+    //      image - an uncompressed image
+    //      level - which of its mip levels
+    // returns:
+    //      true if the format could be uploaded
+    static bool UploadPixels(const Image &image, int32_t level);
+
+    GLuint m_Texture;
+    int32_t m_Width;
+    int32_t m_Height;
+    bool m_Decompressed;
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_GLES2_TEXTURE_H */
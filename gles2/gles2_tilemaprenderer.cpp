@@ -0,0 +1,166 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+==========================================
+*/
+
+#include "gles2_tilemaprenderer.h"
+
+#include <algorithm>
+#include "../common/trace.h"
+#include "../game/errorcodes.h"
+
+namespace {
+
+constexpr char g_TileMapVertexShader[] = u8"shaders/es2/tilemap.vert";
+constexpr char g_TileMapFragmentShader[] = u8"shaders/es2/tilemap.frag";
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+ostrich::GLES2TileMapRenderer::GLES2TileMapRenderer() noexcept :
+    m_PositionAttribute(-1), m_TilesLocation(-1), m_TilesetLocation(-1), m_ScreenSizeLocation(-1), m_OriginLocation(-1),
+    m_TileSizeLocation(-1), m_MapSizeLocation(-1), m_TilesetGridLocation(-1),
+    m_MapTexture(0), m_MaxTextureSize(0), m_LayoutRevision(0), m_Stats() {
+
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int ostrich::GLES2TileMapRenderer::Initialize(ostrich::ConsolePrinter consoleprinter) {
+    this->Destroy();
+    m_ConsolePrinter = consoleprinter;
+
+    int result = m_Shader.Load(m_ConsolePrinter, g_TileMapVertexShader, g_TileMapFragmentShader);
+    if (result != OST_ERROR_OK)
+        return result;
+    GLuint program = m_Shader.getProgram();
+    m_PositionAttribute = ::glGetAttribLocation(program, u8"aPos");
+    m_TilesLocation = ::glGetUniformLocation(program, u8"uTiles");
+    m_TilesetLocation = ::glGetUniformLocation(program, u8"uTileset");
+    m_ScreenSizeLocation = ::glGetUniformLocation(program, u8"uScreenSize");
+    m_OriginLocation = ::glGetUniformLocation(program, u8"uOrigin");
+    m_TileSizeLocation = ::glGetUniformLocation(program, u8"uTileSize");
+    m_MapSizeLocation = ::glGetUniformLocation(program, u8"uMapSize");
+    m_TilesetGridLocation = ::glGetUniformLocation(program, u8"uTilesetGrid");
+
+    ::glGenTextures(1, &m_MapTexture);
+    if (m_MapTexture == 0) {
+        m_Shader.Destroy();
+        return OST_ERROR_ES2TEXTURE;
+    }
+
+    // exact texels only, and clamped with no mipmaps so ES 2 accepts any size
+    ::glBindTexture(GL_TEXTURE_2D, m_MapTexture);
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    ::glBindTexture(GL_TEXTURE_2D, 0);
+    ::glGetIntegerv(GL_MAX_TEXTURE_SIZE, &m_MaxTextureSize);
+
+    m_LayoutRevision = 0;
+    m_RowRevisions.clear();
+    return OST_ERROR_OK;
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GLES2TileMapRenderer::Destroy() {
+    if (!this->isActive())
+        return;
+
+    if (m_MapTexture != 0) {
+        ::glDeleteTextures(1, &m_MapTexture);
+        m_MapTexture = 0;
+    }
+    m_Shader.Destroy();
+    m_LayoutRevision = 0;
+    m_RowRevisions.clear();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GLES2TileMapRenderer::Draw(const ostrich::TileMap &tilemap, GLuint tileset, int32_t screenwidth, int32_t screenheight) {
+    m_Stats = Stats();
+    if (!this->isActive() || tilemap.isEmpty() || (tilemap.getTileWidth() <= 0.0f) || (tilemap.getTileHeight() <= 0.0f))
+        return;
+
+    if ((tilemap.getColumns() > m_MaxTextureSize) || (tilemap.getRows() > m_MaxTextureSize)) {
+        if (tilemap.getLayoutRevision() != m_LayoutRevision) {
+            OST_LOG_WARNING(m_ConsolePrinter, ostrich::LogCategory::LOG_RENDERER,
+                OST_FORMAT(u8"Tile map is % by %, but the largest texture is %"), tilemap.getColumns(), tilemap.getRows(), m_MaxTextureSize);
+        }
+        tilemap.FindChanges(m_LayoutRevision, m_RowRevisions, [](int32_t, int32_t) {});
+        return;
+    }
+
+    OST_TRACE_SCOPE("GLES2TileMapRenderer::Draw");
+    ::glActiveTexture(GL_TEXTURE1);
+    ::glBindTexture(GL_TEXTURE_2D, m_MapTexture);
+    this->Upload(tilemap);
+
+    // the part of the map that's on screen
+    float left = std::max(tilemap.getXPos(), 0.0f);
+    float top = std::max(tilemap.getYPos(), 0.0f);
+    float right = std::min(tilemap.getXPos() + (tilemap.getTileWidth() * static_cast<float>(tilemap.getColumns())),
+        static_cast<float>(screenwidth));
+    float bottom = std::min(tilemap.getYPos() + (tilemap.getTileHeight() * static_cast<float>(tilemap.getRows())),
+        static_cast<float>(screenheight));
+    if ((left < right) && (top < bottom)) {
+        const GLfloat quad[8] = { left, top, right, top, left, bottom, right, bottom };
+
+        ::glUseProgram(m_Shader.getProgram());
+        ::glUniform1i(m_TilesLocation, 1);
+        ::glUniform1i(m_TilesetLocation, 0);
+        ::glUniform2f(m_ScreenSizeLocation, static_cast<GLfloat>(screenwidth), static_cast<GLfloat>(screenheight));
+        ::glUniform2f(m_OriginLocation, tilemap.getXPos(), tilemap.getYPos());
+        ::glUniform2f(m_TileSizeLocation, tilemap.getTileWidth(), tilemap.getTileHeight());
+        ::glUniform2f(m_MapSizeLocation, static_cast<GLfloat>(tilemap.getColumns()), static_cast<GLfloat>(tilemap.getRows()));
+        ::glUniform2f(m_TilesetGridLocation, static_cast<GLfloat>(std::max(tilemap.getTilesetColumns(), 1)),
+            static_cast<GLfloat>(std::max(tilemap.getTilesetRows(), 1)));
+        ::glActiveTexture(GL_TEXTURE0);
+        ::glBindTexture(GL_TEXTURE_2D, tileset);
+        ::glEnable(GL_BLEND);
+        ::glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        // four vertices aren't worth a buffer object; ES 2 still takes client-side arrays
+        ::glBindBuffer(GL_ARRAY_BUFFER, 0);
+        ::glEnableVertexAttribArray(static_cast<GLuint>(m_PositionAttribute));
+        ::glVertexAttribPointer(static_cast<GLuint>(m_PositionAttribute), 2, GL_FLOAT, GL_FALSE, 0, quad);
+        ::glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        ::glDisableVertexAttribArray(static_cast<GLuint>(m_PositionAttribute));
+        ::glUseProgram(0);
+        m_Stats.m_DrawCalls = 1;
+    }
+
+    ::glActiveTexture(GL_TEXTURE1);
+    ::glBindTexture(GL_TEXTURE_2D, 0);
+    ::glActiveTexture(GL_TEXTURE0);
+    ::glBindTexture(GL_TEXTURE_2D, 0);
+
+    OST_TRACE_COUNTER("Tile map rows uploaded", m_Stats.m_RowsUploaded);
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ostrich::GLES2TileMapRenderer::Upload(const ostrich::TileMap &tilemap) {
+    int32_t columns = tilemap.getColumns(), rows = tilemap.getRows();
+    const uint16_t *tiles = tilemap.getTiles();
+
+    // each tile is two bytes, low then high, which is exactly a luminance/alpha texel on a little-endian CPU like the Pi's
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    bool relayout = tilemap.FindChanges(m_LayoutRevision, m_RowRevisions, [&](int32_t first, int32_t count) {
+        ::glTexSubImage2D(GL_TEXTURE_2D, 0, 0, first, columns, count, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE,
+            tiles + (static_cast<std::size_t>(first) * static_cast<std::size_t>(columns)));
+        m_Stats.m_RowsUploaded += static_cast<uint32_t>(count);
+        m_Stats.m_Uploads++;
+    });
+    if (relayout) {
+        ::glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE_ALPHA, columns, rows, 0, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, tiles);
+        m_Stats.m_RowsUploaded = static_cast<uint32_t>(rows);
+        m_Stats.m_Uploads = 1;
+    }
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
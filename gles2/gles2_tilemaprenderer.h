@@ -0,0 +1,133 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Tile map renderer for the OpenGL ES 2 renderer
+
+ES 2 has no instancing, so the map goes the other way round from the OpenGL 4 renderer: it's drawn as one quad
+covering the part of the map that's on screen, and the fragment shader works out which tile each pixel is in,
+looks up the tile's index in a data texture, and samples that cell of the tileset. That's one draw call no matter
+how big the map is, and no per-tile vertex work at all, which suits the Pi's GPU.
+
+The data texture has one texel per tile: GL_LUMINANCE_ALPHA, with the low byte of the tileset index in luminance and
+the high byte in alpha. It isn't a power of two, which ES 2 allows as long as it's clamped and has no mipmaps.
+Changed rows are re-uploaded one run at a time (see TileMap for how changes are tracked).
+
+The Pi's textures top out at 2048 a side, so bigger maps aren't drawn (they'd need splitting into several textures).
+The tileset shouldn't be mipmapped: texture coordinates jump at every tile edge, which would pick the smallest mip there.
+==========================================
+*/
+
+#ifndef OSTRICH_GLES2_TILEMAPRENDERER_H
+#define OSTRICH_GLES2_TILEMAPRENDERER_H
+
+#include "../common/ost_common.h"
+
+#if (OST_RASPI != 1)
+#    error "This module should only be included in Raspberry Pi builds"
+#endif
+
+#include <GLES2/gl2.h>
+#include <cstdint>
+#include <vector>
+#include "gles2_shader.h"
+#include "../common/console.h"
+#include "../game/tilemap.h"
+
+namespace ostrich {
+
+/////////////////////////////////////////////////
+//
+class GLES2TileMapRenderer {
+public:
+
+    /////////////////////////////////////////////////
+    // Counters for the last Draw()
+    struct Stats {
+        uint32_t m_DrawCalls;
+        uint32_t m_RowsUploaded;
+        uint32_t m_Uploads;         // texture updates; one per run of changed rows
+    };
+
+    /////////////////////////////////////////////////
+    // Constructor creates an empty object; use Initialize() once there's a GL context
+    // Destructor does not release GL objects, as the GL context may already be gone; call Destroy()
+    // Copy/move constructors/operators are deleted to prevent deleting the same GL objects twice
+    GLES2TileMapRenderer() noexcept;
+    virtual ~GLES2TileMapRenderer() {}
+    GLES2TileMapRenderer(GLES2TileMapRenderer &&) = delete;
+    GLES2TileMapRenderer(const GLES2TileMapRenderer &) = delete;
+    GLES2TileMapRenderer &operator=(GLES2TileMapRenderer &&) = delete;
+    GLES2TileMapRenderer &operator=(const GLES2TileMapRenderer &) = delete;
+
+    /////////////////////////////////////////////////
+    // Build the tile map shader and create the map texture
+    //
+    // in:
+    //      consoleprinter - an initialized ConsolePrinter for logging
+    // returns:
+    //      An error code (OST_ERROR_OK (0) is the only successful code)
+    int Initialize(ConsolePrinter consoleprinter);
+
+    /////////////////////////////////////////////////
+    // Release the shader and map texture
+    //
+    // returns:
+    //      void
+    void Destroy();
+
+    /////////////////////////////////////////////////
+    // Bring the GPU copy of the map up to date and draw it
+    //
+    // in:
+    //      tilemap - the map; nothing is drawn if it's empty
+    //      tileset - the GL texture for tilemap.getTileset()
+    //      screenwidth, screenheight - the viewport size, which the map's placement is relative to
+    // returns:
+    //      void
+    void Draw(const TileMap &tilemap, GLuint tileset, int32_t screenwidth, int32_t screenheight);
+
+    /////////////////////////////////////////////////
+    // accessor methods
+    /////////////////////////////////////////////////
+
+    bool isActive() const noexcept { return m_Shader.isValid(); }
+    const Stats &getStats() const noexcept { return m_Stats; }
+
+private:
+
+    /////////////////////////////////////////////////
+    // Re-upload the whole map if its layout changed, otherwise each run of rows that changed since the last upload
+    // Expects the map texture to be bound
+    //
+    // in:
+    //      tilemap - the map
+    // returns:
+    //      void
+    void Upload(const TileMap &tilemap);
+
+    ConsolePrinter m_ConsolePrinter;
+
+    GLES2Shader m_Shader;
+    GLint m_PositionAttribute;
+    GLint m_TilesLocation;
+    GLint m_TilesetLocation;
+    GLint m_ScreenSizeLocation;
+    GLint m_OriginLocation;
+    GLint m_TileSizeLocation;
+    GLint m_MapSizeLocation;
+    GLint m_TilesetGridLocation;
+
+    GLuint m_MapTexture;
+    GLint m_MaxTextureSize;     // maps with more rows or columns than this aren't drawn
+
+    // what the map texture holds
+    uint32_t m_LayoutRevision;
+    std::vector<uint32_t> m_RowRevisions;
+
+    Stats m_Stats;
+};
+
+} // namespace ostrich
+
+#endif /* OSTRICH_GLES2_TILEMAPRENDERER_H */
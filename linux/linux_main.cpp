@@ -12,6 +12,9 @@ Entry point for Linux using X11
 #   error "This module should only be included in Linux builds"
 #endif
 
+#include <cstdlib>
+#include <string_view>
+
 #include "x11_gl4display.h"
 #include "x11_input.h"
 #include "../common/error.h"
@@ -36,15 +39,54 @@ ostrich::IInput*        InputPtr = &Input;
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 int main(int argc, char *argv[]) {
-    OST_UNUSED_PARAMETER(argc);
-    OST_UNUSED_PARAMETER(argv);
-
     int returncode = 0;
 
+    // --replay <journal> runs headless against a recorded event journal; --realtime paces it at the normal update rate
+    // --trace <file> records a timeline trace (Chrome trace-event JSON)
+    // --profile/--noprofile turn the frame profiler on or off (on by default in debug builds)
+    // --fps <rate> paces frames to that rate (default: the update rate); --fps 0 runs unpaced
+    // --threaded runs the simulation on its own thread
+    const char *replayfile = nullptr;
+    const char *tracefile = nullptr;
+    bool realtime = false;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg(argv[i]);
+        if ((arg == u8"--replay") && ((i + 1) < argc)) {
+            replayfile = argv[++i];
+        }
+        else if (arg == u8"--realtime") {
+            realtime = true;
+        }
+        else if ((arg == u8"--trace") && ((i + 1) < argc)) {
+            tracefile = argv[++i];
+        }
+        else if (arg == u8"--profile") {
+            Game.EnableProfiling(true);
+        }
+        else if (arg == u8"--noprofile") {
+            Game.EnableProfiling(false);
+        }
+        else if ((arg == u8"--fps") && ((i + 1) < argc)) {
+            Game.setTargetFrameRate(std::atof(argv[++i]));
+        }
+        else if (arg == u8"--threaded") {
+            Game.setThreadedMode(true);
+        }
+    }
+
     //InitMemoryTracker();
 
+    if (tracefile != nullptr) {
+        Game.EnableTracing(tracefile);
+    }
+
     try {
-        returncode = Game.Start(DisplayPtr, RendererPtr, InputPtr);
+        if (replayfile != nullptr) {
+            returncode = Game.Replay(replayfile, realtime);
+        }
+        else {
+            returncode = Game.Start(DisplayPtr, RendererPtr, InputPtr);
+        }
     }
     catch (...) {
         returncode = -500000;
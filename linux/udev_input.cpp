@@ -167,7 +167,7 @@ int ostrich::InputUDev::Initialize(ostrich::ConsolePrinter consoleprinter, ostri
     if (result != OST_ERROR_OK)
         throw ostrich::InitException(OST_FUNCTION_SIGNATURE, result);
 
-    m_ConsolePrinter.DebugMessage(u8"Added % devices", { std::to_string(m_Devices.size()) });
+    OST_LOG_DEBUG(m_ConsolePrinter, ostrich::LogCategory::LOG_INPUT, OST_FORMAT(u8"Added % devices"), m_Devices.size());
 
     m_isActive = true;
     return OST_ERROR_OK;
@@ -209,19 +209,19 @@ void ostrich::InputUDev::ProcessKBM() {
             }
             else {
                 int count = bytesread / sizeof(input[0]);
-                m_ConsolePrinter.DebugMessage(u8"Read % bytes, making % events",
-                    { std::to_string(bytesread), std::to_string(count)});
+                OST_LOG_TRACE(m_ConsolePrinter, ostrich::LogCategory::LOG_INPUT,
+                    OST_FORMAT(u8"Read % bytes, making % events"), bytesread, count);
                 for (int i = 0; i < count; i++) {
                     if (input[i].type == EV_KEY) { // keyboard or mouse buttons
-                        m_ConsolePrinter.DebugMessage(u8"EV_KEY: code \"%\" value \"%\"",
-                            { std::to_string(input[i].code), std::to_string(input[i].value) });
+                        OST_LOG_TRACE(m_ConsolePrinter, ostrich::LogCategory::LOG_INPUT,
+                            OST_FORMAT(u8"EV_KEY: code \"%\" value \"%\""), input[i].code, input[i].value);
                         int32_t key = ostrich::linux::TranslateKey(input[i].code);
                         bool keystate = (input[i].value == 1) ? true : false;
                         m_EventSender.Send(ostrich::Message::CreateKeyMessage(key, keystate, OST_FUNCTION_SIGNATURE));
                     }
                     else if (input[i].type == EV_REL) { // mouse moved
-                        m_ConsolePrinter.DebugMessage(u8"EV_REL: code \"%\" value \"%\"",
-                            { std::to_string(input[i].code), std::to_string(input[i].value) });
+                        OST_LOG_TRACE(m_ConsolePrinter, ostrich::LogCategory::LOG_INPUT,
+                            OST_FORMAT(u8"EV_REL: code \"%\" value \"%\""), input[i].code, input[i].value);
                     }
                 }
             }
@@ -282,7 +282,7 @@ int ostrich::InputUDev::ScanDevices() {
         ::udev_enumerate_add_match_subsystem(enumerate, "input");
         ::udev_enumerate_scan_devices(enumerate);
 
-        m_ConsolePrinter.DebugMessage(u8"Enumerating devices");
+        OST_LOG_DEBUG(m_ConsolePrinter, ostrich::LogCategory::LOG_INPUT, u8"Enumerating devices");
         udev_list_entry *entrylist = ::udev_enumerate_get_list_entry(enumerate);
         udev_list_entry *entry = nullptr;
         for (entry = entrylist;
@@ -167,9 +167,9 @@ int ostrich::DisplayGL4X11::InitWindow() {
     XSetWindowAttributes xwinattribs = {};
     xwinattribs.colormap = m_Colormap;
     xwinattribs.border_pixel = 0;
-    xwinattribs.event_mask = VisibilityChangeMask |                 // Window masks
-                             KeyPressMask | KeyReleaseMask |        // Keyboard masks
-                             ButtonPressMask | ButtonReleaseMask |  // Mouse masks
+    xwinattribs.event_mask = VisibilityChangeMask | FocusChangeMask |   // Window masks
+                             KeyPressMask | KeyReleaseMask |            // Keyboard masks
+                             ButtonPressMask | ButtonReleaseMask |      // Mouse masks
                              ButtonMotionMask | PointerMotionMask;
 
     m_GLWindow = ::XCreateWindow(m_Display, rootwindow, 0, 0, ostrich::g_ScreenWidth, ostrich::g_ScreenHeight,
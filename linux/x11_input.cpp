@@ -280,7 +280,7 @@ void ostrich::InputX11::ProcessKBM() {
                 sym = ostrich::x11::GetVKey(&event.xkey);
                 vkey = ostrich::x11::TranslateKey(sym);
                 if (vkey == 0) {
-                    m_ConsolePrinter.DebugMessage(u8"Unknown vkey >%<", { std::to_string(sym) });
+                    OST_LOG_DEBUG(m_ConsolePrinter, ostrich::LogCategory::LOG_INPUT, OST_FORMAT(u8"Unknown vkey >%<"), sym);
                 }
                 else {
                     m_EventSender.Send(ostrich::Message::CreateKeyMessage(vkey, true, OST_FUNCTION_SIGNATURE));
@@ -292,7 +292,7 @@ void ostrich::InputX11::ProcessKBM() {
                 sym = ostrich::x11::GetVKey(&event.xkey);
                 vkey = ostrich::x11::TranslateKey(sym);
                 if (vkey == 0) {
-                    m_ConsolePrinter.DebugMessage(u8"Unknown vkey >%<", { std::to_string(sym) });
+                    OST_LOG_DEBUG(m_ConsolePrinter, ostrich::LogCategory::LOG_INPUT, OST_FORMAT(u8"Unknown vkey >%<"), sym);
                 }
                 else {
                     m_EventSender.Send(ostrich::Message::CreateKeyMessage(vkey, false, OST_FUNCTION_SIGNATURE));
@@ -328,9 +328,15 @@ void ostrich::InputX11::ProcessKBM() {
             {
                 break;
             }
+            case FocusOut:
+            {
+                // keys held down now will release in another window, so nothing here will see them come up
+                m_EventSender.Send(ostrich::Message::CreateSystemMessage(OST_SYSTEMMSG_FOCUSLOST, 0, OST_FUNCTION_SIGNATURE));
+                break;
+            }
             default:
             {
-                m_ConsolePrinter.DebugMessage(u8"Unhandled event of type %", { std::to_string(event.type) });
+                OST_LOG_TRACE(m_ConsolePrinter, ostrich::LogCategory::LOG_INPUT, OST_FORMAT(u8"Unhandled event of type %"), event.type);
                 break;
             }
         }
@@ -0,0 +1,37 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+Minesweeper components
+
+Plain data attached to entities in the state machine's EntityRegistry (see entityregistry.h)
+==========================================
+*/
+
+#ifndef MS_COMPONENTS_H_
+#define MS_COMPONENTS_H_
+
+#include <cstdint>
+
+namespace ms {
+
+/////////////////////////////////////////////////
+//
+enum class TileState : int32_t {
+    STATE_UNREVEALED,   // state is unknown to player
+    STATE_REVEALED,     // state is known to the player
+    STATE_FLAGGED       // player planted a flag on the tile
+};
+
+/////////////////////////////////////////////////
+// One square of the board
+struct Tile {
+    TileState m_State;
+    bool m_isAMine;
+    int32_t m_Column;
+    int32_t m_Row;
+};
+
+} // namespace ms
+
+#endif /* MS_COMPONENTS_H_ */
@@ -20,8 +20,9 @@ int ms::StateMachine::Initialize(ostrich::ConsolePrinter consoleprinter, ostrich
         throw ostrich::ProxyException(OST_FUNCTION_SIGNATURE);
 
     // any initialization of game-specific state should go here
+    this->CreateBoard();
 
-    m_ConsolePrinter.WriteMessage(u8"% version %", { ms::g_GameName, ms::version::g_Version });
+    m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"% version %"), ms::g_GameName, ms::version::g_Version);
 
     m_isActive = true;
     return 0;
@@ -30,6 +31,8 @@ int ms::StateMachine::Initialize(ostrich::ConsolePrinter consoleprinter, ostrich
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
 void ms::StateMachine::Destroy() {
+    m_Board.clear();
+    m_Entities.Clear();
     m_isActive = false;
 }
 
@@ -62,8 +65,8 @@ void ms::StateMachine::ProcessInput(const ostrich::Message &msg) {
         m_InputStates.m_YPos = posdata.second;
     }
     else {
-        m_ConsolePrinter.WriteMessage(u8"Unknown input type passed to StateMachine: %",
-            { std::to_string(msg.getTypeAsInt()) });
+        m_ConsolePrinter.WriteMessage(OST_FORMAT(u8"Unknown input type passed to StateMachine: %"),
+            msg.getTypeAsInt());
         return;
     }
 
@@ -97,4 +100,41 @@ void ms::StateMachine::UpdateGameState() {
 /////////////////////////////////////////////////
 const ostrich::SceneData *ms::StateMachine::GetSceneData() const noexcept {
     return &m_SceneData;
-}
\ No newline at end of file
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ms::StateMachine::CreateBoard() {
+    m_Entities.Clear();
+    m_Board.clear();
+    m_Board.reserve(BOARD_SIZE * BOARD_SIZE);
+
+    // centered on the screen
+    float left = (static_cast<float>(ostrich::g_ScreenWidth) - (BOARD_SIZE * TILE_PIXELS)) / 2.0f;
+    float top = (static_cast<float>(ostrich::g_ScreenHeight) - (BOARD_SIZE * TILE_PIXELS)) / 2.0f;
+
+    // the board is drawn as a tile map rather than a sprite per square; the tileset has a cell per TileState
+    ostrich::TileMap &tilemap = m_SceneData.getTileMap();
+    tilemap.Resize(BOARD_SIZE, BOARD_SIZE);
+    tilemap.setPlacement(left, top, TILE_PIXELS, TILE_PIXELS);
+    tilemap.setTileset(0, TILESET_COLUMNS, 1);
+
+    for (int32_t row = 0; row < BOARD_SIZE; row++) {
+        for (int32_t column = 0; column < BOARD_SIZE; column++) {
+            ostrich::EntityHandle tile = m_Entities.Create();
+            m_Entities.AddComponent(tile, ms::Tile{ ms::TileState::STATE_UNREVEALED, false, column, row });
+            m_Board.push_back(tile);
+        }
+    }
+    this->BuildScene();
+}
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+void ms::StateMachine::BuildScene() {
+    // only tiles whose state changed mark their row for re-upload
+    ostrich::TileMap &tilemap = m_SceneData.getTileMap();
+    m_Entities.Each<ms::Tile>([&tilemap](ostrich::EntityHandle, const ms::Tile &tile) {
+        tilemap.setTile(tile.m_Column, tile.m_Row, static_cast<uint16_t>(tile.m_State));
+    });
+}
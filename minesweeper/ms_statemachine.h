@@ -13,11 +13,12 @@ Check docs for more details
 #define MS_STATEMACHINE_H_
 
 #include <cstring>
-#include <list>
 #include <memory>
 #include <vector>
+#include "ms_components.h"
 #include "../common/console.h"
 #include "../common/ost_common.h"
+#include "../game/entityregistry.h"
 #include "../game/eventqueue.h"
 #include "../game/scenedata.h"
 
@@ -49,7 +50,7 @@ public:
     void UpdateGameState();
 
     // returns a pointer to scene data for the renderer
-    // this should be a curated list taken from the master list of entities
+    // the render list and board tile map are built from the entity registry by BuildScene()
     const ostrich::SceneData *GetSceneData() const noexcept;
 
 private:
@@ -73,6 +74,20 @@ private:
         int32_t m_YPos;
     };
 
+    /////////////////////////////////////////////////
+    // Create an entity for each square of the board, and the tile map that draws them
+    //
+    // returns:
+    //      void
+    void CreateBoard();
+
+    /////////////////////////////////////////////////
+    // Update the board's tile map from every Tile; the board is drawn entirely by the tile map
+    //
+    // returns:
+    //      void
+    void BuildScene();
+
     const char *const m_Classname = u8"ms::StateMachine";
 
     bool m_isActive;
@@ -84,26 +99,19 @@ private:
 
     ostrich::SceneData m_SceneData;
 
-    std::list<ostrich::IEntity> m_MasterEntityList;
+    ostrich::EntityRegistry m_Entities;
 
     /////////////////////////////////////////////////
     // all of the above state could be considered generic stuff for any game
     // the below is specific to Minesweeper
     /////////////////////////////////////////////////
 
-    enum class TileState : int32_t {
-        STATE_UNREVEALED,   // state is unknown to player
-        STATE_REVEALED,     // state is known to the player
-        STATE_FLAGGED       // player planted a flag on the tile
-    };
-
-    struct Tile {
-        TileState m_State;
-        bool m_isAMine;
-    };
+    static constexpr int32_t BOARD_SIZE = 16;      // squares along each side
+    static constexpr float TILE_PIXELS = 32.0f;
+    static constexpr int32_t TILESET_COLUMNS = 3;  // one cell per TileState, in enum order
 
-    // board represented by a single-dimension vector of power-of-two size
-    std::vector<ostrich::IEntity> m_Board;
+    // board represented by a single-dimension vector of power-of-two size; one tile entity per square
+    std::vector<ostrich::EntityHandle> m_Board;
 };
 
 } // namespace ms
@@ -0,0 +1,26 @@
+// mediump can't address a tile much past 1000 with any fraction left over, so ask for highp where there is one
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+
+uniform sampler2D uTiles;       // one texel per tile: the tileset index, low byte in luminance and high byte in alpha
+uniform sampler2D uTileset;
+uniform vec2 uMapSize;          // tiles across and down
+uniform vec2 uTilesetGrid;      // cells across and down the tileset
+
+varying vec2 vMapPos;
+
+void main() {
+	vec2 tile = floor(vMapPos);
+	vec4 texel = texture2D(uTiles, (tile + 0.5) / uMapSize);
+	float index = floor((texel.r * 255.0) + 0.5) + (floor((texel.a * 255.0) + 0.5) * 256.0);
+	if (index > 65534.5) {
+		discard;    // empty tile
+	}
+
+	float row = floor((index + 0.5) / uTilesetGrid.x);
+	vec2 cell = vec2(index - (row * uTilesetGrid.x), row);
+	gl_FragColor = texture2D(uTileset, (cell + fract(vMapPos)) / uTilesetGrid);
+}
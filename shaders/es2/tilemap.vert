@@ -0,0 +1,14 @@
+// tile map: one quad covering the part of the map that's on screen, in screen pixels (top left origin)
+attribute vec2 aPos;
+
+uniform vec2 uScreenSize;
+uniform vec2 uOrigin;       // top left corner of the map, in screen pixels
+uniform vec2 uTileSize;     // in screen pixels
+
+varying vec2 vMapPos;       // position on the map, in tiles
+
+void main() {
+	vec2 ndc = ((aPos / uScreenSize) * 2.0) - 1.0;
+	gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+	vMapPos = (aPos - uOrigin) / uTileSize;
+}
@@ -0,0 +1,11 @@
+#version 400 core
+
+in vec2 vTexCoord;
+
+uniform sampler2D uTexture;
+
+out vec4 fragColor;
+
+void main() {
+	fragColor = texture(uTexture, vTexCoord);
+}
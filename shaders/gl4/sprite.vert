@@ -0,0 +1,15 @@
+#version 400 core
+
+// sprite batcher vertices: position in screen pixels (top left origin) and texture coordinates
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoord;
+
+uniform vec2 uScreenSize;
+
+out vec2 vTexCoord;
+
+void main() {
+	vec2 ndc = ((aPos / uScreenSize) * 2.0) - 1.0;
+	gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+	vTexCoord = aTexCoord;
+}
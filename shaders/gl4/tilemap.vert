@@ -0,0 +1,33 @@
+#version 400 core
+
+// tile map: one instance per visible tile, drawn as a 4 vertex triangle strip
+// the instances cover the visible block of the map, row by row; each one looks its tileset index up in the map texture
+uniform usampler2D uTiles;  // one texel per tile, the tileset index
+uniform vec2 uScreenSize;
+uniform vec2 uOrigin;       // top left corner of the map, in screen pixels
+uniform vec2 uTileSize;     // in screen pixels
+uniform vec2 uTilesetGrid;  // cells across and down the tileset
+uniform ivec2 uFirstTile;   // column and row of instance 0
+uniform int uVisibleColumns;
+
+out vec2 vTexCoord;
+
+void main() {
+	ivec2 tile = uFirstTile + ivec2(gl_InstanceID % uVisibleColumns, gl_InstanceID / uVisibleColumns);
+	uint index = texelFetch(uTiles, tile, 0).r;
+	if (index == 0xFFFFu) {
+		// empty tile: every vertex in the same place, so nothing is rasterized
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		vTexCoord = vec2(0.0);
+		return;
+	}
+
+	vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+	vec2 pos = uOrigin + ((vec2(tile) + corner) * uTileSize);
+	vec2 ndc = ((pos / uScreenSize) * 2.0) - 1.0;
+	gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+
+	uint setcolumns = uint(uTilesetGrid.x);
+	vec2 cell = vec2(index % setcolumns, index / setcolumns);
+	vTexCoord = (cell + corner) / uTilesetGrid;
+}
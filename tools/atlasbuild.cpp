@@ -0,0 +1,81 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+atlasbuild - pack small images into texture atlas pages ahead of time
+
+Usage: atlasbuild [-size pagesize] [-padding pixels] <manifest> <image>...
+    pagesize defaults to 1024 and padding to 2
+    images may be TGA or uncompressed DDS; each region is named after its file, without directory or extension
+    writes the manifest and <manifest name>_<page>.tga beside it; load it in game with TextureAtlas::Load()
+
+Standalone tool; not part of the game build. Build it with the image and atlas modules, e.g. on Linux:
+    g++ -std=c++17 tools/atlasbuild.cpp common/textureatlas.cpp common/skylinepacker.cpp common/image_dds.cpp
+        common/image_png.cpp common/image_raw.cpp common/image_s3tc.cpp common/image_tga.cpp common/filesystem.cpp -o atlasbuild
+==========================================
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../common/image.h"
+#include "../common/ost_common.h"
+#include "../common/textureatlas.h"
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int main(int argc, char *argv[]) {
+    int32_t pagesize = ostrich::TextureAtlas::DEFAULT_PAGE_SIZE;
+    int32_t padding = ostrich::TextureAtlas::DEFAULT_PADDING;
+    const char *manifest = nullptr;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; i++) {
+        if ((std::strcmp(argv[i], u8"-size") == 0) && ((i + 1) < argc)) {
+            pagesize = std::atoi(argv[++i]);
+        }
+        else if ((std::strcmp(argv[i], u8"-padding") == 0) && ((i + 1) < argc)) {
+            padding = std::atoi(argv[++i]);
+        }
+        else if (manifest == nullptr) {
+            manifest = argv[i];
+        }
+        else {
+            inputs.push_back(argv[i]);
+        }
+    }
+    if ((manifest == nullptr) || inputs.empty() || (pagesize <= 0)) {
+        std::cerr << u8"Usage: atlasbuild [-size pagesize] [-padding pixels] <manifest> <image>..." << ost_char::g_NewLine;
+        return 1;
+    }
+
+    ostrich::TextureAtlas atlas;
+    for (const auto &input : inputs) {
+        // the Image keeps a pointer to the name, and inputs doesn't change size from here on
+        std::filesystem::path path(input);
+        ostrich::Image image = ostrich::Image::LoadFile(input.c_str());
+        if (!image.isValid()) {
+            std::cerr << u8"Unable to load " << input << ost_char::g_NewLine;
+            return 1;
+        }
+        if (!atlas.Add(path.stem().string(), image)) {
+            std::cerr << u8"Unable to add " << input << u8" (compressed, an unsupported depth, or a duplicate name)" << ost_char::g_NewLine;
+            return 1;
+        }
+    }
+
+    if (!atlas.Build(pagesize, padding)) {
+        std::cerr << u8"An image plus " << padding << u8" pixels of padding doesn't fit on a " << pagesize << u8" page" << ost_char::g_NewLine;
+        return 1;
+    }
+    if (!atlas.Save(manifest)) {
+        std::cerr << u8"Unable to write " << manifest << ost_char::g_NewLine;
+        return 1;
+    }
+
+    std::cout << u8"atlasbuild: " << atlas.getRegionCount() << u8" images on " << atlas.getPageCount() << u8" "
+        << pagesize << u8"x" << pagesize << u8" pages, " << (atlas.getOccupancy() * 100.0) << u8"% occupied" << ost_char::g_NewLine;
+    return 0;
+}
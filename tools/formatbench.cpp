@@ -0,0 +1,120 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+formatbench - measure console message formatting against the string-list path it replaced
+
+Usage: formatbench [calls]
+    calls defaults to 2000000
+    formats the same messages with format::Format() into the thread-local buffer, and the old way: each argument
+    turned into a std::string, then an initializer_list of them compiled into a std::string by a copy of the old
+    ConsolePrinter::CompileBuffer(). Prints the best of several runs of each, in nanoseconds per call, for three
+    integer and string arguments and again with a floating point one added
+
+Standalone tool; not part of the game build. Build it with the formatter alone, e.g. on Linux:
+    g++ -std=c++17 -O2 tools/formatbench.cpp common/format.cpp -o formatbench
+==========================================
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include "../common/format.h"
+#include "../common/ost_common.h"
+
+namespace {
+
+constexpr int g_Repeats = 5; // best of, to keep scheduler noise out of the numbers
+
+volatile std::size_t g_Sink; // formatted lengths go here, so the work can't be optimized away
+
+/////////////////////////////////////////////////
+// ConsolePrinter::CompileBuffer() as it was before the formatter
+void CompileBuffer(std::string &target, std::string_view msg, std::initializer_list<std::string> args) {
+    std::string buffer;
+    auto listitr = args.begin();
+    auto msgitr = msg.begin();
+    while (msgitr != msg.end()) {
+        if ((*msgitr) == '%') {
+            if (std::next(msgitr) != msg.end() && ((*std::next(msgitr)) == '%')) {
+                buffer.push_back('%');
+                std::advance(msgitr, 1);
+            }
+            else if (listitr == args.end()) { // if more % than args, append %
+                buffer.push_back('%');
+            }
+            else {
+                buffer += *listitr;
+                std::advance(listitr, 1);
+            }
+        }
+        else {
+            buffer.push_back((*msgitr));
+        }
+        if (msgitr != msg.end())
+            std::advance(msgitr, 1);
+    }
+
+    target.assign(buffer);
+}
+
+/////////////////////////////////////////////////
+// Time a formatting loop, best of g_Repeats runs
+//
+// in:
+//      calls - iterations per run
+//      body - formats one message for iteration i and returns its length
+// returns:
+//      nanoseconds per call
+template <typename Body>
+double Best(int calls, Body body) {
+    double best = 0.0;
+    for (int repeat = 0; repeat < g_Repeats; repeat++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < calls; i++) {
+            g_Sink = g_Sink + body(i);
+        }
+        double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+        best = (repeat == 0) ? elapsed : std::min(best, elapsed);
+    }
+    return best;
+}
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int main(int argc, char *argv[]) {
+    int calls = (argc > 1) ? std::atoi(argv[1]) : 2000000;
+    int64_t count = 123456;
+    double elapsed = 3.25;
+    const char *sender = u8"ostrich::Main";
+
+    double oldints = Best(calls, [&](int i) {
+        std::string out;
+        CompileBuffer(out, u8"Update % coalesced % messages from %", { std::to_string(i), std::to_string(count), sender });
+        return out.size();
+    });
+    double newints = Best(calls, [&](int i) {
+        return ostrich::format::Format(OST_FORMAT(u8"Update % coalesced % messages from %"), i, count, sender).size();
+    });
+    double oldfloat = Best(calls, [&](int i) {
+        std::string out;
+        CompileBuffer(out, u8"Update % coalesced % messages from % at %",
+            { std::to_string(i), std::to_string(count), sender, std::to_string(elapsed) });
+        return out.size();
+    });
+    double newfloat = Best(calls, [&](int i) {
+        return ostrich::format::Format(OST_FORMAT(u8"Update % coalesced % messages from % at %"), i, count, sender, elapsed).size();
+    });
+
+    std::cout << u8"formatbench: " << calls << u8" calls" << ost_char::g_NewLine;
+    std::cout << u8"  integers and a string: old " << oldints << u8" ns, new " << newints << u8" ns" << ost_char::g_NewLine;
+    std::cout << u8"  plus a float:          old " << oldfloat << u8" ns, new " << newfloat << u8" ns" << ost_char::g_NewLine;
+    return 0;
+}
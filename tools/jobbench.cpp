@@ -0,0 +1,80 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+jobbench - measure how the job system scales from 1 to N cores
+
+Usage: jobbench [items] [batch size]
+    items defaults to 1048576, batch size to 1024
+    runs the same ParallelFor workload with 0 workers (main thread only) up to one worker per extra hardware thread,
+    and prints the time and speedup of each; the main thread helps, so N workers means N+1 threads
+
+Standalone tool; not part of the game build. Build it with the job system alone, e.g. on Linux:
+    g++ -std=c++17 -O2 -pthread -DOST_TRACE_DISABLED tools/jobbench.cpp common/jobsystem.cpp -o jobbench
+==========================================
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../common/jobsystem.h"
+#include "../common/ost_common.h"
+
+namespace {
+
+constexpr int g_Repeats = 5; // best of, to keep scheduler noise out of the numbers
+
+/////////////////////////////////////////////////
+// Some arithmetic per item, enough that the work outweighs the queueing
+float Work(std::size_t item) {
+    float value = static_cast<float>(item);
+    for (int i = 0; i < 64; i++) {
+        value = std::sqrt(value * value + 1.0f) * 0.999f;
+    }
+    return value;
+}
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int main(int argc, char *argv[]) {
+    std::size_t items = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1048576;
+    std::size_t batchsize = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 1024;
+    int32_t maxworkers = std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency()) - 1);
+
+    std::vector<float> results(items);
+    double baseline = 0.0;
+
+    std::cout << u8"jobbench: " << items << u8" items in batches of " << batchsize << ost_char::g_NewLine;
+    for (int32_t workers = 0; workers <= maxworkers; workers++) {
+        ostrich::JobSystem jobs;
+        if (workers > 0) {
+            jobs.Initialize(workers);
+        }
+
+        double best = 0.0;
+        for (int repeat = 0; repeat < g_Repeats; repeat++) {
+            auto start = std::chrono::steady_clock::now();
+            jobs.ParallelFor(items, batchsize, [&results](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                    results[i] = Work(i);
+                }
+            });
+            double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = (repeat == 0) ? elapsed : std::min(best, elapsed);
+        }
+
+        if (workers == 0) {
+            baseline = best;
+        }
+        std::cout << u8"  " << (workers + 1) << u8" threads: " << best << u8" ms, speedup " << (baseline / best)
+            << u8", " << jobs.getStolenCount() << u8" jobs stolen" << ost_char::g_NewLine;
+    }
+
+    return 0;
+}
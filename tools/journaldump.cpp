@@ -0,0 +1,76 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+journaldump - decode a binary event journal (message.jnl) back into the plain-text message.log format
+
+Usage: journaldump [journal file] [output file]
+    journal file defaults to message.jnl
+    output goes to stdout if no output file is given
+
+Standalone tool; not part of the game build. Build it with the handful of modules it uses, e.g. on Linux:
+    g++ -std=c++17 -pthread tools/journaldump.cpp game/eventjournal.cpp common/datetime.cpp
+        common/filesystem.cpp common/linux/linux_datetime.cpp -o journaldump
+==========================================
+*/
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "../common/datetime.h"
+#include "../common/filesystem.h"
+#include "../common/ost_common.h"
+#include "../game/eventjournal.h"
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int main(int argc, char *argv[]) {
+    const char *inputname = (argc > 1) ? argv[1] : u8"message.jnl";
+    const char *outputname = (argc > 2) ? argv[2] : nullptr;
+
+    ostrich::File input;
+    if (!input.Open(inputname, ostrich::FileMode::OPEN_READONLY)) {
+        std::cerr << u8"Unable to open " << inputname << ost_char::g_NewLine;
+        return 1;
+    }
+    std::fstream &inhandle = input.getFStream();
+
+    ostrich::journal::FileHeader header = { };
+    if (!ostrich::journal::ReadHeader(inhandle, header)) {
+        std::cerr << inputname << u8" is not a supported event journal" << ost_char::g_NewLine;
+        return 2;
+    }
+
+    ostrich::File output;
+    if (outputname != nullptr) {
+        if (!output.Open(outputname, ostrich::FileMode::OPEN_WRITETRUNCATE)) {
+            std::cerr << u8"Unable to open " << outputname << ost_char::g_NewLine;
+            return 1;
+        }
+    }
+    std::ostream &outhandle = (outputname != nullptr) ? static_cast<std::ostream &>(output.getFStream()) : std::cout;
+
+    ostrich::journal::Record record = { };
+    std::string line;
+    int64_t count = 0;
+    while (inhandle.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+        // the sender field is fixed width; make sure it's terminated even if the file is damaged
+        record.m_Sender[ostrich::journal::g_SenderLength - 1] = ost_char::g_Null;
+
+        std::chrono::system_clock::time_point walltime(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(header.m_AnchorTime + (record.m_Timestamp - header.m_AnchorTick))));
+
+        ostrich::journal::FormatEntry(line, ostrich::datetime::timestamp_ms(walltime),
+            record.m_Type, record.m_Data1, record.m_Data2, record.m_Sender);
+        outhandle.write(line.c_str(), line.length());
+        outhandle.put(ost_char::g_NewLine);
+        count++;
+    }
+
+    if (inhandle.gcount() != 0) {
+        std::cerr << u8"Ignoring truncated record at end of " << inputname << ost_char::g_NewLine;
+    }
+    std::cerr << u8"Decoded " << count << u8" records" << ost_char::g_NewLine;
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+messagebench - measure how many Messages can be created per second, now and before they became plain values
+
+Usage: messagebench [messages]
+    messages defaults to 2000000
+    creates key messages into a small buffer (as the event queue would copy them) with today's Message, and with a
+    copy of the old one: a virtual destructor and a std::string timestamp formatted on every construction.
+    Prints the best of several runs of each, in millions of messages per second, and the size of each
+
+Standalone tool; not part of the game build. Build it with the clock alone, e.g. on Linux:
+    g++ -std=c++17 -O2 tools/messagebench.cpp common/datetime.cpp common/linux/linux_datetime.cpp -o messagebench
+==========================================
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../common/datetime.h"
+#include "../common/ost_common.h"
+#include "../game/message.h"
+
+namespace {
+
+constexpr int g_Repeats = 5;                    // best of, to keep scheduler noise out of the numbers
+constexpr std::size_t g_BufferSize = 1024;      // messages are copied in here, so creating them can't be optimized away
+
+/////////////////////////////////////////////////
+// Message as it was before: the same fields, plus the data pointer, a virtual destructor and a string timestamp
+class OldMessage {
+public:
+
+    OldMessage() : m_Type(ostrich::Message::Type::NULLTYPE), m_Data1(0), m_Data2(0), m_DataPtr(nullptr), m_Sender(nullptr) {}
+    virtual ~OldMessage() {}
+    OldMessage(OldMessage &&) = default;
+    OldMessage(const OldMessage &) = default;
+    OldMessage &operator=(OldMessage &&) = default;
+    OldMessage &operator=(const OldMessage &) = default;
+
+    static OldMessage CreateKeyMessage(int32_t keycode, bool keydown, const char *sender)
+    { return OldMessage(ostrich::Message::Type::INPUT_KEY, keycode, (keydown ? 1 : 0), nullptr, sender); }
+
+private:
+
+    OldMessage(ostrich::Message::Type type, int32_t data1, int32_t data2, void *dataptr, const char *sender) :
+        m_Type(type), m_Data1(data1), m_Data2(data2), m_DataPtr(dataptr), m_Sender(sender), m_Timestamp(ostrich::datetime::timestamp_ms())
+    {}
+
+    ostrich::Message::Type m_Type;
+    int32_t m_Data1;
+    int32_t m_Data2;
+    void *m_DataPtr;
+
+    const char *m_Sender;
+    std::string m_Timestamp;
+};
+
+/////////////////////////////////////////////////
+// Create messages into a buffer, best of g_Repeats runs
+//
+// in:
+//      messages - how many to create per run
+// returns:
+//      millions of messages per second
+template <typename MessageType>
+double Best(std::size_t messages) {
+    std::vector<MessageType> buffer(g_BufferSize, MessageType::CreateKeyMessage(0, false, u8"messagebench"));
+    double best = 0.0;
+    for (int repeat = 0; repeat < g_Repeats; repeat++) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < messages; i++) {
+            buffer[i % g_BufferSize] = MessageType::CreateKeyMessage(static_cast<int32_t>(i & 0xFF), ((i & 1) != 0), u8"messagebench");
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = std::max(best, static_cast<double>(messages) / elapsed / 1.0e6);
+    }
+    return best;
+}
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int main(int argc, char *argv[]) {
+    std::size_t messages = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+
+    double before = Best<OldMessage>(messages);
+    double after = Best<ostrich::Message>(messages);
+
+    std::cout << u8"messagebench: " << messages << u8" messages" << ost_char::g_NewLine;
+    std::cout << u8"  before: " << before << u8" M/s, " << sizeof(OldMessage) << u8" bytes" << ost_char::g_NewLine;
+    std::cout << u8"  after:  " << after << u8" M/s, " << sizeof(ostrich::Message) << u8" bytes, "
+        << (after / before) << u8"x" << ost_char::g_NewLine;
+    return 0;
+}
@@ -0,0 +1,51 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+mipbake - build a texture's mip chain ahead of time, so the game doesn't generate one at every load
+
+Usage: mipbake <input image> <output.dds>
+    the input may be TGA or DDS; a DXT input is expanded to RGBA first, and any chain it already has is rebuilt
+    writes an uncompressed DDS with every level down to 1x1, each a 2x2 box filter of the one above
+
+Standalone tool; not part of the game build. Build it with the image modules, e.g. on Linux:
+    g++ -std=c++17 tools/mipbake.cpp common/image_dds.cpp common/image_png.cpp common/image_raw.cpp
+        common/image_s3tc.cpp common/image_tga.cpp common/filesystem.cpp -o mipbake
+==========================================
+*/
+
+#include <iostream>
+#include "../common/image.h"
+#include "../common/ost_common.h"
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        std::cerr << u8"Usage: mipbake <input image> <output.dds>" << ost_char::g_NewLine;
+        return 1;
+    }
+
+    ostrich::Image image = ostrich::Image::LoadFile(argv[1]);
+    if (!image.isValid()) {
+        std::cerr << u8"Unable to load " << argv[1] << ost_char::g_NewLine;
+        return 1;
+    }
+    if (image.isCompressed()) {
+        image = ostrich::Image::Decompress(image);
+    }
+
+    ostrich::Image mipmapped = ostrich::Image::GenerateMipmaps(image);
+    if (!mipmapped.isValid()) {
+        std::cerr << u8"Unable to build mipmaps for " << argv[1] << u8" (an unsupported format)" << ost_char::g_NewLine;
+        return 1;
+    }
+    if (!mipmapped.SaveDDS(argv[2])) {
+        std::cerr << u8"Unable to write " << argv[2] << ost_char::g_NewLine;
+        return 1;
+    }
+
+    std::cout << u8"mipbake: " << mipmapped.getWidth() << u8"x" << mipmapped.getHeight() << u8", " << mipmapped.getMipCount()
+        << u8" levels, " << mipmapped.getDataSize() << u8" bytes" << ost_char::g_NewLine;
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*
+==========================================
+Copyright (c) 2021 Ostrich Labs
+
+queuebench - measure event queue push/pop throughput with several producer threads
+
+Usage: queuebench [messages per producer]
+    messages defaults to 1000000
+    runs 1, 2, 4 and 8 producers pushing Messages while the main thread pops them, once through the lock-free
+    ring EventQueue stores its lanes in, and once through the old storage: a std::queue, behind the mutex it would
+    need to take more than one producer. A producer that finds the ring full yields and tries again, as a real
+    sender would have to. Prints the best of several runs of each, in millions of messages per second
+
+Standalone tool; not part of the game build. Build it with the clock alone, e.g. on Linux:
+    g++ -std=c++17 -O2 -pthread tools/queuebench.cpp common/datetime.cpp common/linux/linux_datetime.cpp -o queuebench
+==========================================
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "../common/ost_common.h"
+#include "../common/ringbuffer.h"
+#include "../game/eventqueue.h"
+#include "../game/message.h"
+
+namespace {
+
+constexpr int g_Repeats = 5; // best of, to keep scheduler noise out of the numbers
+constexpr int g_ProducerCounts[] = { 1, 2, 4, 8 };
+
+/////////////////////////////////////////////////
+// The storage EventQueue used before the ring: a std::queue, locked so more than one thread can push
+class LockedQueue {
+public:
+
+    bool Push(const ostrich::Message &msg) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Queue.push(msg);
+        return true;
+    }
+
+    std::optional<ostrich::Message> Pop() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Queue.empty())
+            return std::nullopt;
+        ostrich::Message msg = m_Queue.front();
+        m_Queue.pop();
+        return msg;
+    }
+
+private:
+
+    std::mutex m_Mutex;
+    std::queue<ostrich::Message> m_Queue;
+};
+
+/////////////////////////////////////////////////
+// The ring with the same interface; the normal lane's type and capacity
+class RingQueue {
+public:
+
+    bool Push(const ostrich::Message &msg) { return m_Ring.TryPush(msg); }
+    std::optional<ostrich::Message> Pop() { return m_Ring.TryPop(); }
+
+private:
+
+    ostrich::MPSCRingBuffer<ostrich::Message, ostrich::EventQueue::QUEUE_CAPACITY> m_Ring;
+};
+
+/////////////////////////////////////////////////
+// Push from several threads and pop everything on this one
+//
+// in:
+//      producers - number of pushing threads
+//      messages - pushed by each
+// returns:
+//      elapsed time in seconds
+template <typename Queue>
+double Run(int producers, std::size_t messages) {
+    Queue queue;
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producers; i++) {
+        threads.emplace_back([&queue, &start, messages, i]() {
+            ostrich::Message msg = ostrich::Message::CreateKeyMessage(i, true, u8"queuebench");
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (std::size_t sent = 0; sent < messages;) {
+                if (queue.Push(msg))
+                    sent++;
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    std::size_t total = static_cast<std::size_t>(producers) * messages;
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (std::size_t popped = 0; popped < total;) {
+        if (queue.Pop().has_value())
+            popped++;
+        else
+            std::this_thread::yield();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    return elapsed;
+}
+
+/////////////////////////////////////////////////
+// Best of g_Repeats runs, as millions of messages per second
+template <typename Queue>
+double Best(int producers, std::size_t messages) {
+    double best = 0.0;
+    for (int repeat = 0; repeat < g_Repeats; repeat++) {
+        best = std::max(best, (static_cast<double>(producers) * static_cast<double>(messages)) / Run<Queue>(producers, messages) / 1.0e6);
+    }
+    return best;
+}
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////
+/////////////////////////////////////////////////
+int main(int argc, char *argv[]) {
+    std::size_t messages = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    std::cout << u8"queuebench: " << messages << u8" messages per producer, " << std::thread::hardware_concurrency()
+        << u8" hardware threads" << ost_char::g_NewLine;
+    for (int producers : g_ProducerCounts) {
+        double locked = Best<LockedQueue>(producers, messages);
+        double ring = Best<RingQueue>(producers, messages);
+        std::cout << u8"  " << producers << u8" producers: std::queue + mutex " << locked << u8" M/s, ring " << ring
+            << u8" M/s, " << (ring / locked) << u8"x" << ost_char::g_NewLine;
+    }
+
+    return 0;
+}
@@ -281,6 +281,13 @@ LRESULT CALLBACK ostrich::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM
             l_EventSender.Send(ostrich::Message::CreateKeyMessage(vkey, false, OST_FUNCTION_SIGNATURE));
             break;
         }
+        case WM_KILLFOCUS:
+        {
+            // keys held down now will release in another window, so nothing here will see them come up
+            l_EventSender.Send(ostrich::Message::CreateSystemMessage(OST_SYSTEMMSG_FOCUSLOST,
+                0, OST_FUNCTION_SIGNATURE));
+            break;
+        }
         //case WM_DESTROY:
         case WM_CLOSE:
         {